@@ -37,6 +37,7 @@
 #include "driver_nrf24l01_basic.h"
 
 static nrf24l01_handle_t gs_handle;        /**< nrf24l01 handle */
+static nrf24l01_shadow_t gs_shadow;        /**< nrf24l01 register shadow */
 
 /**
  * @brief  nrf24l01 irq
@@ -66,16 +67,16 @@ uint8_t nrf24l01_interrupt_irq_handler(void)
  *            - 1 init failed
  * @note      none
  */
-uint8_t nrf24l01_basic_init(nrf24l01_type_t type, void (*callback)(uint8_t type, uint8_t num, uint8_t *buf, uint8_t len))
+uint8_t nrf24l01_basic_init(nrf24l01_type_t type, void (*callback)(void *user_data, uint8_t type, uint8_t num, uint8_t *buf, uint8_t len))
 {
     uint8_t res;
-    uint8_t reg;
     uint8_t addr0[5] = NRF24L01_BASIC_DEFAULT_RX_ADDR_0;
     uint8_t addr1[5] = NRF24L01_BASIC_DEFAULT_RX_ADDR_1;
     uint8_t addr2[5] = NRF24L01_BASIC_DEFAULT_RX_ADDR_2;
     uint8_t addr3[5] = NRF24L01_BASIC_DEFAULT_RX_ADDR_3;
     uint8_t addr4[5] = NRF24L01_BASIC_DEFAULT_RX_ADDR_4;
     uint8_t addr5[5] = NRF24L01_BASIC_DEFAULT_RX_ADDR_5;
+    nrf24l01_profile_t profile;
     
     /* link function */
     DRIVER_NRF24L01_LINK_INIT(&gs_handle, nrf24l01_handle_t);
@@ -83,10 +84,13 @@ uint8_t nrf24l01_basic_init(nrf24l01_type_t type, void (*callback)(uint8_t type,
     DRIVER_NRF24L01_LINK_SPI_DEINIT(&gs_handle, nrf24l01_interface_spi_deinit);
     DRIVER_NRF24L01_LINK_SPI_READ(&gs_handle, nrf24l01_interface_spi_read);
     DRIVER_NRF24L01_LINK_SPI_WRITE(&gs_handle, nrf24l01_interface_spi_write);
+    DRIVER_NRF24L01_LINK_SPI_TRANSFER(&gs_handle, nrf24l01_interface_spi_transfer);
     DRIVER_NRF24L01_LINK_GPIO_INIT(&gs_handle, nrf24l01_interface_gpio_init);
     DRIVER_NRF24L01_LINK_GPIO_DEINIT(&gs_handle, nrf24l01_interface_gpio_deinit);
     DRIVER_NRF24L01_LINK_GPIO_WRITE(&gs_handle, nrf24l01_interface_gpio_write);
     DRIVER_NRF24L01_LINK_DELAY_MS(&gs_handle, nrf24l01_interface_delay_ms);
+    DRIVER_NRF24L01_LINK_DELAY_US(&gs_handle, nrf24l01_interface_delay_us);
+    DRIVER_NRF24L01_LINK_TIMESTAMP_US(&gs_handle, nrf24l01_interface_timestamp_us);
     DRIVER_NRF24L01_LINK_DEBUG_PRINT(&gs_handle, nrf24l01_interface_debug_print);
     DRIVER_NRF24L01_LINK_RECEIVE_CALLBACK(&gs_handle, callback);
 
@@ -99,243 +103,88 @@ uint8_t nrf24l01_basic_init(nrf24l01_type_t type, void (*callback)(uint8_t type,
         return 1;
     }
     
-    /* set active false */
-    res = nrf24l01_set_active(&gs_handle, NRF24L01_BOOL_FALSE);
+    /* set register shadow */
+    res = nrf24l01_set_register_shadow(&gs_handle, (NRF24L01_BASIC_DEFAULT_REGISTER_SHADOW == NRF24L01_BOOL_TRUE) ? &gs_shadow : NULL);
     if (res != 0)
     {
-        nrf24l01_interface_debug_print("nrf24l01: set active failed.\n");
+        nrf24l01_interface_debug_print("nrf24l01: set register shadow failed.\n");
         (void)nrf24l01_deinit(&gs_handle);
         
         return 1;
     }
     
-    /* enable power up */
-    res = nrf24l01_set_config(&gs_handle, NRF24L01_CONFIG_PWR_UP, NRF24L01_BOOL_TRUE);
+    /* set rx drain */
+    res = nrf24l01_set_rx_drain(&gs_handle, NRF24L01_BASIC_DEFAULT_RX_DRAIN);
     if (res != 0)
     {
-        nrf24l01_interface_debug_print("nrf24l01: set config failed.\n");
+        nrf24l01_interface_debug_print("nrf24l01: set rx drain failed.\n");
         (void)nrf24l01_deinit(&gs_handle);
         
         return 1;
     }
     
-    /* set crco */
-    res = nrf24l01_set_config(&gs_handle, NRF24L01_CONFIG_CRCO, NRF24L01_BASIC_DEFAULT_CRCO);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set config failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set crc */
-    res = nrf24l01_set_config(&gs_handle, NRF24L01_CONFIG_EN_CRC, NRF24L01_BASIC_DEFAULT_ENABLE_CRC);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set config failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* enable max rt */
-    res = nrf24l01_set_config(&gs_handle, NRF24L01_CONFIG_MASK_MAX_RT, NRF24L01_BOOL_FALSE);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set config failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* enable tx ds */
-    res = nrf24l01_set_config(&gs_handle, NRF24L01_CONFIG_MASK_TX_DS, NRF24L01_BOOL_FALSE);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set config failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* enable rx dr */
-    res = nrf24l01_set_config(&gs_handle, NRF24L01_CONFIG_MASK_RX_DR, NRF24L01_BOOL_FALSE);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set config failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    if (type == NRF24L01_TYPE_TX)
-    {
-        /* set tx mode */
-        res = nrf24l01_set_mode(&gs_handle, NRF24L01_MODE_TX);
-        if (res != 0)
-        {
-            nrf24l01_interface_debug_print("nrf24l01: set mode failed.\n");
-            (void)nrf24l01_deinit(&gs_handle);
-            
-            return 1;
-        }
-    }
-    else
-    {
-        /* set rx mode */
-        res = nrf24l01_set_mode(&gs_handle, NRF24L01_MODE_RX);
-        if (res != 0)
-        {
-            nrf24l01_interface_debug_print("nrf24l01: set mode failed.\n");
-            (void)nrf24l01_deinit(&gs_handle);
-            
-            return 1;
-        }
-    }
-    
-    /* set pipe 0 auto acknowledgment */
-    res = nrf24l01_set_auto_acknowledgment(&gs_handle, NRF24L01_PIPE_0, NRF24L01_BASIC_DEFAULT_PIPE_0_AUTO_ACKNOWLEDGMENT);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set auto acknowledgment failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 1 auto acknowledgment */
-    res = nrf24l01_set_auto_acknowledgment(&gs_handle, NRF24L01_PIPE_1, NRF24L01_BASIC_DEFAULT_PIPE_1_AUTO_ACKNOWLEDGMENT);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set auto acknowledgment failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 2 auto acknowledgment */
-    res = nrf24l01_set_auto_acknowledgment(&gs_handle, NRF24L01_PIPE_2, NRF24L01_BASIC_DEFAULT_PIPE_2_AUTO_ACKNOWLEDGMENT);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set auto acknowledgment failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 3 auto acknowledgment */
-    res = nrf24l01_set_auto_acknowledgment(&gs_handle, NRF24L01_PIPE_3, NRF24L01_BASIC_DEFAULT_PIPE_3_AUTO_ACKNOWLEDGMENT);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set auto acknowledgment failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 4 auto acknowledgment */
-    res = nrf24l01_set_auto_acknowledgment(&gs_handle, NRF24L01_PIPE_4, NRF24L01_BASIC_DEFAULT_PIPE_4_AUTO_ACKNOWLEDGMENT);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set auto acknowledgment failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 5 auto acknowledgment */
-    res = nrf24l01_set_auto_acknowledgment(&gs_handle, NRF24L01_PIPE_5, NRF24L01_BASIC_DEFAULT_PIPE_5_AUTO_ACKNOWLEDGMENT);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set auto acknowledgment failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 0 rx */
-    res = nrf24l01_set_rx_pipe(&gs_handle, NRF24L01_PIPE_0, NRF24L01_BASIC_DEFAULT_RX_PIPE_0);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 1 rx */
-    res = nrf24l01_set_rx_pipe(&gs_handle, NRF24L01_PIPE_1, NRF24L01_BASIC_DEFAULT_RX_PIPE_1);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 2 rx */
-    res = nrf24l01_set_rx_pipe(&gs_handle, NRF24L01_PIPE_2, NRF24L01_BASIC_DEFAULT_RX_PIPE_2);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 3 rx */
-    res = nrf24l01_set_rx_pipe(&gs_handle, NRF24L01_PIPE_3, NRF24L01_BASIC_DEFAULT_RX_PIPE_3);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 4 rx */
-    res = nrf24l01_set_rx_pipe(&gs_handle, NRF24L01_PIPE_4, NRF24L01_BASIC_DEFAULT_RX_PIPE_4);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 5 rx */
-    res = nrf24l01_set_rx_pipe(&gs_handle, NRF24L01_PIPE_5, NRF24L01_BASIC_DEFAULT_RX_PIPE_5);
+    /* set active false */
+    res = nrf24l01_set_active(&gs_handle, NRF24L01_BOOL_FALSE);
     if (res != 0)
     {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe failed.\n");
+        nrf24l01_interface_debug_print("nrf24l01: set active failed.\n");
         (void)nrf24l01_deinit(&gs_handle);
         
         return 1;
     }
     
-    /* set address width */
-    res = nrf24l01_set_address_width(&gs_handle, NRF24L01_BASIC_DEFAULT_ADDRESS_WIDTH);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set address width failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
+    /* set the profile */
+    profile.mode = (type == NRF24L01_TYPE_TX) ? NRF24L01_MODE_TX : NRF24L01_MODE_RX;
+    profile.power_up = NRF24L01_BOOL_TRUE;
+    profile.crc = NRF24L01_BASIC_DEFAULT_ENABLE_CRC;
+    profile.crco = NRF24L01_BASIC_DEFAULT_CRCO;
+    profile.mask_rx_dr = NRF24L01_BOOL_FALSE;
+    profile.mask_tx_ds = NRF24L01_BOOL_FALSE;
+    profile.mask_max_rt = NRF24L01_BOOL_FALSE;
+    profile.auto_acknowledgment[0] = NRF24L01_BASIC_DEFAULT_PIPE_0_AUTO_ACKNOWLEDGMENT;
+    profile.auto_acknowledgment[1] = NRF24L01_BASIC_DEFAULT_PIPE_1_AUTO_ACKNOWLEDGMENT;
+    profile.auto_acknowledgment[2] = NRF24L01_BASIC_DEFAULT_PIPE_2_AUTO_ACKNOWLEDGMENT;
+    profile.auto_acknowledgment[3] = NRF24L01_BASIC_DEFAULT_PIPE_3_AUTO_ACKNOWLEDGMENT;
+    profile.auto_acknowledgment[4] = NRF24L01_BASIC_DEFAULT_PIPE_4_AUTO_ACKNOWLEDGMENT;
+    profile.auto_acknowledgment[5] = NRF24L01_BASIC_DEFAULT_PIPE_5_AUTO_ACKNOWLEDGMENT;
+    profile.rx_pipe[0] = NRF24L01_BASIC_DEFAULT_RX_PIPE_0;
+    profile.rx_pipe[1] = NRF24L01_BASIC_DEFAULT_RX_PIPE_1;
+    profile.rx_pipe[2] = NRF24L01_BASIC_DEFAULT_RX_PIPE_2;
+    profile.rx_pipe[3] = NRF24L01_BASIC_DEFAULT_RX_PIPE_3;
+    profile.rx_pipe[4] = NRF24L01_BASIC_DEFAULT_RX_PIPE_4;
+    profile.rx_pipe[5] = NRF24L01_BASIC_DEFAULT_RX_PIPE_5;
+    profile.address_width = NRF24L01_BASIC_DEFAULT_ADDRESS_WIDTH;
+    profile.retransmit_count = NRF24L01_BASIC_DEFAULT_RETRANSMIT_COUNT;
+    profile.channel_frequency = NRF24L01_BASIC_DEFAULT_CHANNEL_FREQUENCY;
+    profile.data_rate = NRF24L01_BASIC_DEFAULT_DATA_RATE;
+    profile.output_power = NRF24L01_BASIC_DEFAULT_OUTPUT_POWER;
+    profile.continuous_carrier_transmit = NRF24L01_BOOL_FALSE;
+    profile.force_pll_lock_signal = NRF24L01_BOOL_FALSE;
+    profile.payload_number[0] = NRF24L01_BASIC_DEFAULT_PIPE_0_PAYLOAD;
+    profile.payload_number[1] = NRF24L01_BASIC_DEFAULT_PIPE_1_PAYLOAD;
+    profile.payload_number[2] = NRF24L01_BASIC_DEFAULT_PIPE_2_PAYLOAD;
+    profile.payload_number[3] = NRF24L01_BASIC_DEFAULT_PIPE_3_PAYLOAD;
+    profile.payload_number[4] = NRF24L01_BASIC_DEFAULT_PIPE_4_PAYLOAD;
+    profile.payload_number[5] = NRF24L01_BASIC_DEFAULT_PIPE_5_PAYLOAD;
+    profile.pipe_dynamic_payload[0] = NRF24L01_BASIC_DEFAULT_PIPE_0_DYNAMIC_PAYLOAD;
+    profile.pipe_dynamic_payload[1] = NRF24L01_BASIC_DEFAULT_PIPE_1_DYNAMIC_PAYLOAD;
+    profile.pipe_dynamic_payload[2] = NRF24L01_BASIC_DEFAULT_PIPE_2_DYNAMIC_PAYLOAD;
+    profile.pipe_dynamic_payload[3] = NRF24L01_BASIC_DEFAULT_PIPE_3_DYNAMIC_PAYLOAD;
+    profile.pipe_dynamic_payload[4] = NRF24L01_BASIC_DEFAULT_PIPE_4_DYNAMIC_PAYLOAD;
+    profile.pipe_dynamic_payload[5] = NRF24L01_BASIC_DEFAULT_PIPE_5_DYNAMIC_PAYLOAD;
+    profile.dynamic_payload = NRF24L01_BASIC_DEFAULT_DYNAMIC_PAYLOAD;
+    profile.payload_with_ack = NRF24L01_BASIC_DEFAULT_PAYLOAD_WITH_ACK;
+    profile.tx_payload_with_no_ack = NRF24L01_BASIC_DEFAULT_TX_PAYLOAD_WITH_NO_ACK;
+    memcpy(profile.rx_pipe_0_address, addr0, 5);
+    memcpy(profile.rx_pipe_1_address, addr1, 5);
+    memcpy(profile.tx_address, addr0, 5);
+    profile.rx_pipe_address[0] = addr2[4];
+    profile.rx_pipe_address[1] = addr3[4];
+    profile.rx_pipe_address[2] = addr4[4];
+    profile.rx_pipe_address[3] = addr5[4];
     
     /* convert auto retransmit delay */
-    res = nrf24l01_auto_retransmit_delay_convert_to_register(&gs_handle, NRF24L01_BASIC_DEFAULT_RETRANSMIT_DELAY, (uint8_t *)&reg);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: auto retransmit delay failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set auto retransmit delay */
-    res = nrf24l01_set_auto_retransmit_delay(&gs_handle, reg);
+    res = nrf24l01_auto_retransmit_delay_convert_to_register(&gs_handle, NRF24L01_BASIC_DEFAULT_RETRANSMIT_DELAY, (uint8_t *)&profile.retransmit_delay);
     if (res != 0)
     {
         nrf24l01_interface_debug_print("nrf24l01: auto retransmit delay failed.\n");
@@ -344,61 +193,11 @@ uint8_t nrf24l01_basic_init(nrf24l01_type_t type, void (*callback)(uint8_t type,
         return 1;
     }
     
-    /* set the auto retransmit count */
-    res = nrf24l01_set_auto_retransmit_count(&gs_handle, NRF24L01_BASIC_DEFAULT_RETRANSMIT_COUNT);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: auto retransmit count failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set the channel frequency */
-    res = nrf24l01_set_channel_frequency(&gs_handle, NRF24L01_BASIC_DEFAULT_CHANNEL_FREQUENCY);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set channel frequency failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* disable continuous carrier transmit */
-    res = nrf24l01_set_continuous_carrier_transmit(&gs_handle, NRF24L01_BOOL_FALSE);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set continuous carrier transmit failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* disable force pll lock signal */
-    res = nrf24l01_set_force_pll_lock_signal(&gs_handle, NRF24L01_BOOL_FALSE);
+    /* apply the profile */
+    res = nrf24l01_apply_profile(&gs_handle, &profile);
     if (res != 0)
     {
-        nrf24l01_interface_debug_print("nrf24l01: set force pll lock signal failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set data rate */
-    res = nrf24l01_set_data_rate(&gs_handle, NRF24L01_BASIC_DEFAULT_DATA_RATE);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set data rate 2M failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set output power */
-    res = nrf24l01_set_output_power(&gs_handle, NRF24L01_BASIC_DEFAULT_OUTPUT_POWER);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set output power failed.\n");
+        nrf24l01_interface_debug_print("nrf24l01: apply profile failed.\n");
         (void)nrf24l01_deinit(&gs_handle);
         
         return 1;
@@ -444,216 +243,6 @@ uint8_t nrf24l01_basic_init(nrf24l01_type_t type, void (*callback)(uint8_t type,
         return 1;
     }
     
-    /* set pipe 0 payload number */
-    res = nrf24l01_set_pipe_0_payload_number(&gs_handle, NRF24L01_BASIC_DEFAULT_PIPE_0_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe 0 payload number failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 1 payload number */
-    res = nrf24l01_set_pipe_1_payload_number(&gs_handle, NRF24L01_BASIC_DEFAULT_PIPE_1_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe 1 payload number failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 2 payload number */
-    res = nrf24l01_set_pipe_2_payload_number(&gs_handle, NRF24L01_BASIC_DEFAULT_PIPE_2_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe 2 payload number failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 3 payload number */
-    res = nrf24l01_set_pipe_3_payload_number(&gs_handle, NRF24L01_BASIC_DEFAULT_PIPE_3_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe 3 payload number failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 4 payload number */
-    res = nrf24l01_set_pipe_4_payload_number(&gs_handle, NRF24L01_BASIC_DEFAULT_PIPE_4_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe 4 payload number failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 5 payload number */
-    res = nrf24l01_set_pipe_5_payload_number(&gs_handle, NRF24L01_BASIC_DEFAULT_PIPE_5_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe 5 payload number failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 0 dynamic payload */
-    res = nrf24l01_set_pipe_dynamic_payload(&gs_handle, NRF24L01_PIPE_0, NRF24L01_BASIC_DEFAULT_PIPE_0_DYNAMIC_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe dynamic payload failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 1 dynamic payload */
-    res = nrf24l01_set_pipe_dynamic_payload(&gs_handle, NRF24L01_PIPE_1, NRF24L01_BASIC_DEFAULT_PIPE_1_DYNAMIC_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe dynamic payload failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 2 dynamic payload */
-    res = nrf24l01_set_pipe_dynamic_payload(&gs_handle, NRF24L01_PIPE_2, NRF24L01_BASIC_DEFAULT_PIPE_2_DYNAMIC_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe dynamic payload failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 3 dynamic payload */
-    res = nrf24l01_set_pipe_dynamic_payload(&gs_handle, NRF24L01_PIPE_3, NRF24L01_BASIC_DEFAULT_PIPE_3_DYNAMIC_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe dynamic payload failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 4 dynamic payload */
-    res = nrf24l01_set_pipe_dynamic_payload(&gs_handle, NRF24L01_PIPE_4, NRF24L01_BASIC_DEFAULT_PIPE_4_DYNAMIC_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe dynamic payload failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pipe 5 dynamic payload */
-    res = nrf24l01_set_pipe_dynamic_payload(&gs_handle, NRF24L01_PIPE_5, NRF24L01_BASIC_DEFAULT_PIPE_5_DYNAMIC_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set pipe dynamic payload failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set dynamic payload */
-    res = nrf24l01_set_dynamic_payload(&gs_handle, NRF24L01_BASIC_DEFAULT_DYNAMIC_PAYLOAD);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set dynamic payload failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set payload with ack */
-    res = nrf24l01_set_payload_with_ack(&gs_handle, NRF24L01_BASIC_DEFAULT_PAYLOAD_WITH_ACK);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set payload with ack failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set tx payload with no ack */
-    res = nrf24l01_set_tx_payload_with_no_ack(&gs_handle, NRF24L01_BASIC_DEFAULT_TX_PAYLOAD_WITH_NO_ACK);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set tx payload with no ack failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set rx pipe 0 address */
-    res = nrf24l01_set_rx_pipe_0_address(&gs_handle, (uint8_t *)addr0, NRF24L01_BASIC_DEFAULT_ADDRESS_WIDTH + 2);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe 0 address failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set rx pipe 1 address */
-    res = nrf24l01_set_rx_pipe_1_address(&gs_handle, (uint8_t *)addr1, NRF24L01_BASIC_DEFAULT_ADDRESS_WIDTH + 2);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe 1 address failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set rx pipe 2 address */
-    res = nrf24l01_set_rx_pipe_2_address(&gs_handle, addr2[4]);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe 2 address failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set rx pipe 3 address */
-    res = nrf24l01_set_rx_pipe_3_address(&gs_handle, addr3[4]);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe 3 address failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set rx pipe 4 address */
-    res = nrf24l01_set_rx_pipe_4_address(&gs_handle, addr4[4]);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe 4 address failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set rx pipe 5 address */
-    res = nrf24l01_set_rx_pipe_5_address(&gs_handle, addr5[4]);
-    if (res != 0)
-    {
-        nrf24l01_interface_debug_print("nrf24l01: set rx pipe 5 address failed.\n");
-        (void)nrf24l01_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
     /* flush tx */
     res = nrf24l01_flush_tx(&gs_handle);
     if (res != 0)
@@ -94,6 +94,8 @@ extern "C"{
 #define NRF24L01_BASIC_DEFAULT_RX_ADDR_3                         {0x1B, 0x01, 0x02, 0x03, 0x03}        /**< rx address 3 */
 #define NRF24L01_BASIC_DEFAULT_RX_ADDR_4                         {0x1B, 0x01, 0x02, 0x03, 0x04}        /**< rx address 4 */
 #define NRF24L01_BASIC_DEFAULT_RX_ADDR_5                         {0x1B, 0x01, 0x02, 0x03, 0x05}        /**< rx address 5 */
+#define NRF24L01_BASIC_DEFAULT_REGISTER_SHADOW                   NRF24L01_BOOL_FALSE                   /**< disable register shadow */
+#define NRF24L01_BASIC_DEFAULT_RX_DRAIN                          NRF24L01_BOOL_FALSE                   /**< disable rx fifo drain */
 
 /**
  * @brief nrf24l01 type enumeration definition
@@ -122,7 +124,7 @@ uint8_t nrf24l01_interrupt_irq_handler(void);
  *            - 1 init failed
  * @note      none
  */
-uint8_t nrf24l01_basic_init(nrf24l01_type_t type, void (*callback)(uint8_t type, uint8_t num, uint8_t *buf, uint8_t len));
+uint8_t nrf24l01_basic_init(nrf24l01_type_t type, void (*callback)(void *user_data, uint8_t type, uint8_t num, uint8_t *buf, uint8_t len));
 
 /**
  * @brief  basic example deinit
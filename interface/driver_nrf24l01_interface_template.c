@@ -37,31 +37,34 @@
 #include "driver_nrf24l01_interface.h"
 
 /**
- * @brief  interface spi bus init
- * @return status code
- *         - 0 success
- *         - 1 spi init failed
- * @note   none
+ * @brief     interface spi bus init
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi init failed
+ * @note      none
  */
-uint8_t nrf24l01_interface_spi_init(void)
+uint8_t nrf24l01_interface_spi_init(void *user_data)
 {
     return 0;
 }
 
 /**
- * @brief  interface spi bus deinit
- * @return status code
- *         - 0 success
- *         - 1 spi deinit failed
- * @note   none
+ * @brief     interface spi bus deinit
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi deinit failed
+ * @note      none
  */
-uint8_t nrf24l01_interface_spi_deinit(void)
+uint8_t nrf24l01_interface_spi_deinit(void *user_data)
 {
     return 0;
 }
 
 /**
  * @brief      interface spi bus read
+ * @param[in]  *user_data pointer to the user data
  * @param[in]  reg register address
  * @param[out] *buf pointer to a data buffer
  * @param[in]  len length of data buffer
@@ -70,13 +73,14 @@ uint8_t nrf24l01_interface_spi_deinit(void)
  *             - 1 read failed
  * @note       none
  */
-uint8_t nrf24l01_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len)
+uint8_t nrf24l01_interface_spi_read(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len)
 {
     return 0;
 }
 
 /**
  * @brief     interface spi bus write
+ * @param[in] *user_data pointer to the user data
  * @param[in] reg register address
  * @param[in] *buf pointer to a data buffer
  * @param[in] len length of data buffer
@@ -85,44 +89,63 @@ uint8_t nrf24l01_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len)
  *            - 1 write failed
  * @note      none
  */
-uint8_t nrf24l01_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len)
+uint8_t nrf24l01_interface_spi_write(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len)
 {
     return 0;
 }
 
 /**
- * @brief  interface gpio init
- * @return status code
- *         - 0 success
- *         - 1 init failed
- * @note   none
+ * @brief      interface spi bus full duplex transfer
+ * @param[in]  *user_data pointer to the user data
+ * @param[in]  *tx pointer to a tx buffer
+ * @param[out] *rx pointer to a rx buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 transfer failed
+ * @note       none
  */
-uint8_t nrf24l01_interface_gpio_init(void)
+uint8_t nrf24l01_interface_spi_transfer(void *user_data, uint8_t *tx, uint8_t *rx, uint16_t len)
 {
     return 0;
 }
 
 /**
- * @brief  interface gpio deinit
- * @return status code
- *         - 0 success
- *         - 1 deinit failed
- * @note   none
+ * @brief     interface gpio init
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      none
  */
-uint8_t nrf24l01_interface_gpio_deinit(void)
+uint8_t nrf24l01_interface_gpio_init(void *user_data)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface gpio deinit
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 deinit failed
+ * @note      none
+ */
+uint8_t nrf24l01_interface_gpio_deinit(void *user_data)
 {
     return 0;
 }
 
 /**
  * @brief     interface gpio write
+ * @param[in] *user_data pointer to the user data
  * @param[in] data written data
  * @return    status code
  *            - 0 success
  *            - 1 write failed
  * @note      none
  */
-uint8_t nrf24l01_interface_gpio_write(uint8_t data)
+uint8_t nrf24l01_interface_gpio_write(void *user_data, uint8_t data)
 {
     return 0;
 }
@@ -137,6 +160,26 @@ void nrf24l01_interface_delay_ms(uint32_t ms)
 
 }
 
+/**
+ * @brief     interface delay us
+ * @param[in] us time
+ * @note      none
+ */
+void nrf24l01_interface_delay_us(uint32_t us)
+{
+
+}
+
+/**
+ * @brief  interface timestamp us
+ * @return free running microsecond counter
+ * @note   none
+ */
+uint32_t nrf24l01_interface_timestamp_us(void)
+{
+    return 0;
+}
+
 /**
  * @brief     interface print format data
  * @param[in] fmt format data
@@ -149,13 +192,14 @@ void nrf24l01_interface_debug_print(const char *const fmt, ...)
 
 /**
  * @brief     interface receive callback
+ * @param[in] *user_data pointer to the user data
  * @param[in] type receive callback type
  * @param[in] num pipe number
  * @param[in] *buf pointer to a data buffer
  * @param[in] len buffer length
  * @note      none
  */
-void nrf24l01_interface_receive_callback(uint8_t type, uint8_t num, uint8_t *buf, uint8_t len)
+void nrf24l01_interface_receive_callback(void *user_data, uint8_t type, uint8_t num, uint8_t *buf, uint8_t len)
 {
     switch (type)
     {
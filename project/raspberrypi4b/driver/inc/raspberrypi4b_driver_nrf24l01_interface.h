@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      raspberrypi4b_driver_nrf24l01_interface.h
+ * @brief     raspberrypi4b driver nrf24l01 interface header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-17
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/17  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef RASPBERRYPI4B_DRIVER_NRF24L01_INTERFACE_H
+#define RASPBERRYPI4B_DRIVER_NRF24L01_INTERFACE_H
+
+#include "driver_nrf24l01_interface.h"
+#include "gpio.h"
+#include "wire.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup raspberrypi4b_nrf24l01_interface raspberrypi4b nrf24l01 interface function
+ * @brief    raspberrypi4b nrf24l01 interface modules
+ * @{
+ */
+
+/**
+ * @brief raspberrypi4b nrf24l01 radio structure definition
+ */
+typedef struct raspberrypi4b_nrf24l01_s
+{
+    char *spi_device;              /**< spi device name */
+    uint32_t ce_line;              /**< ce gpio line */
+    uint32_t irq_line;             /**< irq gpio line */
+    int spi_fd;                    /**< spi handle */
+    wire_clock_t ce;               /**< ce gpio handle */
+    gpio_interrupt_t irq;          /**< irq gpio handle */
+    nrf24l01_handle_t *handle;     /**< nrf24l01 handle of the radio */
+} raspberrypi4b_nrf24l01_t;
+
+/**
+ * @brief     start the irq of a radio
+ * @param[in] *radio pointer to a radio structure
+ * @param[in] *handle pointer to the nrf24l01 handle of the radio
+ * @return    status code
+ *            - 0 success
+ *            - 1 irq init failed
+ * @note      the irq handler of the radio runs in its own pthread
+ */
+uint8_t raspberrypi4b_nrf24l01_irq_init(raspberrypi4b_nrf24l01_t *radio, nrf24l01_handle_t *handle);
+
+/**
+ * @brief     stop the irq of a radio
+ * @param[in] *radio pointer to a radio structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 irq deinit failed
+ * @note      none
+ */
+uint8_t raspberrypi4b_nrf24l01_irq_deinit(raspberrypi4b_nrf24l01_t *radio);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -34,11 +34,10 @@
  * </table>
  */
 
-#include "driver_nrf24l01_interface.h"
+#include "raspberrypi4b_driver_nrf24l01_interface.h"
 #include "spi.h"
-#include "gpio.h"
-#include "wire.h"
 #include <stdarg.h>
+#include <time.h>
 
 /**
  * @brief spi device name definition
@@ -46,36 +45,109 @@
 #define SPI_DEVICE_NAME "/dev/spidev0.0"    /**< spi device name */
 
 /**
- * @brief spi device handle definition
+ * @brief gpio line definition
  */
-static int gs_spi_fd;                       /**< spi handle */
+#define CE_GPIO_LINE    27                  /**< ce gpio line */
+#define IRQ_GPIO_LINE   17                  /**< irq gpio line */
 
 /**
- * @brief  interface spi bus init
- * @return status code
- *         - 0 success
- *         - 1 spi init failed
- * @note   none
+ * @brief default radio definition
+ */
+static raspberrypi4b_nrf24l01_t gs_radio =
+{
+    .spi_device = SPI_DEVICE_NAME,
+    .ce_line = CE_GPIO_LINE,
+    .irq_line = IRQ_GPIO_LINE,
+};
+
+/**
+ * @brief     get the radio of the user data
+ * @param[in] *user_data pointer to the user data
+ * @return    pointer to the radio, the default radio when the user data is NULL
+ * @note      none
  */
-uint8_t nrf24l01_interface_spi_init(void)
+static raspberrypi4b_nrf24l01_t *a_radio(void *user_data)
 {
-    return spi_init(SPI_DEVICE_NAME, &gs_spi_fd, SPI_MODE_TYPE_0, 1000 * 1000);
+    return (user_data != NULL) ? (raspberrypi4b_nrf24l01_t *)user_data : &gs_radio;
 }
 
 /**
- * @brief  interface spi bus deinit
- * @return status code
- *         - 0 success
- *         - 1 spi deinit failed
- * @note   none
+ * @brief     radio irq
+ * @param[in] *param pointer to a radio structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      the kernel edge time goes to the handle before the irq handler runs
+ */
+static uint8_t a_radio_irq(void *param)
+{
+    raspberrypi4b_nrf24l01_t *radio = (raspberrypi4b_nrf24l01_t *)param;
+    
+    (void)nrf24l01_set_irq_timestamp(radio->handle, radio->irq.timestamp);
+    
+    return nrf24l01_irq_handler(radio->handle);
+}
+
+/**
+ * @brief     start the irq of a radio
+ * @param[in] *radio pointer to a radio structure
+ * @param[in] *handle pointer to the nrf24l01 handle of the radio
+ * @return    status code
+ *            - 0 success
+ *            - 1 irq init failed
+ * @note      the irq handler of the radio runs in its own pthread
+ */
+uint8_t raspberrypi4b_nrf24l01_irq_init(raspberrypi4b_nrf24l01_t *radio, nrf24l01_handle_t *handle)
+{
+    radio->handle = handle;
+    
+    return gpio_interrupt_open(&radio->irq, radio->irq_line, a_radio_irq, radio);
+}
+
+/**
+ * @brief     stop the irq of a radio
+ * @param[in] *radio pointer to a radio structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 irq deinit failed
+ * @note      none
  */
-uint8_t nrf24l01_interface_spi_deinit(void)
+uint8_t raspberrypi4b_nrf24l01_irq_deinit(raspberrypi4b_nrf24l01_t *radio)
+{
+    return gpio_interrupt_close(&radio->irq);
+}
+
+/**
+ * @brief     interface spi bus init
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi init failed
+ * @note      none
+ */
+uint8_t nrf24l01_interface_spi_init(void *user_data)
+{
+    raspberrypi4b_nrf24l01_t *radio = a_radio(user_data);
+    
+    return spi_init(radio->spi_device, &radio->spi_fd, SPI_MODE_TYPE_0, 1000 * 1000);
+}
+
+/**
+ * @brief     interface spi bus deinit
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi deinit failed
+ * @note      none
+ */
+uint8_t nrf24l01_interface_spi_deinit(void *user_data)
 {   
-    return spi_deinit(gs_spi_fd);
+    return spi_deinit(a_radio(user_data)->spi_fd);
 }
 
 /**
  * @brief      interface spi bus read
+ * @param[in]  *user_data pointer to the user data
  * @param[in]  reg register address
  * @param[out] *buf pointer to a data buffer
  * @param[in]  len length of data buffer
@@ -84,13 +156,14 @@ uint8_t nrf24l01_interface_spi_deinit(void)
  *             - 1 read failed
  * @note       none
  */
-uint8_t nrf24l01_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len)
+uint8_t nrf24l01_interface_spi_read(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len)
 {
-    return spi_read(gs_spi_fd, reg, buf, len);
+    return spi_read(a_radio(user_data)->spi_fd, reg, buf, len);
 }
 
 /**
  * @brief     interface spi bus write
+ * @param[in] *user_data pointer to the user data
  * @param[in] reg register address
  * @param[in] *buf pointer to a data buffer
  * @param[in] len length of data buffer
@@ -99,46 +172,67 @@ uint8_t nrf24l01_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len)
  *            - 1 write failed
  * @note      none
  */
-uint8_t nrf24l01_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len)
+uint8_t nrf24l01_interface_spi_write(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len)
 {
-    return spi_write(gs_spi_fd, reg, buf, len);
+    return spi_write(a_radio(user_data)->spi_fd, reg, buf, len);
 }
 
 /**
- * @brief  interface gpio init
- * @return status code
- *         - 0 success
- *         - 1 init failed
- * @note   none
+ * @brief      interface spi bus full duplex transfer
+ * @param[in]  *user_data pointer to the user data
+ * @param[in]  *tx pointer to a tx buffer
+ * @param[out] *rx pointer to a rx buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 transfer failed
+ * @note       none
  */
-uint8_t nrf24l01_interface_gpio_init(void)
+uint8_t nrf24l01_interface_spi_transfer(void *user_data, uint8_t *tx, uint8_t *rx, uint16_t len)
 {
-    return wire_clock_init();
+    return spi_transmit(a_radio(user_data)->spi_fd, tx, rx, len);
 }
 
 /**
- * @brief  interface gpio deinit
- * @return status code
- *         - 0 success
- *         - 1 deinit failed
- * @note   none
+ * @brief     interface gpio init
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      none
  */
-uint8_t nrf24l01_interface_gpio_deinit(void)
+uint8_t nrf24l01_interface_gpio_init(void *user_data)
 {
-    return wire_clock_deinit();
+    raspberrypi4b_nrf24l01_t *radio = a_radio(user_data);
+    
+    return wire_clock_open(&radio->ce, radio->ce_line);
+}
+
+/**
+ * @brief     interface gpio deinit
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 deinit failed
+ * @note      none
+ */
+uint8_t nrf24l01_interface_gpio_deinit(void *user_data)
+{
+    return wire_clock_close(&a_radio(user_data)->ce);
 }
 
 /**
  * @brief     interface gpio write
+ * @param[in] *user_data pointer to the user data
  * @param[in] data written data
  * @return    status code
  *            - 0 success
  *            - 1 write failed
  * @note      none
  */
-uint8_t nrf24l01_interface_gpio_write(uint8_t data)
+uint8_t nrf24l01_interface_gpio_write(void *user_data, uint8_t data)
 {
-    return wire_clock_write(data);
+    return wire_clock_set(&a_radio(user_data)->ce, data);
 }
 
 /**
@@ -151,6 +245,30 @@ void nrf24l01_interface_delay_ms(uint32_t ms)
     usleep(1000 * ms);
 }
 
+/**
+ * @brief     interface delay us
+ * @param[in] us time
+ * @note      none
+ */
+void nrf24l01_interface_delay_us(uint32_t us)
+{
+    usleep(us);
+}
+
+/**
+ * @brief  interface timestamp us
+ * @return free running microsecond counter
+ * @note   none
+ */
+uint32_t nrf24l01_interface_timestamp_us(void)
+{
+    struct timespec t;
+    
+    (void)clock_gettime(CLOCK_MONOTONIC, &t);
+    
+    return (uint32_t)((uint64_t)t.tv_sec * 1000000 + (uint64_t)t.tv_nsec / 1000);
+}
+
 /**
  * @brief     interface print format data
  * @param[in] fmt format data
@@ -171,13 +289,14 @@ void nrf24l01_interface_debug_print(const char *const fmt, ...)
 
 /**
  * @brief     interface receive callback
+ * @param[in] *user_data pointer to the user data
  * @param[in] type receive callback type
  * @param[in] num pipe number
  * @param[in] *buf pointer to a data buffer
  * @param[in] len buffer length
  * @note      none
  */
-void nrf24l01_interface_receive_callback(uint8_t type, uint8_t num, uint8_t *buf, uint8_t len)
+void nrf24l01_interface_receive_callback(void *user_data, uint8_t type, uint8_t num, uint8_t *buf, uint8_t len)
 {
     switch (type)
     {
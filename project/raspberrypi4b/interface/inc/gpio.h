@@ -40,6 +40,7 @@
 #include <unistd.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <pthread.h>
 
 #ifdef __cplusplus
  extern "C" {
@@ -51,6 +52,19 @@
  * @{
  */
 
+/**
+ * @brief gpio interrupt structure definition
+ */
+typedef struct gpio_interrupt_s
+{
+    struct gpiod_chip *chip;             /**< gpio chip handle */
+    struct gpiod_line *line;             /**< gpio line handle */
+    pthread_t pid;                       /**< gpio pthread pid */
+    uint8_t (*irq)(void *param);         /**< gpio irq */
+    void *param;                         /**< gpio irq parameter */
+    uint32_t timestamp;                  /**< last falling edge time in us */
+} gpio_interrupt_t;
+
 /**
  * @brief  gpio interrupt init
  * @return status code
@@ -69,6 +83,29 @@ uint8_t gpio_interrupt_init(void);
  */
 uint8_t gpio_interrupt_deinit(void);
 
+/**
+ * @brief     gpio interrupt open
+ * @param[in] *gpio pointer to a gpio interrupt structure
+ * @param[in] line gpio line
+ * @param[in] *irq pointer to an irq function
+ * @param[in] *param pointer to the irq parameter
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      every gpio interrupt runs its own pthread
+ */
+uint8_t gpio_interrupt_open(gpio_interrupt_t *gpio, uint32_t line, uint8_t (*irq)(void *param), void *param);
+
+/**
+ * @brief     gpio interrupt close
+ * @param[in] *gpio pointer to a gpio interrupt structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      none
+ */
+uint8_t gpio_interrupt_close(gpio_interrupt_t *gpio);
+
 /**
  * @}
  */
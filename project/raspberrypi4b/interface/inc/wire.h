@@ -51,6 +51,15 @@
  * @{
  */
 
+/**
+ * @brief wire clock structure definition
+ */
+typedef struct wire_clock_s
+{
+    struct gpiod_chip *chip;        /**< gpio chip handle */
+    struct gpiod_line *line;        /**< gpio line handle */
+} wire_clock_t;
+
 /**
  * @brief  wire bus init
  * @return status code
@@ -115,6 +124,37 @@ uint8_t wire_clock_deinit(void);
  */
 uint8_t wire_clock_write(uint8_t value);
 
+/**
+ * @brief     wire clock open
+ * @param[in] *clock pointer to a wire clock structure
+ * @param[in] line gpio line
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      the line is driven high after opening
+ */
+uint8_t wire_clock_open(wire_clock_t *clock, uint32_t line);
+
+/**
+ * @brief     wire clock close
+ * @param[in] *clock pointer to a wire clock structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t wire_clock_close(wire_clock_t *clock);
+
+/**
+ * @brief     wire clock write data
+ * @param[in] *clock pointer to a wire clock structure
+ * @param[in] value write data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t wire_clock_set(wire_clock_t *clock, uint8_t value);
+
 /**
  * @}
  */
@@ -51,14 +51,12 @@
 /**
  * @brief global var definition
  */
-static struct gpiod_chip *gs_chip;        /**< gpio chip handle */
-static struct gpiod_line *gs_line;        /**< gpio line handle */
-static pthread_t gs_pid;                  /**< gpio pthread pid */
+static gpio_interrupt_t gs_gpio;          /**< gpio interrupt handle */
 extern uint8_t (*g_gpio_irq)(void);       /**< gpio irq */
 
 /**
  * @brief  gpio interrupt pthread
- * @param  *p pointer to an args buffer
+ * @param  *p pointer to a gpio interrupt structure
  * @return NULL
  * @note   none
  */
@@ -66,6 +64,7 @@ static void *a_gpio_interrupt_pthread(void *p)
 {
     int res;
     struct gpiod_line_event event;
+    gpio_interrupt_t *gpio = (gpio_interrupt_t *)p;
     
     /* enable catching cancel signal */
     pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
@@ -77,11 +76,11 @@ static void *a_gpio_interrupt_pthread(void *p)
     while (1)
     {
         /* wait for the event */
-        res = gpiod_line_event_wait(gs_line, NULL);
+        res = gpiod_line_event_wait(gpio->line, NULL);
         if (res == 1)
         {
             /* read the event */
-            if (gpiod_line_event_read(gs_line, &event) != 0)
+            if (gpiod_line_event_read(gpio->line, &event) != 0)
             {
                 continue;
             }
@@ -89,11 +88,14 @@ static void *a_gpio_interrupt_pthread(void *p)
             /* if the falling edge */
             if (event.event_type == GPIOD_LINE_EVENT_FALLING_EDGE)
             {
-                /* check the g_gpio_irq */
-                if (g_gpio_irq != NULL)
+                /* save the edge time of the kernel */
+                gpio->timestamp = (uint32_t)((uint64_t)event.ts.tv_sec * 1000000 + (uint64_t)event.ts.tv_nsec / 1000);
+                
+                /* check the irq */
+                if (gpio->irq != NULL)
                 {
                     /* run the callback */
-                    g_gpio_irq();
+                    gpio->irq(gpio->param);
                 }
             }
         }
@@ -101,19 +103,47 @@ static void *a_gpio_interrupt_pthread(void *p)
 }
 
 /**
- * @brief  gpio interrupt init
- * @return status code
- *         - 0 success
- *         - 1 init failed
- * @note   none
+ * @brief     gpio irq of the default interrupt
+ * @param[in] *param pointer to the irq parameter
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      none
  */
-uint8_t gpio_interrupt_init(void)
+static uint8_t a_gpio_irq(void *param)
+{
+    /* check the g_gpio_irq */
+    if (g_gpio_irq != NULL)
+    {
+        /* run the callback */
+        return g_gpio_irq();
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     gpio interrupt open
+ * @param[in] *gpio pointer to a gpio interrupt structure
+ * @param[in] line gpio line
+ * @param[in] *irq pointer to an irq function
+ * @param[in] *param pointer to the irq parameter
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      every gpio interrupt runs its own pthread
+ */
+uint8_t gpio_interrupt_open(gpio_interrupt_t *gpio, uint32_t line, uint8_t (*irq)(void *param), void *param)
 {
     uint8_t res;
     
+    /* set the irq */
+    gpio->irq = irq;
+    gpio->param = param;
+    
     /* open the gpio group */
-    gs_chip = gpiod_chip_open(GPIO_DEVICE_NAME);
-    if (gs_chip == NULL)
+    gpio->chip = gpiod_chip_open(GPIO_DEVICE_NAME);
+    if (gpio->chip == NULL)
     {
         perror("gpio: open failed.\n");
 
@@ -121,30 +151,30 @@ uint8_t gpio_interrupt_init(void)
     }
     
     /* get the gpio line */
-    gs_line = gpiod_chip_get_line(gs_chip, GPIO_DEVICE_LINE);
-    if (gs_line == NULL) 
+    gpio->line = gpiod_chip_get_line(gpio->chip, line);
+    if (gpio->line == NULL) 
     {
         perror("gpio: get line failed.\n");
-        gpiod_chip_close(gs_chip);
+        gpiod_chip_close(gpio->chip);
 
         return 1;
     }
 
     /* catch the falling edge */
-    if (gpiod_line_request_falling_edge_events(gs_line, "gpiointerrupt") < 0)
+    if (gpiod_line_request_falling_edge_events(gpio->line, "gpiointerrupt") < 0)
     {
         perror("gpio: set edge events failed.\n");
-        gpiod_chip_close(gs_chip);
+        gpiod_chip_close(gpio->chip);
 
         return 1;
     }
 
     /* creat a gpio interrupt pthread */
-    res = pthread_create(&gs_pid, NULL, a_gpio_interrupt_pthread, NULL);
+    res = pthread_create(&gpio->pid, NULL, a_gpio_interrupt_pthread, gpio);
     if (res != 0)
     {
         perror("gpio: creat pthread failed.\n");
-        gpiod_chip_close(gs_chip);
+        gpiod_chip_close(gpio->chip);
 
         return 1;
     }
@@ -153,27 +183,55 @@ uint8_t gpio_interrupt_init(void)
 }
 
 /**
- * @brief  gpio interrupt deinit
- * @return status code
- *         - 0 success
- *         - 1 deinit failed
- * @note   none
+ * @brief     gpio interrupt close
+ * @param[in] *gpio pointer to a gpio interrupt structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      none
  */
-uint8_t gpio_interrupt_deinit(void)
+uint8_t gpio_interrupt_close(gpio_interrupt_t *gpio)
 {
     uint8_t res;
     
     /* close the gpio interrupt pthread */
-    res = pthread_cancel(gs_pid);
+    res = pthread_cancel(gpio->pid);
     if (res != 0)
     {
         perror("gpio: delete pthread failed.\n");
 
         return 1;
     }
+    
+    /* wait for the pthread */
+    (void)pthread_join(gpio->pid, NULL);
 
     /* close the gpio */
-    gpiod_chip_close(gs_chip);
+    gpiod_chip_close(gpio->chip);
     
     return 0;
 }
+
+/**
+ * @brief  gpio interrupt init
+ * @return status code
+ *         - 0 success
+ *         - 1 init failed
+ * @note   none
+ */
+uint8_t gpio_interrupt_init(void)
+{
+    return gpio_interrupt_open(&gs_gpio, GPIO_DEVICE_LINE, a_gpio_irq, NULL);
+}
+
+/**
+ * @brief  gpio interrupt deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 deinit failed
+ * @note   none
+ */
+uint8_t gpio_interrupt_deinit(void)
+{
+    return gpio_interrupt_close(&gs_gpio);
+}
@@ -53,8 +53,7 @@
  */
 static struct gpiod_chip *gs_chip;               /**< gpio chip handle */
 static struct gpiod_line *gs_line;               /**< gpio line handle */
-static struct gpiod_chip *gs_clock_chip;         /**< gpio clock chip handle */
-static struct gpiod_line *gs_clock_line;         /**< gpio clock line handle */
+static wire_clock_t gs_clock;                    /**< gpio clock handle */
 static volatile uint8_t gs_read_write_flag;      /**< read write flag */
 
 /**
@@ -191,17 +190,19 @@ uint8_t wire_write(uint8_t value)
 }
 
 /**
- * @brief  wire bus init
- * @return status code
- *         - 0 success
- *         - 1 init failed
- * @note   none
+ * @brief     wire clock open
+ * @param[in] *clock pointer to a wire clock structure
+ * @param[in] line gpio line
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      the line is driven high after opening
  */
-uint8_t wire_clock_init(void)
+uint8_t wire_clock_open(wire_clock_t *clock, uint32_t line)
 {
     /* open the gpio group */
-    gs_clock_chip = gpiod_chip_open(GPIO_DEVICE_NAME);
-    if (gs_clock_chip == NULL)
+    clock->chip = gpiod_chip_open(GPIO_DEVICE_NAME);
+    if (clock->chip == NULL)
     {
         perror("gpio: open failed.\n");
         
@@ -209,54 +210,94 @@ uint8_t wire_clock_init(void)
     }
     
     /* get the gpio line */
-    gs_clock_line = gpiod_chip_get_line(gs_clock_chip, GPIO_DEVICE_CLOCK_LINE);
-    if (gs_clock_line == NULL) 
+    clock->line = gpiod_chip_get_line(clock->chip, line);
+    if (clock->line == NULL) 
     {
         perror("gpio: get line failed.\n");
-        gpiod_chip_close(gs_clock_chip);
+        gpiod_chip_close(clock->chip);
 
         return 1;
     }
     
     /* set output */
-    if (gpiod_line_request_output(gs_clock_line, "gpio_output", GPIOD_LINE_ACTIVE_STATE_HIGH) != 0)
+    if (gpiod_line_request_output(clock->line, "gpio_output", GPIOD_LINE_ACTIVE_STATE_HIGH) != 0)
     {
+        gpiod_chip_close(clock->chip);
+        
         return 1;
     }
     
     /* set high */
-    return wire_clock_write(1);
+    return wire_clock_set(clock, 1);
 }
 
 /**
- * @brief  wire bus deint
- * @return status code
- *         - 0 success
- * @note   none
+ * @brief     wire clock close
+ * @param[in] *clock pointer to a wire clock structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
  */
-uint8_t wire_clock_deinit(void)
+uint8_t wire_clock_close(wire_clock_t *clock)
 {
     /* close the chip */
-    gpiod_chip_close(gs_clock_chip);
+    gpiod_chip_close(clock->chip);
     
     return 0;
 }
 
 /**
- * @brief     wire bus write data
+ * @brief     wire clock write data
+ * @param[in] *clock pointer to a wire clock structure
  * @param[in] value write data
  * @return    status code
  *            - 0 success
  *            - 1 write failed
  * @note      none
  */
-uint8_t wire_clock_write(uint8_t value)
+uint8_t wire_clock_set(wire_clock_t *clock, uint8_t value)
 {
     /* write the value */
-    if (gpiod_line_set_value(gs_clock_line, value) != 0)
+    if (gpiod_line_set_value(clock->line, value) != 0)
     {
         return 1;
     }
     
     return 0;
 }
+
+/**
+ * @brief  wire bus init
+ * @return status code
+ *         - 0 success
+ *         - 1 init failed
+ * @note   none
+ */
+uint8_t wire_clock_init(void)
+{
+    return wire_clock_open(&gs_clock, GPIO_DEVICE_CLOCK_LINE);
+}
+
+/**
+ * @brief  wire bus deint
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t wire_clock_deinit(void)
+{
+    return wire_clock_close(&gs_clock);
+}
+
+/**
+ * @brief     wire bus write data
+ * @param[in] value write data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t wire_clock_write(uint8_t value)
+{
+    return wire_clock_set(&gs_clock, value);
+}
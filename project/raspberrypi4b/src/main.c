@@ -45,13 +45,14 @@ uint8_t (*g_gpio_irq)(void) = NULL;        /**< gpio irq function address */
 
 /**
  * @brief     interface callback
+ * @param[in] *user_data pointer to the user data
  * @param[in] type receive callback type
  * @param[in] num pipe number
  * @param[in] *buf pointer to a data buffer
  * @param[in] len buffer length
  * @note      none
  */
-static void a_callback(uint8_t type, uint8_t num, uint8_t *buf, uint8_t len)
+static void a_callback(void *user_data, uint8_t type, uint8_t num, uint8_t *buf, uint8_t len)
 {
     switch (type)
     {
@@ -42,31 +42,34 @@
 #include <stdarg.h>
 
 /**
- * @brief  interface spi bus init
- * @return status code
- *         - 0 success
- *         - 1 spi init failed
- * @note   none
+ * @brief     interface spi bus init
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi init failed
+ * @note      none
  */
-uint8_t nrf24l01_interface_spi_init(void)
+uint8_t nrf24l01_interface_spi_init(void *user_data)
 {
     return spi_init(SPI_MODE_0);
 }
 
 /**
- * @brief  interface spi bus deinit
- * @return status code
- *         - 0 success
- *         - 1 spi deinit failed
- * @note   none
+ * @brief     interface spi bus deinit
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi deinit failed
+ * @note      none
  */
-uint8_t nrf24l01_interface_spi_deinit(void)
+uint8_t nrf24l01_interface_spi_deinit(void *user_data)
 {
     return spi_deinit();
 }
 
 /**
  * @brief      interface spi bus read
+ * @param[in]  *user_data pointer to the user data
  * @param[in]  reg register address
  * @param[out] *buf pointer to a data buffer
  * @param[in]  len length of data buffer
@@ -75,13 +78,14 @@ uint8_t nrf24l01_interface_spi_deinit(void)
  *             - 1 read failed
  * @note       none
  */
-uint8_t nrf24l01_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len)
+uint8_t nrf24l01_interface_spi_read(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len)
 {
     return spi_read(reg, buf, len);
 }
 
 /**
  * @brief     interface spi bus write
+ * @param[in] *user_data pointer to the user data
  * @param[in] reg register address
  * @param[in] *buf pointer to a data buffer
  * @param[in] len length of data buffer
@@ -90,44 +94,63 @@ uint8_t nrf24l01_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len)
  *            - 1 write failed
  * @note      none
  */
-uint8_t nrf24l01_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len)
+uint8_t nrf24l01_interface_spi_write(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len)
 {
     return spi_write(reg, buf, len);
 }
 
 /**
- * @brief  interface gpio init
- * @return status code
- *         - 0 success
- *         - 1 init failed
- * @note   none
+ * @brief      interface spi bus full duplex transfer
+ * @param[in]  *user_data pointer to the user data
+ * @param[in]  *tx pointer to a tx buffer
+ * @param[out] *rx pointer to a rx buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 transfer failed
+ * @note       none
+ */
+uint8_t nrf24l01_interface_spi_transfer(void *user_data, uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    return spi_transmit(tx, rx, len);
+}
+
+/**
+ * @brief     interface gpio init
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      none
  */
-uint8_t nrf24l01_interface_gpio_init(void)
+uint8_t nrf24l01_interface_gpio_init(void *user_data)
 {
     return wire_init();
 }
 
 /**
- * @brief  interface gpio deinit
- * @return status code
- *         - 0 success
- *         - 1 deinit failed
- * @note   none
+ * @brief     interface gpio deinit
+ * @param[in] *user_data pointer to the user data
+ * @return    status code
+ *            - 0 success
+ *            - 1 deinit failed
+ * @note      none
  */
-uint8_t nrf24l01_interface_gpio_deinit(void)
+uint8_t nrf24l01_interface_gpio_deinit(void *user_data)
 {
     return wire_deinit();
 }
 
 /**
  * @brief     interface gpio write
+ * @param[in] *user_data pointer to the user data
  * @param[in] data written data
  * @return    status code
  *            - 0 success
  *            - 1 write failed
  * @note      none
  */
-uint8_t nrf24l01_interface_gpio_write(uint8_t data)
+uint8_t nrf24l01_interface_gpio_write(void *user_data, uint8_t data)
 {
     return wire_write(data);
 }
@@ -142,6 +165,38 @@ void nrf24l01_interface_delay_ms(uint32_t ms)
     delay_ms(ms);
 }
 
+/**
+ * @brief     interface delay us
+ * @param[in] us time
+ * @note      none
+ */
+void nrf24l01_interface_delay_us(uint32_t us)
+{
+    delay_us(us);
+}
+
+/**
+ * @brief  interface timestamp us
+ * @return free running microsecond counter
+ * @note   none
+ */
+uint32_t nrf24l01_interface_timestamp_us(void)
+{
+    uint32_t tick;
+    uint32_t val;
+    uint32_t reload;
+    
+    /* read the tick and the systick counter consistently */
+    reload = SysTick->LOAD + 1;
+    do
+    {
+        tick = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (tick != HAL_GetTick());
+    
+    return tick * 1000 + ((reload - val) * 1000) / reload;
+}
+
 /**
  * @brief     interface print format data
  * @param[in] fmt format data
@@ -164,13 +219,14 @@ void nrf24l01_interface_debug_print(const char *const fmt, ...)
 
 /**
  * @brief     interface receive callback
+ * @param[in] *user_data pointer to the user data
  * @param[in] type receive callback type
  * @param[in] num pipe number
  * @param[in] *buf pointer to a data buffer
  * @param[in] len buffer length
  * @note      none
  */
-void nrf24l01_interface_receive_callback(uint8_t type, uint8_t num, uint8_t *buf, uint8_t len)
+void nrf24l01_interface_receive_callback(void *user_data, uint8_t type, uint8_t num, uint8_t *buf, uint8_t len)
 {
     switch (type)
     {
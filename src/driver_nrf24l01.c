@@ -93,334 +93,5900 @@
 #define NRF24L01_REG_DYNPD              0x1C        /**< enable dynamic payload length register */
 #define NRF24L01_REG_FEATURE            0x1D        /**< feature register */
 
+/**
+ * @brief register shadow definition
+ */
+#define NRF24L01_SHADOW_MASK            0x307FFC7FUL        /**< registers kept in the shadow, status and fifo registers are excluded */
+
+/**
+ * @brief rx drain definition
+ */
+#define NRF24L01_RX_DRAIN_MAX           32                  /**< max payloads delivered in one interrupt */
+
+/**
+ * @brief snapshot definition
+ */
+#define NRF24L01_SNAPSHOT_MAGIC         0xA5                /**< snapshot magic byte */
+#define NRF24L01_SNAPSHOT_REG_NUM       19                  /**< registers in a snapshot */
+
+/**
+ * @brief fragment definition
+ */
+#define NRF24L01_FRAGMENT_HEADER        2                   /**< fragment header length */
+
+/**
+ * @brief tx pipeline definition
+ */
+#define NRF24L01_TX_IN_FLIGHT           2                   /**< payloads in flight, the tx fifo empty flag counts them exactly */
+
+/**
+ * @brief timing definition
+ */
+#define NRF24L01_POLL_US                20                  /**< completion polling interval with delay_us */
+#define NRF24L01_SETTLE_US              130                 /**< tx and rx settling time */
+#define NRF24L01_POWER_UP_US            1500                /**< power down to standby time */
+#define NRF24L01_DEADLINE_MARGIN_US     1000                /**< send deadline margin for the interrupt latency */
+#define NRF24L01_RPD_US                 170                 /**< rx settling and agc time before the rpd is valid */
+#define NRF24L01_HUB_PINNED_MAX         4                   /**< pinned hub nodes, one pipe always rotates */
+#define NRF24L01_MESH_TTL               8                   /**< hops of a mesh frame */
+#define NRF24L01_MESH_PIPE_BYTE         0xC0                /**< mesh address lsb of pipe 0 */
+
+/**
+ * @brief retransmit tuner definition
+ */
+#define NRF24L01_TUNER_STREAK           16                  /**< first attempt deliveries before narrowing */
+#define NRF24L01_TUNER_HIGH             32                  /**< average of 2 retransmits widens the delay */
+#define NRF24L01_TUNER_LOW              4                   /**< average of 0.25 retransmits allows narrowing */
+
+/**
+ * @brief memory barrier definition
+ */
+#if defined(__GNUC__)
+#define NRF24L01_MEMORY_BARRIER()       __sync_synchronize()                            /**< full memory barrier */
+#define NRF24L01_CLAIM(flag)            __sync_bool_compare_and_swap(&(flag), 0, 1)     /**< set a flag from 0 to 1 atomically */
+#define NRF24L01_RELEASE(flag)          __sync_bool_compare_and_swap(&(flag), 1, 0)     /**< set a flag from 1 to 0 atomically */
+#elif defined(__ICCARM__)
+#include <intrinsics.h>
+#define NRF24L01_MEMORY_BARRIER()       __DMB()                                         /**< full memory barrier */
+#define NRF24L01_CLAIM(flag)            a_nrf24l01_flag_swap(&(flag), 0, 1)             /**< set a flag from 0 to 1 atomically */
+#define NRF24L01_RELEASE(flag)          a_nrf24l01_flag_swap(&(flag), 1, 0)             /**< set a flag from 1 to 0 atomically */
+
+/**
+ * @brief         swap a flag with the interrupts masked
+ * @param[in,out] *flag pointer to a flag
+ * @param[in]     from expected value
+ * @param[in]     to new value
+ * @return        1 if the flag is swapped, otherwise 0
+ * @note          the irq handler runs on the same core, so masking it makes the swap atomic
+ */
+static uint8_t a_nrf24l01_flag_swap(uint8_t *flag, uint8_t from, uint8_t to)
+{
+    __istate_t state;
+    uint8_t res;
+    
+    state = __get_interrupt_state();          /* save the interrupt state */
+    __disable_interrupt();                    /* mask the interrupts */
+    res = 0;                                  /* init 0 */
+    if (*flag == from)                        /* check the flag */
+    {
+        *flag = to;                           /* set the flag */
+        res = 1;                              /* swapped */
+    }
+    __DMB();                                  /* publish the flag */
+    __set_interrupt_state(state);             /* restore the interrupt state */
+    
+    return res;                               /* return the result */
+}
+#else
+#error "nrf24l01: no atomic compare and swap for this compiler"
+#endif
+
+/**
+ * @brief     count a statistics event
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] type counter type
+ *            - 0 spi error
+ *            - 1 rx fifo full
+ *            - 2 oversize
+ *            - 3 discarded
+ *            - 4 received
+ * @param[in] pipe pipe of a received payload
+ * @note      nothing is counted without a statistics block, the statistics sequence is odd
+ *            while the counter changes
+ */
+static void a_nrf24l01_stats_count(nrf24l01_handle_t *handle, uint8_t type, uint8_t pipe)
+{
+    nrf24l01_stats_t *stats;
+    
+    stats = handle->stats;           /* get the statistics */
+    if (stats == NULL)               /* check the statistics */
+    {
+        return;                      /* not counted */
+    }
+    handle->stats_sequence++;        /* start the update */
+    NRF24L01_MEMORY_BARRIER();       /* sequence before the counter */
+    if (type == 0)                   /* spi error */
+    {
+        stats->spi_error++;          /* spi_error++ */
+    }
+    else if (type == 1)              /* rx fifo full */
+    {
+        stats->rx_fifo_full++;       /* rx_fifo_full++ */
+    }
+    else if (type == 2)              /* oversize */
+    {
+        stats->oversize++;           /* oversize++ */
+    }
+    else if (type == 3)              /* discarded */
+    {
+        stats->discarded++;          /* discarded++ */
+    }
+    else
+    {
+        stats->rx[pipe % 6]++;       /* rx++ */
+    }
+    NRF24L01_MEMORY_BARRIER();       /* counter before the sequence */
+    handle->stats_sequence++;        /* finish the update */
+}
+
+/**
+ * @brief      run a read command
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  command command
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len data length
+ * @return     status code
+ *             - 0 success
+ *             - 1 spi read failed
+ * @note       the status clocked out with the command is kept when spi_transfer is linked
+ */
+static uint8_t a_nrf24l01_command_read(nrf24l01_handle_t *handle, uint8_t command, uint8_t *buf, uint16_t len)
+{
+    uint8_t tx[33];
+    uint8_t rx[33];
+    
+    if ((handle->spi_transfer == NULL) || (len > 32))                                              /* check spi_transfer */
+    {
+        if (handle->spi_read(handle->user_data, command, buf, len) != 0)                           /* spi read */
+        {
+            a_nrf24l01_stats_count(handle, 0, 0);                                                  /* spi_error++ */
+            
+            return 1;                                                                              /* return error */
+        }
+        
+        return 0;                                                                                  /* success return 0 */
+    }
+    
+    tx[0] = command;                                                                               /* set command */
+    memset(&tx[1], NRF24L01_COMMAND_NOP, len);                                                     /* set dummy */
+    if (handle->spi_transfer(handle->user_data, (uint8_t *)tx, (uint8_t *)rx, len + 1) != 0)       /* spi transfer */
+    {
+        a_nrf24l01_stats_count(handle, 0, 0);                                                      /* spi_error++ */
+        
+        return 1;                                                                                  /* return error */
+    }
+    handle->status = rx[0];                                                                        /* save status */
+    memcpy(buf, &rx[1], len);                                                                      /* copy data */
+    
+    return 0;                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief     run a write command
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] command command
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi write failed
+ * @note      the status clocked out with the command is kept when spi_transfer is linked
+ */
+static uint8_t a_nrf24l01_command_write(nrf24l01_handle_t *handle, uint8_t command, uint8_t *buf, uint16_t len)
+{
+    uint8_t tx[33];
+    uint8_t rx[33];
+    
+    if ((handle->spi_transfer == NULL) || (len > 32))                                              /* check spi_transfer */
+    {
+        if (handle->spi_write(handle->user_data, command, buf, len) != 0)                          /* spi write */
+        {
+            a_nrf24l01_stats_count(handle, 0, 0);                                                  /* spi_error++ */
+            
+            return 1;                                                                              /* return error */
+        }
+        
+        return 0;                                                                                  /* success return 0 */
+    }
+    
+    tx[0] = command;                                                                               /* set command */
+    if (len != 0)                                                                                  /* check length */
+    {
+        memcpy(&tx[1], buf, len);                                                                  /* copy data */
+    }
+    if (handle->spi_transfer(handle->user_data, (uint8_t *)tx, (uint8_t *)rx, len + 1) != 0)       /* spi transfer */
+    {
+        a_nrf24l01_stats_count(handle, 0, 0);                                                      /* spi_error++ */
+        
+        return 1;                                                                                  /* return error */
+    }
+    handle->status = rx[0];                                                                        /* save status */
+    
+    return 0;                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief     write a payload command
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] command command
+ * @param[in] *buf pointer to a payload buffer
+ * @param[in] len payload length
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi write failed
+ * @note      len <= 32, the legacy byte order is reversed in a single pass into the spi buffer,
+ *            the wire order is sent untouched
+ */
+static uint8_t a_nrf24l01_payload_write(nrf24l01_handle_t *handle, uint8_t command, uint8_t *buf, uint8_t len)
+{
+    uint8_t i;
+    uint8_t tx[33];
+    uint8_t rx[33];
+    
+    if (handle->spi_transfer != NULL)                                                                              /* check spi_transfer */
+    {
+        tx[0] = command;                                                                                           /* set command */
+        if (handle->wire_order != 0)                                                                               /* wire order */
+        {
+            memcpy(&tx[1], buf, len);                                                                              /* copy data */
+        }
+        else
+        {
+            for (i = 0; i < len; i++)                                                                              /* run len times */
+            {
+                tx[1 + i] = buf[len - 1 - i];                                                                      /* copy reversed */
+            }
+        }
+        if (handle->spi_transfer(handle->user_data, (uint8_t *)tx, (uint8_t *)rx, (uint16_t)(len + 1)) != 0)       /* spi transfer */
+        {
+            a_nrf24l01_stats_count(handle, 0, 0);                                                                  /* spi_error++ */
+            
+            return 1;                                                                                              /* return error */
+        }
+        handle->status = rx[0];                                                                                    /* save status */
+        
+        return 0;                                                                                                  /* success return 0 */
+    }
+    if (handle->wire_order != 0)                                                                                   /* wire order */
+    {
+        if (handle->spi_write(handle->user_data, command, buf, len) != 0)                                          /* spi write */
+        {
+            a_nrf24l01_stats_count(handle, 0, 0);                                                                  /* spi_error++ */
+            
+            return 1;                                                                                              /* return error */
+        }
+        
+        return 0;                                                                                                  /* success return 0 */
+    }
+    for (i = 0; i < len; i++)                                                                                      /* run len times */
+    {
+        tx[i] = buf[len - 1 - i];                                                                                  /* copy reversed */
+    }
+    if (handle->spi_write(handle->user_data, command, (uint8_t *)tx, len) != 0)                                    /* spi write */
+    {
+        a_nrf24l01_stats_count(handle, 0, 0);                                                                      /* spi_error++ */
+        
+        return 1;                                                                                                  /* return error */
+    }
+    
+    return 0;                                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief      read a payload command
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  command command
+ * @param[out] *buf pointer to a payload buffer
+ * @param[in]  len payload length
+ * @return     status code
+ *             - 0 success
+ *             - 1 spi read failed
+ * @note       len <= 32, the legacy byte order is reversed in a single pass out of the spi buffer,
+ *             the wire order is returned untouched
+ */
+static uint8_t a_nrf24l01_payload_read(nrf24l01_handle_t *handle, uint8_t command, uint8_t *buf, uint8_t len)
+{
+    uint8_t i;
+    uint8_t k;
+    uint8_t tmp;
+    uint8_t tx[33];
+    uint8_t rx[33];
+    
+    if (handle->spi_transfer != NULL)                                                                              /* check spi_transfer */
+    {
+        tx[0] = command;                                                                                           /* set command */
+        memset(&tx[1], NRF24L01_COMMAND_NOP, len);                                                                 /* set dummy bytes */
+        if (handle->spi_transfer(handle->user_data, (uint8_t *)tx, (uint8_t *)rx, (uint16_t)(len + 1)) != 0)       /* spi transfer */
+        {
+            a_nrf24l01_stats_count(handle, 0, 0);                                                                  /* spi_error++ */
+            
+            return 1;                                                                                              /* return error */
+        }
+        handle->status = rx[0];                                                                                    /* save status */
+        if (handle->wire_order != 0)                                                                               /* wire order */
+        {
+            memcpy(buf, &rx[1], len);                                                                              /* copy data */
+        }
+        else
+        {
+            for (i = 0; i < len; i++)                                                                              /* run len times */
+            {
+                buf[i] = rx[len - i];                                                                              /* copy reversed */
+            }
+        }
+        
+        return 0;                                                                                                  /* success return 0 */
+    }
+    if (handle->spi_read(handle->user_data, command, buf, len) != 0)                                               /* spi read */
+    {
+        a_nrf24l01_stats_count(handle, 0, 0);                                                                      /* spi_error++ */
+        
+        return 1;                                                                                                  /* return error */
+    }
+    if (handle->wire_order == 0)                                                                                   /* legacy order */
+    {
+        k = len / 2;                                                                                               /* get the half */
+        for (i = 0; i < k; i++)                                                                                    /* run k times */
+        {
+            tmp = buf[i];                                                                                          /* copy to tmp */
+            buf[i] = buf[len - 1 - i];                                                                             /* buf[i] = buf[n - 1 - i] */
+            buf[len - 1 - i] = tmp;                                                                                /* set buf[n - 1 - i]*/
+        }
+    }
+    
+    return 0;                                                                                                      /* success return 0 */
+}
+
+/**
+ * @brief     get the address shadow index
+ * @param[in] reg register address
+ * @return    index or 0xFF if the register is not an address register
+ * @note      none
+ */
+static uint8_t a_nrf24l01_shadow_address_index(uint8_t reg)
+{
+    if (reg == NRF24L01_REG_RX_ADDR_P0)        /* rx pipe 0 address */
+    {
+        return 0;                              /* return index 0 */
+    }
+    else if (reg == NRF24L01_REG_RX_ADDR_P1)   /* rx pipe 1 address */
+    {
+        return 1;                              /* return index 1 */
+    }
+    else if (reg == NRF24L01_REG_TX_ADDR)      /* tx address */
+    {
+        return 2;                              /* return index 2 */
+    }
+    else
+    {
+        return 0xFF;                           /* not an address register */
+    }
+}
+
+/**
+ * @brief      load from the register shadow
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  reg register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len data length
+ * @return     status code
+ *             - 0 hit
+ *             - 1 miss
+ * @note       none
+ */
+static uint8_t a_nrf24l01_shadow_load(nrf24l01_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint8_t index;
+    
+    if ((handle->shadow == NULL) || (reg > NRF24L01_REG_FEATURE))                      /* check shadow and range */
+    {
+        return 1;                                                                      /* miss */
+    }
+    if ((handle->shadow->valid & (1UL << reg)) == 0)                                   /* check valid */
+    {
+        return 1;                                                                      /* miss */
+    }
+    index = a_nrf24l01_shadow_address_index(reg);                                      /* get address index */
+    if (index != 0xFF)                                                                 /* address register */
+    {
+        if (len > handle->shadow->addr_len[index])                                     /* check length */
+        {
+            return 1;                                                                  /* miss */
+        }
+        memcpy(buf, handle->shadow->addr[index], len);                                 /* copy address */
+    }
+    else
+    {
+        if (len != 1)                                                                  /* check length */
+        {
+            return 1;                                                                  /* miss */
+        }
+        buf[0] = handle->shadow->reg[reg];                                             /* copy register */
+    }
+    
+    return 0;                                                                          /* hit */
+}
+
+/**
+ * @brief     store to the register shadow
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] reg register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @note      none
+ */
+static void a_nrf24l01_shadow_store(nrf24l01_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint8_t index;
+    
+    if ((handle->shadow == NULL) || (reg > NRF24L01_REG_FEATURE))                      /* check shadow and range */
+    {
+        return;                                                                        /* not cached */
+    }
+    if ((NRF24L01_SHADOW_MASK & (1UL << reg)) == 0)                                    /* check mask */
+    {
+        return;                                                                        /* not cached */
+    }
+    index = a_nrf24l01_shadow_address_index(reg);                                      /* get address index */
+    if (index != 0xFF)                                                                 /* address register */
+    {
+        if ((len == 0) || (len > 5))                                                   /* check length */
+        {
+            handle->shadow->valid &= ~(1UL << reg);                                    /* invalidate */
+            
+            return;                                                                    /* return */
+        }
+        memcpy(handle->shadow->addr[index], buf, len);                                 /* copy address */
+        if (((handle->shadow->valid & (1UL << reg)) == 0) ||
+            (handle->shadow->addr_len[index] < len))                                   /* check the old length */
+        {
+            handle->shadow->addr_len[index] = (uint8_t)len;                            /* set the valid length */
+        }
+    }
+    else
+    {
+        if (len != 1)                                                                  /* check length */
+        {
+            handle->shadow->valid &= ~(1UL << reg);                                    /* invalidate */
+            
+            return;                                                                    /* return */
+        }
+        handle->shadow->reg[reg] = buf[0];                                             /* copy register */
+    }
+    handle->shadow->valid |= 1UL << reg;                                               /* set valid */
+}
+
+/**
+ * @brief snapshot register table, config is kept last so the chip powers up fully configured
+ */
+static const uint8_t gsc_nrf24l01_snapshot_reg[NRF24L01_SNAPSHOT_REG_NUM] =
+{
+    NRF24L01_REG_SETUP_AW, NRF24L01_REG_EN_AA, NRF24L01_REG_EN_RXADDR, NRF24L01_REG_SETUP_RETR,
+    NRF24L01_REG_RF_CH, NRF24L01_REG_RF_SETUP, NRF24L01_REG_RX_ADDR_P2, NRF24L01_REG_RX_ADDR_P3,
+    NRF24L01_REG_RX_ADDR_P4, NRF24L01_REG_RX_ADDR_P5, NRF24L01_REG_RX_PW_P0, NRF24L01_REG_RX_PW_P1,
+    NRF24L01_REG_RX_PW_P2, NRF24L01_REG_RX_PW_P3, NRF24L01_REG_RX_PW_P4, NRF24L01_REG_RX_PW_P5,
+    NRF24L01_REG_FEATURE, NRF24L01_REG_DYNPD, NRF24L01_REG_CONFIG,
+};
+
+/**
+ * @brief     calculate the snapshot crc
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    crc16 value
+ * @note      crc16 ccitt, polynomial 0x1021 and initial value 0xFFFF
+ */
+static uint16_t a_nrf24l01_crc16(const uint8_t *buf, uint16_t len)
+{
+    uint16_t crc;
+    uint16_t i;
+    uint8_t j;
+    
+    crc = 0xFFFF;                                            /* init crc */
+    for (i = 0; i < len; i++)                                /* run all bytes */
+    {
+        crc ^= (uint16_t)(buf[i] << 8);                      /* xor the byte */
+        for (j = 0; j < 8; j++)                              /* run all bits */
+        {
+            if ((crc & 0x8000) != 0)                         /* check msb */
+            {
+                crc = (uint16_t)((crc << 1) ^ 0x1021);       /* shift and xor */
+            }
+            else
+            {
+                crc = (uint16_t)(crc << 1);                  /* shift */
+            }
+        }
+    }
+    
+    return crc;                                              /* return crc */
+}
+
 /**
  * @brief      read bytes
  * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[in]  reg register address
- * @param[out] *buf pointer to a data buffer
- * @param[in]  len data length
+ * @param[in]  reg register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len data length
+ * @return     status code
+ *             - 0 success
+ *             - 1 spi read failed
+ * @note       none
+ */
+static uint8_t a_nrf24l01_spi_read(nrf24l01_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    if (a_nrf24l01_shadow_load(handle, reg, buf, len) == 0)                                      /* load from the shadow */
+    {
+        return 0;                                                                                /* success return 0 */
+    }
+    if (a_nrf24l01_command_read(handle, NRF24L01_COMMAND_R_REGISTER | reg, buf, len) != 0)       /* spi read */
+    {
+        return 1;                                                                                /* return error */
+    }
+    else
+    {
+        a_nrf24l01_shadow_store(handle, reg, buf, len);                                          /* store to the shadow */
+        if ((reg == NRF24L01_REG_STATUS) && (len != 0))                                          /* check status */
+        {
+            handle->status = buf[0];                                                             /* save status */
+        }
+
+        return 0;                                                                                /* success return 0 */
+    }
+}
+
+/**
+ * @brief     write bytes
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] reg register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi write failed
+ * @note      a write to a register of the send deadline drops the cached deadline
+ */
+static uint8_t a_nrf24l01_spi_write(nrf24l01_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    if ((reg == NRF24L01_REG_CONFIG) || (reg == NRF24L01_REG_EN_AA) || (reg == NRF24L01_REG_SETUP_AW) ||
+        (reg == NRF24L01_REG_SETUP_RETR) || (reg == NRF24L01_REG_RF_SETUP))                       /* check the send deadline registers */
+    {
+        handle->deadline_len = 0;                                                                 /* recompute the send deadline */
+    }
+    if (a_nrf24l01_command_write(handle, NRF24L01_COMMAND_W_REGISTER | reg, buf, len) != 0)       /* spi write */
+    {
+        if ((handle->shadow != NULL) && (reg <= NRF24L01_REG_FEATURE))                            /* check shadow and range */
+        {
+            handle->shadow->valid &= ~(1UL << reg);                                               /* the chip state is unknown */
+        }
+        
+        return 1;                                                                                 /* return error */
+    }
+    else
+    {
+        a_nrf24l01_shadow_store(handle, reg, buf, len);                                           /* store to the shadow */
+        
+        return 0;                                                                                 /* success return 0 */
+    }
+}
+
+/**
+ * @brief     update a register only when it differs
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] reg register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @param[in] mask bits owned by the caller, only used when len is 1
+ * @return    status code
+ *            - 0 success
+ *            - 1 update failed
+ * @note      the bits outside the mask keep the chip value
+ */
+static uint8_t a_nrf24l01_spi_update(nrf24l01_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len, uint8_t mask)
+{
+    uint8_t prev[5];
+    
+    if (a_nrf24l01_spi_read(handle, reg, prev, len) != 0)                /* read the chip value */
+    {
+        return 1;                                                        /* return error */
+    }
+    if (len == 1)                                                        /* single register */
+    {
+        buf[0] = (uint8_t)((prev[0] & (~mask)) | (buf[0] & mask));       /* keep the other bits */
+    }
+    if (memcmp(prev, buf, len) == 0)                                     /* check the difference */
+    {
+        return 0;                                                        /* unchanged */
+    }
+    
+    return a_nrf24l01_spi_write(handle, reg, buf, len);                  /* write the new value */
+}
+
+/**
+ * @brief     enter a power state
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] state power state
+ * @note      the time since the last transition goes to the residency of the state left, without
+ *            timestamp_us only the transitions are counted
+ */
+static void a_nrf24l01_power_enter(nrf24l01_handle_t *handle, uint8_t state)
+{
+    uint32_t now;
+    
+    now = (handle->timestamp_us != NULL) ? handle->timestamp_us() : handle->power->since;       /* get the time */
+    handle->power->residency[handle->power->state] += now - handle->power->since;               /* add the residency */
+    handle->power->since = now;                                                                 /* set the transition time */
+    if (handle->power->state != state)                                                          /* check the state */
+    {
+        handle->power->state = state;                                                           /* set the state */
+        handle->power->transitions++;                                                           /* transitions++ */
+    }
+}
+
+/**
+ * @brief     finish the pending send
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] status send status
+ * @return    1 if this call finished the send, 0 if no send was pending
+ * @note      the callback is cleared before it runs, so it can start the next send, sending is
+ *            cleared atomically so only one of the irq handler and nrf24l01_send finishes a send
+ */
+static uint8_t a_nrf24l01_send_done(nrf24l01_handle_t *handle, nrf24l01_send_status_t status)
+{
+    void (*callback)(nrf24l01_send_status_t status, void *param);
+    void *param;
+    
+    if (handle->sending == 0)                                                 /* check sending */
+    {
+        return 0;                                                             /* no pending send */
+    }
+    handle->finished = (uint8_t)status;                                       /* set finished */
+    if (NRF24L01_RELEASE(handle->sending) == 0)                               /* clear sending */
+    {
+        return 0;                                                             /* no pending send */
+    }
+    if ((handle->power != NULL) && (handle->power->enable != 0) &&
+        (handle->power->state == NRF24L01_POWER_STATE_TX))                    /* check tx */
+    {
+        a_nrf24l01_power_enter(handle, NRF24L01_POWER_STATE_STANDBY_2);       /* no payload left */
+    }
+    callback = handle->send_callback;                                         /* get the callback */
+    param = handle->send_param;                                               /* get the callback parameter */
+    handle->send_callback = NULL;                                             /* clear the callback */
+    if (callback != NULL)                                                     /* check the callback */
+    {
+        callback(status, param);                                              /* run the callback */
+    }
+    
+    return 1;                                                                 /* finished */
+}
+
+/**
+ * @brief     update the tx statistics
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] type counter type
+ *            - 0 sent
+ *            - 1 tx data sent
+ *            - 2 max retransmit
+ *            - 3 retransmit histogram
+ * @param[in] arc retransmit count of a delivered payload
+ * @note      updates the statistics block and the active per tx address statistics, the
+ *            statistics sequence is odd while they change
+ */
+static void a_nrf24l01_stats_tx(nrf24l01_handle_t *handle, uint8_t type, uint8_t arc)
+{
+    uint8_t i;
+    nrf24l01_tx_stats_t *stats[2];
+    
+    stats[0] = (handle->stats != NULL) ? &handle->stats->tx : NULL;       /* statistics block */
+    stats[1] = handle->tx_stats;                                          /* per tx address statistics */
+    handle->stats_sequence++;                                             /* start the update */
+    NRF24L01_MEMORY_BARRIER();                                            /* sequence before the counters */
+    for (i = 0; i < 2; i++)                                               /* update both */
+    {
+        if (stats[i] == NULL)                                             /* check the block */
+        {
+            continue;                                                     /* skip */
+        }
+        if (type == 0)                                                    /* sent */
+        {
+            stats[i]->sent++;                                             /* sent++ */
+        }
+        else if (type == 1)                                               /* tx data sent */
+        {
+            stats[i]->tx_ds++;                                            /* tx_ds++ */
+        }
+        else if (type == 2)                                               /* max retransmit */
+        {
+            stats[i]->max_rt++;                                           /* max_rt++ */
+        }
+        else
+        {
+            stats[i]->retransmit[arc & 0x0F]++;                           /* histogram++ */
+        }
+    }
+    NRF24L01_MEMORY_BARRIER();                                            /* counters before the sequence */
+    handle->stats_sequence++;                                             /* finish the update */
+}
+
+/**
+ * @brief     start a send
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] command payload write command
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @param[in] *callback pointer to a completion callback
+ * @param[in] *param pointer to the callback parameter
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ *            - 5 send is busy
+ * @note      the caller checks the length, the radio is claimed atomically so a concurrent
+ *            sender gets busy
+ */
+static uint8_t a_nrf24l01_send_start(nrf24l01_handle_t *handle, uint8_t command, uint8_t *buf, uint8_t len,
+                                     void (*callback)(nrf24l01_send_status_t status, void *param), void *param)
+{
+    uint8_t res;
+    
+    if (NRF24L01_CLAIM(handle->sending) == 0)                            /* claim the radio */
+    {
+        handle->debug_print("nrf24l01: send is busy.\n");                /* send is busy */
+       
+        return 5;                                                        /* return error */
+    }
+    handle->send_callback = callback;                                    /* set the callback */
+    handle->send_param = param;                                          /* set the callback parameter */
+    handle->finished = 0;                                                /* clear finished */
+    if (handle->gpio_write(handle->user_data, 0) != 0)                   /* gpio write */
+    {
+        handle->sending = 0;                                             /* clear sending */
+        handle->debug_print("nrf24l01: gpio write failed.\n");           /* gpio write failed */
+       
+        return 1;                                                        /* return error */
+    }
+    res = a_nrf24l01_payload_write(handle, command, buf, len);           /* set tx payload */
+    if (res != 0)                                                        /* check result */
+    {
+        handle->sending = 0;                                             /* clear sending */
+        handle->debug_print("nrf24l01: set tx payload failed.\n");       /* set tx payload failed */
+       
+        return 1;                                                        /* return error */
+    }
+    a_nrf24l01_stats_tx(handle, 0, 0);                                   /* sent++ */
+    if (handle->gpio_write(handle->user_data, 1) != 0)                   /* gpio write */
+    {
+        handle->sending = 0;                                             /* clear sending */
+        handle->debug_print("nrf24l01: gpio write failed.\n");           /* gpio write failed */
+       
+        return 1;                                                        /* return error */
+    }
+    if ((handle->power != NULL) && (handle->power->enable != 0))         /* check the power state */
+    {
+        a_nrf24l01_power_enter(handle, NRF24L01_POWER_STATE_TX);         /* sending */
+    }
+    
+    return 0;                                                            /* success return 0 */
+}
+
+/**
+ * @brief     update a retransmit tuner with one sample
+ * @param[in] *tuner pointer to a retransmit tuner
+ * @param[in] lost lost flag
+ * @param[in] retransmit retransmit count of the send
+ * @return    1 if the delay or count changed, 0 otherwise
+ * @note      none
+ */
+static uint8_t a_nrf24l01_tuner_update(nrf24l01_retransmit_tuner_t *tuner, uint8_t lost, uint8_t retransmit)
+{
+    uint8_t delay;
+    uint8_t count;
+    
+    delay = tuner->delay;                                                                                              /* save delay */
+    count = tuner->count;                                                                                              /* save count */
+    tuner->sent++;                                                                                                     /* sent++ */
+    if (lost != 0)                                                                                                     /* check lost */
+    {
+        tuner->lost++;                                                                                                 /* lost++ */
+        tuner->streak = 0;                                                                                             /* clear streak */
+        tuner->count = (uint8_t)((tuner->count + 2 < tuner->count_max) ? (tuner->count + 2) : tuner->count_max);       /* widen the count */
+        tuner->delay = (uint8_t)((tuner->delay < tuner->delay_max) ? (tuner->delay + 1) : tuner->delay_max);           /* widen the delay */
+    }
+    else
+    {
+        tuner->average = (uint16_t)(tuner->average - (tuner->average >> 3) + (retransmit << 1));                       /* average += (retransmit * 16 - average) / 8 */
+        if (retransmit == 0)                                                                                           /* first attempt delivery */
+        {
+            tuner->streak++;                                                                                           /* streak++ */
+        }
+        else
+        {
+            tuner->streak = 0;                                                                                         /* clear streak */
+        }
+        if ((retransmit >= tuner->count) && (tuner->count < tuner->count_max))                                         /* every retransmit was needed */
+        {
+            tuner->count++;                                                                                            /* widen the count */
+        }
+        else if ((tuner->average >= NRF24L01_TUNER_HIGH) && (tuner->delay < tuner->delay_max))                         /* retransmits stay high */
+        {
+            tuner->delay++;                                                                                            /* widen the delay */
+            tuner->average = NRF24L01_TUNER_HIGH / 2;                                                                  /* wait for new samples */
+        }
+        else if ((tuner->streak >= NRF24L01_TUNER_STREAK) && (tuner->average < NRF24L01_TUNER_LOW))                    /* clean link */
+        {
+            tuner->streak = 0;                                                                                         /* clear streak */
+            if (tuner->delay > tuner->delay_min)                                                                       /* check delay */
+            {
+                tuner->delay--;                                                                                        /* narrow the delay first */
+            }
+            else if (tuner->count > tuner->count_min)                                                                  /* check count */
+            {
+                tuner->count--;                                                                                        /* then narrow the count */
+            }
+            else
+            {
+                /* do nothing */
+            }
+        }
+        else
+        {
+            /* do nothing */
+        }
+    }
+    
+    return (uint8_t)((delay != tuner->delay) || (count != tuner->count));                                              /* return the changed flag */
+}
+
+/**
+ * @brief     load the tx fifo from the stream
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 load failed
+ * @note      at most 2 payloads are in flight so a coalesced TX_DS is counted exactly, a fragment
+ *            stream builds the header on the fly
+ */
+static uint8_t a_nrf24l01_stream_fill(nrf24l01_handle_t *handle)
+{
+    uint8_t len;
+    uint8_t *p;
+    uint16_t offset;
+    uint8_t buffer[32];
+    
+    len = handle->stream->len;                                                                              /* get length */
+    while ((handle->stream->loaded < handle->stream->num) &&
+           ((handle->stream->loaded - handle->stream->done) < NRF24L01_TX_IN_FLIGHT))                       /* check the fifo slots */
+    {
+        if (handle->stream->fragment != 0)                                                                  /* fragment stream */
+        {
+            offset = (uint16_t)(handle->stream->loaded * NRF24L01_FRAGMENT_PAYLOAD);                        /* get the offset */
+            len = (uint8_t)(((handle->stream->total - offset) > NRF24L01_FRAGMENT_PAYLOAD) ?
+                            NRF24L01_FRAGMENT_PAYLOAD : (handle->stream->total - offset));                  /* get the fragment length */
+            buffer[0] = (uint8_t)((handle->stream->id << 4) | ((handle->stream->loaded >> 8) & 0x07));      /* set id and index msb */
+            if ((handle->stream->loaded + 1) == handle->stream->num)                                        /* check the last fragment */
+            {
+                buffer[0] |= 1 << 3;                                                                        /* set last */
+            }
+            buffer[1] = (uint8_t)(handle->stream->loaded & 0xFF);                                           /* set index lsb */
+            memcpy(&buffer[NRF24L01_FRAGMENT_HEADER], &handle->stream->buf[offset], len);                   /* copy the fragment */
+            p = (uint8_t *)buffer;                                                                          /* set the payload */
+            len += NRF24L01_FRAGMENT_HEADER;                                                                /* add the header */
+        }
+        else
+        {
+            p = &handle->stream->buf[(uint32_t)handle->stream->loaded * len];                               /* get the payload */
+        }
+        if (a_nrf24l01_payload_write(handle, NRF24L01_COMMAND_W_TX_PAYLOAD, p, len) != 0)                   /* set tx payload */
+        {
+            return 1;                                                                                       /* return error */
+        }
+        a_nrf24l01_stats_tx(handle, 0, 0);                                                                  /* sent++ */
+        handle->stream->loaded++;                                                                           /* loaded++ */
+    }
+    
+    return 0;                                                                                               /* success return 0 */
+}
+
+/**
+ * @brief     complete the head payload of the stream
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] status send status
+ * @note      a fragment stream has no result buffer
+ */
+static void a_nrf24l01_stream_result(nrf24l01_handle_t *handle, nrf24l01_send_status_t status)
+{
+    if (handle->stream->result != NULL)                             /* check the result buffer */
+    {
+        handle->stream->result[handle->stream->done] = status;      /* set result */
+    }
+    if (status == NRF24L01_SEND_STATUS_OK)                          /* check ok */
+    {
+        handle->tx_sequence++;                                      /* sequence++ */
+    }
+    handle->stream->done++;                                         /* done++ */
+}
+
+/**
+ * @brief     update the stream from the irq status
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] status status register
+ * @return    status code
+ *            - 0 success
+ *            - 1 update failed
+ * @note      with 2 payloads in flight an empty tx fifo completes both and a non empty one completes
+ *            the head, so TX_DS flags coalesced by a late irq are counted exactly, the empty fifo
+ *            clears a TX_DS raised after the status read so the refill does not count it again, a
+ *            MAX_RT fails the head payload and the rest in flight are loaded again
+ */
+static uint8_t a_nrf24l01_stream_update(nrf24l01_handle_t *handle, uint8_t status)
+{
+    uint8_t fifo;
+    uint8_t clear;
+    
+    if (((status >> 5) & 0x01) != 0)                                                                /* send ok */
+    {
+        if (a_nrf24l01_spi_read(handle, NRF24L01_REG_FIFO_STATUS, (uint8_t *)&fifo, 1) != 0)        /* get fifo status */
+        {
+            return 1;                                                                               /* return error */
+        }
+        if (((fifo >> 4) & 0x01) != 0)                                                              /* tx fifo is empty */
+        {
+            clear = 1 << 5;                                                                         /* set tx ds */
+            if (a_nrf24l01_spi_write(handle, NRF24L01_REG_STATUS, (uint8_t *)&clear, 1) != 0)       /* clear a tx ds raised after the status read */
+            {
+                return 1;                                                                           /* return error */
+            }
+            while (handle->stream->done < handle->stream->loaded)                                   /* all loaded payloads are sent */
+            {
+                a_nrf24l01_stream_result(handle, NRF24L01_SEND_STATUS_OK);                          /* set ok */
+            }
+        }
+        else if (handle->stream->done < handle->stream->loaded)                                     /* the head payload is sent */
+        {
+            a_nrf24l01_stream_result(handle, NRF24L01_SEND_STATUS_OK);                              /* set ok */
+        }
+        else
+        {
+            /* do nothing */
+        }
+    }
+    if (((status >> 4) & 0x01) != 0)                                                                /* max rt */
+    {
+        if (a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_TX, NULL, 0) != 0)              /* flush tx */
+        {
+            return 1;                                                                               /* return error */
+        }
+        if (handle->stream->done < handle->stream->loaded)                                          /* the head payload failed */
+        {
+            a_nrf24l01_stream_result(handle, NRF24L01_SEND_STATUS_MAX_RT);                          /* set max rt */
+        }
+        handle->stream->failed = 1;                                                                 /* set failed */
+        if (handle->stream->fragment != 0)                                                          /* a lost fragment breaks the message */
+        {
+            handle->stream->done = handle->stream->num;                                             /* abort the message */
+        }
+        handle->stream->loaded = handle->stream->done;                                              /* load the flushed payloads again */
+    }
+    if (handle->stream->done >= handle->stream->num)                                                /* check the end */
+    {
+        handle->stream->enable = 0;                                                                 /* stop the stream */
+        (void)a_nrf24l01_send_done(handle, (handle->stream->failed != 0) ?
+                             NRF24L01_SEND_STATUS_MAX_RT : NRF24L01_SEND_STATUS_OK);                /* send done */
+        
+        return 0;                                                                                   /* success return 0 */
+    }
+    
+    return a_nrf24l01_stream_fill(handle);                                                          /* load the tx fifo */
+}
+
+/**
+ * @brief     get the tdma time
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    master time once the time sync has a sample, local time otherwise
+ * @note      none
+ */
+static uint32_t a_nrf24l01_tdma_now(nrf24l01_handle_t *handle)
+{
+    uint32_t local;
+    uint32_t master;
+    
+    local = handle->timestamp_us();                                /* get the local time */
+    if (nrf24l01_sync_get_time(handle, local, &master) != 0)       /* convert to the master time */
+    {
+        return local;                                              /* not synchronized */
+    }
+    
+    return master;                                                 /* return the master time */
+}
+
+/**
+ * @brief     check a frame fits in the own tdma slot
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] loaded frames already in the tx fifo
+ * @return    1 if the frame fits, otherwise 0
+ * @note      every frame is counted with the send deadline of a full frame
+ */
+static uint8_t a_nrf24l01_tdma_fit(nrf24l01_handle_t *handle, uint16_t loaded)
+{
+    uint32_t now;
+    
+    if (handle->tdma == NULL)                                                                               /* check tdma */
+    {
+        return 1;                                                                                           /* no slots */
+    }
+    now = a_nrf24l01_tdma_now(handle);                                                                      /* get the time */
+    if (handle->tdma->table[(now / handle->tdma->slot_us) % handle->tdma->num] != handle->tdma->node)       /* check the owner */
+    {
+        return 0;                                                                                           /* not our slot */
+    }
+    
+    return ((handle->tdma->slot_us - now % handle->tdma->slot_us) >=
+            (handle->tdma->margin_us + (uint32_t)(loaded + 1) * handle->tdma->frame_us)) ? 1 : 0;           /* check the time left */
+}
+
+/**
+ * @brief     count the tx ring frames held for the next tdma slot
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @note      every queued frame is counted once, when it is first held
+ */
+static void a_nrf24l01_tdma_hold(nrf24l01_handle_t *handle)
+{
+    uint16_t queued;
+    uint16_t counted;
+    nrf24l01_tx_ring_t *ring;
+    
+    ring = handle->tx_ring;                                                                    /* get the ring */
+    queued = (uint16_t)((ring->head + ring->depth - ring->load) % ring->depth);                /* frames not loaded */
+    counted = (uint16_t)((handle->tdma->mark + ring->depth - ring->load) % ring->depth);       /* frames counted before */
+    if (counted > queued)                                                                      /* the mark is loaded */
+    {
+        counted = 0;                                                                           /* none counted */
+    }
+    handle->tdma->held += (uint32_t)(queued - counted);                                        /* count the new frames */
+    handle->tdma->mark = ring->head;                                                           /* set the mark */
+}
+
+/**
+ * @brief     load the tx fifo from the tx ring
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 load failed
+ * @note      at most 2 frames are in flight so a coalesced TX_DS is counted exactly, with tdma only
+ *            the frames that fit in the own slot, the caller holds the radio claim
+ */
+static uint8_t a_nrf24l01_tx_ring_fill(nrf24l01_handle_t *handle)
+{
+    nrf24l01_tx_ring_t *ring;
+    nrf24l01_tx_frame_t *frame;
+    
+    ring = handle->tx_ring;                                                                                     /* get the ring */
+    while ((ring->load != ring->head) &&
+           (((ring->load + ring->depth - ring->tail) % ring->depth) < NRF24L01_TX_IN_FLIGHT))                   /* check the fifo slots */
+    {
+        if (a_nrf24l01_tdma_fit(handle,
+                                (uint16_t)((ring->load + ring->depth - ring->tail) % ring->depth)) == 0)        /* check the slot */
+        {
+            a_nrf24l01_tdma_hold(handle);                                                                       /* hold the frames for the next slot */
+            
+            break;                                                                                              /* break */
+        }
+        NRF24L01_MEMORY_BARRIER();                                                                              /* read the index before the frame */
+        frame = &ring->frame[ring->load];                                                                       /* get the frame */
+        if (a_nrf24l01_command_write(handle, NRF24L01_COMMAND_W_TX_PAYLOAD, frame->buf, frame->len) != 0)       /* set tx payload */
+        {
+            return 1;                                                                                           /* return error */
+        }
+        a_nrf24l01_stats_tx(handle, 0, 0);                                                                      /* sent++ */
+        ring->load = (uint16_t)((ring->load + 1) % ring->depth);                                                /* load++ */
+    }
+    
+    return 0;                                                                                                   /* success return 0 */
+}
+
+/**
+ * @brief     update the tx ring from the irq status
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] status status register
+ * @return    status code
+ *            - 0 success
+ *            - 1 update failed
+ * @note      same accounting as the stream, the empty fifo also clears a late TX_DS, a failed frame
+ *            is dropped from the ring, when tdma holds the queued frames with none in flight the send
+ *            finishes as held
+ */
+static uint8_t a_nrf24l01_tx_ring_update(nrf24l01_handle_t *handle, uint8_t status)
+{
+    uint8_t fifo;
+    uint8_t clear;
+    nrf24l01_tx_ring_t *ring;
+    
+    ring = handle->tx_ring;                                                                         /* get the ring */
+    if (((status >> 5) & 0x01) != 0)                                                                /* send ok */
+    {
+        if (a_nrf24l01_spi_read(handle, NRF24L01_REG_FIFO_STATUS, (uint8_t *)&fifo, 1) != 0)        /* get fifo status */
+        {
+            return 1;                                                                               /* return error */
+        }
+        if (((fifo >> 4) & 0x01) != 0)                                                              /* tx fifo is empty */
+        {
+            clear = 1 << 5;                                                                         /* set tx ds */
+            if (a_nrf24l01_spi_write(handle, NRF24L01_REG_STATUS, (uint8_t *)&clear, 1) != 0)       /* clear a tx ds raised after the status read */
+            {
+                return 1;                                                                           /* return error */
+            }
+            ring->sent += (ring->load + ring->depth - ring->tail) % ring->depth;                    /* all loaded frames are sent */
+            handle->tx_sequence += (ring->load + ring->depth - ring->tail) % ring->depth;           /* sequence += sent */
+            ring->tail = ring->load;                                                                /* free the frames */
+        }
+        else if (ring->tail != ring->load)                                                          /* the head frame is sent */
+        {
+            ring->sent++;                                                                           /* sent++ */
+            handle->tx_sequence++;                                                                  /* sequence++ */
+            ring->tail = (uint16_t)((ring->tail + 1) % ring->depth);                                /* free the frame */
+        }
+        else
+        {
+            /* do nothing */
+        }
+    }
+    if (((status >> 4) & 0x01) != 0)                                                                /* max rt */
+    {
+        if (a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_TX, NULL, 0) != 0)              /* flush tx */
+        {
+            return 1;                                                                               /* return error */
+        }
+        if (ring->tail != ring->load)                                                               /* the head frame failed */
+        {
+            ring->failed++;                                                                         /* failed++ */
+            ring->tail = (uint16_t)((ring->tail + 1) % ring->depth);                                /* drop the frame */
+        }
+        ring->load = ring->tail;                                                                    /* load the flushed frames again */
+    }
+    if (ring->tail == ring->head)                                                                   /* check the end */
+    {
+        (void)a_nrf24l01_send_done(handle, (((status >> 4) & 0x01) != 0) ?
+                             NRF24L01_SEND_STATUS_MAX_RT : NRF24L01_SEND_STATUS_OK);                /* send done */
+        
+        return 0;                                                                                   /* success return 0 */
+    }
+    if (a_nrf24l01_tx_ring_fill(handle) != 0)                                                       /* load the tx fifo */
+    {
+        return 1;                                                                                   /* return error */
+    }
+    if (ring->tail == ring->load)                                                                   /* nothing is in flight */
+    {
+        (void)a_nrf24l01_send_done(handle, NRF24L01_SEND_STATUS_HELD);                              /* wait for the next slot */
+    }
+    
+    return 0;                                                                                       /* success return 0 */
+}
+
+/**
+ * @brief     push a fragment to the reassembly context of a pipe
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe rx pipe
+ * @param[in] *buf pointer to a payload buffer
+ * @param[in] len payload length
+ * @note      consecutive messages never share an id, so a known id with an old index is a duplicate
+ */
+static void a_nrf24l01_reassembly_push(nrf24l01_handle_t *handle, uint8_t pipe, uint8_t *buf, uint8_t len)
+{
+    nrf24l01_reassembly_t *ctx;
+    uint8_t id;
+    uint16_t index;
+    uint32_t offset;
+    
+    ctx = handle->reassembly[pipe];                                               /* get the context */
+    if (len < NRF24L01_FRAGMENT_HEADER)                                           /* check the header */
+    {
+        ctx->out_of_order++;                                                      /* out_of_order++ */
+        
+        return;                                                                   /* return */
+    }
+    id = (buf[0] >> 4) & 0x0F;                                                    /* get the id */
+    index = (uint16_t)(((buf[0] & 0x07) << 8) | buf[1]);                          /* get the index */
+    if ((id == ctx->id) && (index < ctx->next))                                   /* check the duplicate */
+    {
+        ctx->duplicate++;                                                         /* duplicate++ */
+        
+        return;                                                                   /* return */
+    }
+    if (index == 0)                                                               /* first fragment */
+    {
+        if (ctx->active != 0)                                                     /* check the partial message */
+        {
+            ctx->out_of_order++;                                                  /* the partial message is lost */
+        }
+        ctx->id = id;                                                             /* set the id */
+        ctx->next = 0;                                                            /* clear next */
+        ctx->len = 0;                                                             /* clear length */
+        ctx->active = 1;                                                          /* set active */
+    }
+    else if ((ctx->active == 0) || (id != ctx->id) || (index != ctx->next))       /* check the order */
+    {
+        ctx->out_of_order++;                                                      /* out_of_order++ */
+        ctx->active = 0;                                                          /* drop the partial message */
+        
+        return;                                                                   /* return */
+    }
+    else
+    {
+        /* do nothing */
+    }
+    offset = (uint32_t)index * NRF24L01_FRAGMENT_PAYLOAD;                         /* get the offset */
+    len -= NRF24L01_FRAGMENT_HEADER;                                              /* get the fragment length */
+    if ((offset + len) > ctx->size)                                               /* check the buffer size */
+    {
+        ctx->overflow++;                                                          /* overflow++ */
+        ctx->active = 0;                                                          /* drop the message */
+        ctx->next = (uint16_t)(index + 1);                                        /* ignore the rest of the message */
+        
+        return;                                                                   /* return */
+    }
+    memcpy(&ctx->buf[offset], &buf[NRF24L01_FRAGMENT_HEADER], len);               /* copy the fragment */
+    ctx->len = (uint16_t)(offset + len);                                          /* set the length */
+    ctx->next = (uint16_t)(index + 1);                                            /* next++ */
+    if (((buf[0] >> 3) & 0x01) != 0)                                              /* last fragment */
+    {
+        ctx->active = 0;                                                          /* message done */
+        if (ctx->callback != NULL)                                                /* check the callback */
+        {
+            ctx->callback(pipe, ctx->buf, ctx->len, ctx->param);                  /* run the callback */
+        }
+    }
+}
+
+/**
+ * @brief     load the tx fifo from the ack queues
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 load failed
+ * @note      the pipes are served in turn and at most 3 ack payloads are loaded
+ */
+static uint8_t a_nrf24l01_ack_fill(nrf24l01_handle_t *handle)
+{
+    uint8_t i;
+    uint8_t idle;
+    uint8_t loaded;
+    nrf24l01_ack_t *ack;
+    nrf24l01_tx_ring_t *queue;
+    nrf24l01_tx_frame_t *frame;
+    
+    ack = handle->ack;                                                                            /* get the ack payload channel */
+    if (ack == NULL)                                                                              /* check the channel */
+    {
+        return 0;                                                                                 /* nothing to load */
+    }
+    loaded = 0;                                                                                   /* init 0 */
+    for (i = 0; i < 6; i++)                                                                       /* count the loaded frames */
+    {
+        queue = &ack->queue[i];                                                                   /* get the queue */
+        if (((ack->enable >> i) & 0x01) != 0)                                                     /* check enable */
+        {
+            loaded += (uint8_t)((queue->load + queue->depth - queue->tail) % queue->depth);       /* add the loaded frames */
+        }
+    }
+    idle = 0;                                                                                     /* init 0 */
+    while ((loaded < 3) && (idle < 6))                                                            /* check the fifo slots */
+    {
+        i = ack->pipe;                                                                            /* get the pipe */
+        ack->pipe = (uint8_t)((i + 1) % 6);                                                       /* next pipe */
+        queue = &ack->queue[i];                                                                   /* get the queue */
+        if ((((ack->enable >> i) & 0x01) == 0) || (queue->load == queue->head))                   /* nothing to load */
+        {
+            idle++;                                                                               /* idle++ */
+            
+            continue;                                                                             /* next pipe */
+        }
+        frame = &queue->frame[queue->load];                                                       /* get the frame */
+        if (a_nrf24l01_command_write(handle, (uint8_t)(NRF24L01_COMMAND_W_ACK_PAYLOAD | i),
+                                     frame->buf, frame->len) != 0)                                /* set payload with ack */
+        {
+            return 1;                                                                             /* return error */
+        }
+        queue->load = (uint16_t)((queue->load + 1) % queue->depth);                               /* load++ */
+        loaded++;                                                                                 /* loaded++ */
+        idle = 0;                                                                                 /* clear idle */
+    }
+    
+    return 0;                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief     get a free rx queue slot
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    pointer to the slot or NULL if the queue is not set or full
+ * @note      none
+ */
+static nrf24l01_rx_frame_t *a_nrf24l01_rx_queue_slot(nrf24l01_handle_t *handle)
+{
+    uint16_t next;
+    
+    if (handle->rx_queue == NULL)                                                  /* check the queue */
+    {
+        return NULL;                                                               /* not set */
+    }
+    next = (uint16_t)((handle->rx_queue->head + 1) % handle->rx_queue->depth);     /* get the next index */
+    if (next == handle->rx_queue->tail)                                            /* check full */
+    {
+        return NULL;                                                               /* full */
+    }
+    
+    return &handle->rx_queue->frame[handle->rx_queue->head];                       /* return the slot */
+}
+
+/**
+ * @brief     delay in us
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] us time
+ * @note      rounds up to whole ms when delay_us is not linked
+ */
+static void a_nrf24l01_delay_us(nrf24l01_handle_t *handle, uint32_t us)
+{
+    if (handle->delay_us != NULL)                          /* check delay_us */
+    {
+        handle->delay_us(us);                              /* delay us */
+    }
+    else
+    {
+        handle->delay_ms((us + 999) / 1000);               /* delay ms */
+    }
+}
+
+/**
+ * @brief     wait the tx and rx settling time
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @note      skipped when delay_us is not linked
+ */
+static void a_nrf24l01_settle(nrf24l01_handle_t *handle)
+{
+    if (handle->delay_us != NULL)                          /* check delay_us */
+    {
+        handle->delay_us(NRF24L01_SETTLE_US);              /* wait the settling time */
+    }
+}
+
+/**
+ * @brief      start a polling wait
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *t pointer to a polling time buffer
+ * @note       none
+ */
+static void a_nrf24l01_poll_start(nrf24l01_handle_t *handle, uint32_t *t)
+{
+    *t = (handle->timestamp_us != NULL) ? handle->timestamp_us() : 0;       /* start time or elapsed time */
+}
+
+/**
+ * @brief         poll once
+ * @param[in]     *handle pointer to an nrf24l01 handle structure
+ * @param[in,out] *t pointer to a polling time buffer
+ * @param[in]     timeout_us timeout in us
+ * @return        status code
+ *                - 0 waited one polling interval
+ *                - 1 timeout
+ * @note          the time is measured with timestamp_us when linked and counted from the delays
+ *                otherwise, the interval is NRF24L01_POLL_US with delay_us and 1 ms without
+ */
+static uint8_t a_nrf24l01_poll(nrf24l01_handle_t *handle, uint32_t *t, uint32_t timeout_us)
+{
+    uint32_t elapsed;
+    uint32_t step;
+    
+    elapsed = (handle->timestamp_us != NULL) ? (handle->timestamp_us() - *t) : *t;        /* get the elapsed time */
+    if (elapsed >= timeout_us)                                                            /* check timeout */
+    {
+        return 1;                                                                         /* timeout */
+    }
+    if (handle->delay_us != NULL)                                                         /* check delay_us */
+    {
+        handle->delay_us(NRF24L01_POLL_US);                                               /* delay one interval */
+        step = NRF24L01_POLL_US;                                                          /* set the step */
+    }
+    else
+    {
+        handle->delay_ms(1);                                                              /* delay 1 ms */
+        step = 1000;                                                                      /* set the step */
+    }
+    if (handle->timestamp_us == NULL)                                                     /* check timestamp_us */
+    {
+        *t += step;                                                                       /* count the elapsed time */
+    }
+    
+    return 0;                                                                             /* success return 0 */
+}
+
+/**
+ * @brief     retune with the minimal spi traffic
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] channel channel frequency
+ * @return    status code
+ *            - 0 success
+ *            - 1 retune failed
+ * @note      ce is low only for the rf channel write, the chip settles the pll after ce rises
+ */
+static uint8_t a_nrf24l01_hop(nrf24l01_handle_t *handle, uint8_t channel)
+{
+    uint8_t res;
+    
+    if (handle->gpio_write(handle->user_data, 0) != 0)                                    /* gpio write */
+    {
+        return 1;                                                                         /* return error */
+    }
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RF_CH, (uint8_t *)&channel, 1);       /* set rf channel */
+    if (handle->gpio_write(handle->user_data, 1) != 0)                                    /* gpio write */
+    {
+        return 1;                                                                         /* return error */
+    }
+    
+    return res;                                                                           /* return the result */
+}
+
+/**
+ * @brief     rotate the hub nodes over pipes 1 - 5
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 rotate failed
+ * @note      pinned nodes keep their pipes, rotating nodes keep their pipes when they stay and only
+ *            the changed pipes are written while ce is low
+ */
+static uint8_t a_nrf24l01_hub_rotate(nrf24l01_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t p;
+    uint8_t n;
+    uint8_t free_pipes;
+    uint8_t en;
+    uint8_t addr[5];
+    uint16_t i;
+    uint16_t k;
+    uint16_t old;
+    uint16_t map[6];
+    uint16_t chosen[5];
+    nrf24l01_hub_t *hub;
+    
+    hub = handle->hub;                                                                           /* get the hub */
+    free_pipes = 0;                                                                              /* init 0 */
+    for (p = 1; p < 6; p++)                                                                      /* pipe 1 - 5 */
+    {
+        map[p] = NRF24L01_HUB_NONE;                                                              /* init none */
+        old = hub->pipe_node[p];                                                                 /* get the node of the pipe */
+        if ((old != NRF24L01_HUB_NONE) && (hub->node[old].pinned != 0))                          /* check pinned */
+        {
+            map[p] = old;                                                                        /* keep the pinned node */
+        }
+        else
+        {
+            free_pipes++;                                                                        /* free pipe */
+        }
+    }
+    for (i = 0; i < hub->num; i++)                                                               /* pinned nodes without a pipe */
+    {
+        if ((hub->node[i].pinned != 0) && (hub->node[i].pipe == 0))                              /* check the node */
+        {
+            for (p = 1; p < 6; p++)                                                              /* find a free pipe */
+            {
+                if (map[p] == NRF24L01_HUB_NONE)                                                 /* check free */
+                {
+                    map[p] = i;                                                                  /* pin the node */
+                    free_pipes--;                                                                /* free pipes-- */
+                    
+                    break;                                                                       /* break */
+                }
+            }
+        }
+    }
+    n = 0;                                                                                       /* init 0 */
+    k = hub->next;                                                                               /* start from the next node */
+    for (i = 0; (i < hub->num) && (n < free_pipes); i++)                                         /* choose the rotating nodes */
+    {
+        if (hub->node[k].pinned == 0)                                                            /* check rotating */
+        {
+            chosen[n] = k;                                                                       /* choose the node */
+            n++;                                                                                 /* n++ */
+        }
+        k = (uint16_t)((k + 1) % hub->num);                                                      /* next node */
+    }
+    hub->next = k;                                                                               /* save the next node */
+    for (i = 0; i < n; i++)                                                                      /* chosen nodes keep their pipes */
+    {
+        p = hub->node[chosen[i]].pipe;                                                           /* get the pipe */
+        if ((p != 0) && (map[p] == NRF24L01_HUB_NONE))                                           /* check the pipe */
+        {
+            map[p] = chosen[i];                                                                  /* keep the pipe */
+            chosen[i] = NRF24L01_HUB_NONE;                                                       /* placed */
+        }
+    }
+    for (i = 0; i < n; i++)                                                                      /* place the other chosen nodes */
+    {
+        for (p = 1; (p < 6) && (chosen[i] != NRF24L01_HUB_NONE); p++)                            /* find a free pipe */
+        {
+            if (map[p] == NRF24L01_HUB_NONE)                                                     /* check free */
+            {
+                map[p] = chosen[i];                                                              /* set the node */
+                chosen[i] = NRF24L01_HUB_NONE;                                                   /* placed */
+            }
+        }
+    }
+    if (memcmp(&map[1], &hub->pipe_node[1], sizeof(uint16_t) * 5) == 0)                          /* check the change */
+    {
+        return 0;                                                                                /* nothing to rotate */
+    }
+    
+    if (handle->gpio_write(handle->user_data, 0) != 0)                                           /* gpio write */
+    {
+        return 1;                                                                                /* return error */
+    }
+    res = 0;                                                                                     /* init 0 */
+    en = 0;                                                                                      /* init 0 */
+    for (p = 1; p < 6; p++)                                                                      /* pipe 1 - 5 */
+    {
+        if (map[p] != NRF24L01_HUB_NONE)                                                         /* check the node */
+        {
+            en |= (uint8_t)(1 << p);                                                             /* enable the pipe */
+        }
+        old = hub->pipe_node[p];                                                                 /* get the old node */
+        if ((map[p] == old) || (map[p] == NRF24L01_HUB_NONE))                                    /* check the change */
+        {
+            continue;                                                                            /* skip the pipe */
+        }
+        if (p == 1)                                                                              /* pipe 1 */
+        {
+            memcpy(addr, hub->base, hub->width);                                                 /* copy the base address */
+            addr[0] = hub->node[map[p]].addr;                                                    /* set the node address byte */
+            res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_ADDR_P1, addr, hub->width);       /* set rx pipe 1 address */
+        }
+        else
+        {
+            res = a_nrf24l01_spi_write(handle, (uint8_t)(NRF24L01_REG_RX_ADDR_P1 + p - 1),
+                                       &hub->node[map[p]].addr, 1);                              /* set rx pipe 2 - 5 address */
+        }
+        if (res != 0)                                                                            /* check result */
+        {
+            break;                                                                               /* break */
+        }
+        if ((old != NRF24L01_HUB_NONE) && (hub->node[old].pipe == p))                            /* check the old node */
+        {
+            hub->node[old].pipe = 0;                                                             /* the old node waits */
+        }
+        hub->node[map[p]].pipe = p;                                                              /* set the pipe */
+        hub->pipe_node[p] = map[p];                                                              /* set the node */
+    }
+    if (res == 0)                                                                                /* check result */
+    {
+        for (p = 1; p < 6; p++)                                                                  /* pipe 1 - 5 */
+        {
+            old = hub->pipe_node[p];                                                             /* get the old node */
+            if ((map[p] == NRF24L01_HUB_NONE) && (old != NRF24L01_HUB_NONE))                     /* check the emptied pipe */
+            {
+                if (hub->node[old].pipe == p)                                                    /* check the old node */
+                {
+                    hub->node[old].pipe = 0;                                                     /* the old node waits */
+                }
+                hub->pipe_node[p] = NRF24L01_HUB_NONE;                                           /* no node */
+            }
+        }
+        res = a_nrf24l01_spi_update(handle, NRF24L01_REG_EN_RXADDR, &en, 1, 0x3E);               /* enable the used pipes */
+    }
+    if (handle->gpio_write(handle->user_data, 1) != 0)                                           /* gpio write */
+    {
+        return 1;                                                                                /* return error */
+    }
+    
+    return res;                                                                                  /* return the result */
+}
+
+/**
+ * @brief      build the mesh address of a pipe
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  node node address
+ * @param[in]  pipe rx pipe of the node
+ * @param[out] *addr pointer to an address buffer, lsb first
+ * @note       none
+ */
+static void a_nrf24l01_mesh_address(nrf24l01_handle_t *handle, uint16_t node, uint8_t pipe, uint8_t *addr)
+{
+    memcpy(addr, handle->mesh->base, handle->mesh->width);     /* copy the network address */
+    addr[0] = (uint8_t)(NRF24L01_MESH_PIPE_BYTE + pipe);       /* set the pipe byte */
+    addr[1] = (uint8_t)(node & 0xFF);                          /* set the node address lsb */
+    addr[2] = (uint8_t)((node >> 8) & 0xFF);                   /* set the node address msb */
+}
+
+/**
+ * @brief     get the next hop of a destination
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] to destination address
+ * @return    next hop address, NRF24L01_MESH_NONE means no route
+ * @note      the route cache comes first, the parent is the default route
+ */
+static uint16_t a_nrf24l01_mesh_next(nrf24l01_handle_t *handle, uint16_t to)
+{
+    uint16_t i;
+    
+    for (i = 0; i < handle->mesh->route_num; i++)                                                           /* search the route cache */
+    {
+        if ((handle->mesh->route[i].next != NRF24L01_MESH_NONE) && (handle->mesh->route[i].dst == to))      /* check the route */
+        {
+            return handle->mesh->route[i].next;                                                             /* return the cached next hop */
+        }
+    }
+    
+    return handle->mesh->parent;                                                                            /* return the parent */
+}
+
+/**
+ * @brief     learn a route
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] dst destination address
+ * @param[in] next next hop address
+ * @note      a known destination is updated, a new one takes a free entry or the oldest one
+ */
+static void a_nrf24l01_mesh_learn(nrf24l01_handle_t *handle, uint16_t dst, uint16_t next)
+{
+    uint16_t i;
+    uint16_t slot;
+    
+    slot = NRF24L01_MESH_NONE;                                                            /* init none */
+    for (i = 0; i < handle->mesh->route_num; i++)                                         /* search the route cache */
+    {
+        if (handle->mesh->route[i].next == NRF24L01_MESH_NONE)                            /* check free */
+        {
+            if (slot == NRF24L01_MESH_NONE)                                               /* first free entry */
+            {
+                slot = i;                                                                 /* save the entry */
+            }
+        }
+        else if (handle->mesh->route[i].dst == dst)                                       /* check the destination */
+        {
+            handle->mesh->route[i].next = next;                                           /* update the next hop */
+            
+            return;                                                                       /* return */
+        }
+        else
+        {
+            /* do nothing */
+        }
+    }
+    if (handle->mesh->route_num == 0)                                                     /* check the route cache */
+    {
+        return;                                                                           /* return */
+    }
+    if (slot == NRF24L01_MESH_NONE)                                                       /* check free */
+    {
+        slot = handle->mesh->route_next;                                                  /* replace the oldest entry */
+        handle->mesh->route_next = (uint16_t)((slot + 1) % handle->mesh->route_num);      /* next replaced entry */
+    }
+    handle->mesh->route[slot].dst = dst;                                                  /* set the destination */
+    handle->mesh->route[slot].next = next;                                                /* set the next hop */
+}
+
+/**
+ * @brief     get a free mesh forward queue slot
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    pointer to the slot or NULL when the forward queue is full
+ * @note      the slot is used only after a_nrf24l01_mesh_push routes it
+ */
+static nrf24l01_mesh_frame_t *a_nrf24l01_mesh_slot(nrf24l01_handle_t *handle)
+{
+    if ((uint16_t)((handle->mesh->head + 1) % handle->mesh->depth) == handle->mesh->tail)       /* check full */
+    {
+        return NULL;                                                                            /* return NULL */
+    }
+    
+    return &handle->mesh->frame[handle->mesh->head];                                            /* return the head slot */
+}
+
+/**
+ * @brief     route a received mesh frame
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *frame pointer to the forward queue slot holding the frame, NULL means the queue is full
+ * @param[in] *buf pointer to the frame buffer
+ * @param[in] len frame length
+ * @note      the frame is delivered or forwarded from the buffer it was read into
+ */
+static void a_nrf24l01_mesh_push(nrf24l01_handle_t *handle, nrf24l01_mesh_frame_t *frame, uint8_t *buf, uint8_t len)
+{
+    uint16_t to;
+    uint16_t from;
+    uint16_t via;
+    uint16_t next;
+    
+    if (len < NRF24L01_MESH_HEADER)                                                              /* check the header */
+    {
+        handle->mesh->dropped++;                                                                 /* dropped++ */
+        
+        return;                                                                                  /* return */
+    }
+    to = (uint16_t)(buf[0] | (buf[1] << 8));                                                     /* get the destination */
+    from = (uint16_t)(buf[2] | (buf[3] << 8));                                                   /* get the source */
+    via = (uint16_t)(buf[4] | (buf[5] << 8));                                                    /* get the last hop */
+    if (via != handle->mesh->parent)                                                             /* from a child */
+    {
+        a_nrf24l01_mesh_learn(handle, from, via);                                                /* learn the source route */
+        if (from != via)                                                                         /* check the last hop */
+        {
+            a_nrf24l01_mesh_learn(handle, via, via);                                             /* learn the child */
+        }
+    }
+    if (to == handle->mesh->address)                                                             /* check the destination */
+    {
+        if (handle->mesh->callback != NULL)                                                      /* check the callback */
+        {
+            handle->mesh->delivered++;                                                           /* delivered++ */
+            handle->mesh->callback(from, &buf[NRF24L01_MESH_HEADER], (uint8_t)(len - NRF24L01_MESH_HEADER),
+                                  handle->mesh->param);                                          /* run the message callback */
+        }
+        else
+        {
+            handle->mesh->dropped++;                                                             /* dropped++ */
+        }
+        
+        return;                                                                                  /* return */
+    }
+    next = a_nrf24l01_mesh_next(handle, to);                                                     /* get the next hop */
+    if ((frame == NULL) || (buf[6] == 0) || (next == NRF24L01_MESH_NONE) || (next == via))       /* check the forward */
+    {
+        handle->mesh->dropped++;                                                                 /* dropped++ */
+        
+        return;                                                                                  /* return */
+    }
+    buf[4] = (uint8_t)(handle->mesh->address & 0xFF);                                            /* set the last hop lsb */
+    buf[5] = (uint8_t)((handle->mesh->address >> 8) & 0xFF);                                     /* set the last hop msb */
+    buf[6]--;                                                                                    /* ttl-- */
+    frame->next = next;                                                                          /* set the next hop */
+    frame->len = len;                                                                            /* set the length */
+    handle->mesh->head = (uint16_t)((handle->mesh->head + 1) % handle->mesh->depth);             /* publish the frame */
+    handle->mesh->forwarded++;                                                                   /* forwarded++ */
+}
+
+/**
+ * @brief     send a mesh frame to the next hop
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] next next hop address
+ * @param[in] *buf pointer to a frame buffer
+ * @param[in] len frame length
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi or gpio failed
+ *            - 2 send failed
+ * @note      the parent is reached on the child pipe picked by the node address, the other nodes
+ *            on pipe 1, tx and pipe 0 addresses are written only when the next hop changes, a prx
+ *            chip sends in ptx mode and goes back to prx
+ */
+static uint8_t a_nrf24l01_mesh_send(nrf24l01_handle_t *handle, uint16_t next, uint8_t *buf, uint8_t len)
+{
+    uint8_t res;
+    uint8_t config;
+    uint8_t pipe;
+    uint8_t addr[5];
+    
+    pipe = (next == handle->mesh->parent) ? (uint8_t)(2 + (handle->mesh->address & 0x03)) : 1;           /* get the pipe of the next hop */
+    a_nrf24l01_mesh_address(handle, next, pipe, addr);                                                   /* build the next hop address */
+    if (handle->gpio_write(handle->user_data, 0) != 0)                                                   /* gpio write */
+    {
+        return 1;                                                                                        /* return error */
+    }
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_CONFIG, &config, 1);                                  /* get config */
+    if ((res == 0) && ((config & 0x01) != 0))                                                            /* check prx */
+    {
+        config &= (uint8_t)(~0x01);                                                                      /* ptx */
+        res = a_nrf24l01_spi_write(handle, NRF24L01_REG_CONFIG, &config, 1);                             /* set config */
+        config |= 0x01;                                                                                  /* restore prx later */
+    }
+    res |= a_nrf24l01_spi_update(handle, NRF24L01_REG_TX_ADDR, addr, handle->mesh->width, 0xFF);         /* update tx address */
+    res |= a_nrf24l01_spi_update(handle, NRF24L01_REG_RX_ADDR_P0, addr, handle->mesh->width, 0xFF);      /* update rx pipe 0 address for the ack */
+    if (res != 0)                                                                                        /* check result */
+    {
+        (void)handle->gpio_write(handle->user_data, 1);                                                  /* gpio write */
+        
+        return 1;                                                                                        /* return error */
+    }
+    res = (nrf24l01_send(handle, buf, len) != 0) ? 2 : 0;                                                /* send the frame */
+    if ((config & 0x01) != 0)                                                                            /* check prx */
+    {
+        if (handle->gpio_write(handle->user_data, 0) != 0)                                               /* gpio write */
+        {
+            return 1;                                                                                    /* return error */
+        }
+        if (a_nrf24l01_spi_write(handle, NRF24L01_REG_CONFIG, &config, 1) != 0)                          /* set config */
+        {
+            (void)handle->gpio_write(handle->user_data, 1);                                              /* gpio write */
+            
+            return 1;                                                                                    /* return error */
+        }
+        if (handle->gpio_write(handle->user_data, 1) != 0)                                               /* gpio write */
+        {
+            return 1;                                                                                    /* return error */
+        }
+        a_nrf24l01_settle(handle);                                                                       /* wait the rx settling time */
+    }
+    
+    return res;                                                                                          /* return the result */
+}
+
+/**
+ * @brief     add a time sync sample
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] master master time of the sample
+ * @param[in] local local time of the sample
+ * @note      the drift is the offset change over the sample interval, smoothed over 4 samples
+ */
+static void a_nrf24l01_sync_sample(nrf24l01_handle_t *handle, uint32_t master, uint32_t local)
+{
+    uint32_t offset;
+    uint32_t dt;
+    int64_t drift;
+    
+    offset = master - local;                                                                              /* get the offset */
+    if (handle->sync->samples != 0)                                                                       /* check the last sample */
+    {
+        dt = local - handle->sync->reference;                                                             /* get the interval */
+        drift = ((int64_t)handle->sync->drift * (int64_t)dt) / 1000000000;                                /* get the predicted drift */
+        handle->sync->error = (int32_t)(offset - (handle->sync->offset + (uint32_t)(int32_t)drift));      /* get the prediction error */
+        if (dt != 0)                                                                                      /* check the interval */
+        {
+            drift = ((int64_t)(int32_t)(offset - handle->sync->offset) * 1000000000) / (int64_t)dt;       /* get the drift in ppb */
+            if (handle->sync->samples == 1)                                                               /* first drift */
+            {
+                handle->sync->drift = (int32_t)drift;                                                     /* set the drift */
+            }
+            else
+            {
+                handle->sync->drift += (int32_t)((drift - handle->sync->drift) / 4);                      /* smooth the drift */
+            }
+        }
+    }
+    handle->sync->offset = offset;                                                                        /* set the offset */
+    handle->sync->reference = local;                                                                      /* set the reference */
+    handle->sync->samples++;                                                                              /* samples++ */
+}
+
+/**
+ * @brief     take a received time sync beacon
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to the beacon buffer
+ * @param[in] len beacon length
+ * @param[in] edge rx_dr edge time of the beacon
+ * @param[in] stamped edge belongs to the beacon
+ * @note      the beacon pairs the tx_ds time of the beacon before with its rx_dr time
+ */
+static void a_nrf24l01_sync_push(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len, uint32_t edge, uint8_t stamped)
+{
+    uint32_t master;
+    
+    if (len != NRF24L01_SYNC_BEACON_LENGTH)                                  /* check the beacon */
+    {
+        return;                                                              /* return */
+    }
+    if ((handle->sync->stamped != 0) && (buf[1] != 0) &&
+        ((uint8_t)(handle->sync->sequence + 1) == buf[0]))                   /* check the last beacon */
+    {
+        master = (uint32_t)buf[2] | ((uint32_t)buf[3] << 8) |
+                 ((uint32_t)buf[4] << 16) | ((uint32_t)buf[5] << 24);        /* get the last tx_ds time */
+        a_nrf24l01_sync_sample(handle, master, handle->sync->stamp);         /* add the sample */
+    }
+    handle->sync->sequence = buf[0];                                         /* set the sequence */
+    handle->sync->stamp = edge;                                              /* set the rx_dr time */
+    handle->sync->stamped = stamped;                                         /* set the stamp flag */
+}
+
+/**
+ * @brief     get the consumer of a received payload
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] ack ack role, 2 means the payload is an ack payload
+ * @param[in] pipe pipe number
+ * @return    consumer
+ *            - 0 rx queue or receive callback
+ *            - 1 ack handler
+ *            - 2 reassembly
+ *            - 3 pipe handler
+ *            - 4 none
+ *            - 5 mesh
+ *            - 6 time sync
+ * @note      without an ack handler an ack payload takes the normal receive path
+ */
+static uint8_t a_nrf24l01_rx_consumer(nrf24l01_handle_t *handle, uint8_t ack, uint8_t pipe)
+{
+    if ((ack == 2) && (handle->ack != NULL) && (handle->ack->callback != NULL))       /* ack payload */
+    {
+        return 1;                                                                     /* ack handler */
+    }
+    if (pipe > 5)                                                                     /* check pipe */
+    {
+        return 0;                                                                     /* rx queue or receive callback */
+    }
+    if ((handle->sync != NULL) && (handle->sync->role == NRF24L01_SYNC_ROLE_SLAVE) &&
+        (pipe == handle->sync->pipe))                                                 /* check time sync */
+    {
+        return 6;                                                                     /* time sync */
+    }
+    if ((handle->mesh != NULL) && (handle->mesh->enable != 0) && (pipe != 0))         /* check mesh */
+    {
+        return 5;                                                                     /* mesh */
+    }
+    if (handle->reassembly[pipe] != NULL)                                             /* check reassembly */
+    {
+        return 2;                                                                     /* reassembly */
+    }
+    if (handle->dispatch == NULL)                                                     /* check dispatch */
+    {
+        return 0;                                                                     /* rx queue or receive callback */
+    }
+    if (handle->dispatch->pipe[pipe].callback != NULL)                                /* check pipe handler */
+    {
+        return 3;                                                                     /* pipe handler */
+    }
+    if (handle->dispatch->discard != 0)                                               /* check discard */
+    {
+        return 4;                                                                     /* none */
+    }
+    
+    return 0;                                                                         /* rx queue or receive callback */
+}
+
+/**
+ * @brief     push a frame to the rx queue
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *frame pointer to the slot holding the payload, NULL drops the frame
+ * @param[in] pipe pipe number
+ * @param[in] len payload length
+ * @note      none
+ */
+static void a_nrf24l01_rx_queue_push(nrf24l01_handle_t *handle, nrf24l01_rx_frame_t *frame, uint8_t pipe, uint8_t len)
+{
+    if (frame == NULL)                                                                              /* check the slot */
+    {
+        handle->rx_queue->dropped++;                                                                /* dropped++ */
+        
+        return;                                                                                     /* return */
+    }
+    frame->timestamp = (handle->timestamp_us != NULL) ? handle->timestamp_us() : 0;                 /* set the timestamp */
+    frame->pipe = pipe;                                                                             /* set the pipe */
+    frame->len = len;                                                                               /* set the length */
+    NRF24L01_MEMORY_BARRIER();                                                                      /* write the frame before the index */
+    handle->rx_queue->head = (uint16_t)((handle->rx_queue->head + 1) % handle->rx_queue->depth);    /* publish the frame */
+}
+
+/**
+ * @brief     initialize the chip
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi initialization failed
+ *            - 2 handle is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 gpio init failed
+ * @note      none
+ */
+uint8_t nrf24l01_init(nrf24l01_handle_t *handle)
+{
+    if (handle == NULL)                                                      /* check handle */
+    {
+        return 2;                                                            /* return error */
+    }
+    if (handle->debug_print == NULL)                                         /* check debug_print */
+    {
+        return 3;                                                            /* return error */
+    }
+    if (handle->spi_init == NULL)                                            /* check spi_init */
+    {
+        handle->debug_print("nrf24l01: spi_init is null.\n");                /* spi_init is null */
+       
+        return 3;                                                            /* return error */
+    }
+    if (handle->spi_deinit == NULL)                                          /* check spi_deinit */
+    {
+        handle->debug_print("nrf24l01: spi_deinit is null.\n");              /* spi_deinit is null */
+       
+        return 3;                                                            /* return error */
+    }
+    if (handle->spi_read == NULL)                                            /* check spi_read */
+    {
+        handle->debug_print("nrf24l01: spi_read is null.\n");                /* spi_read is null */
+       
+        return 3;                                                            /* return error */
+    }
+    if (handle->spi_write == NULL)                                           /* check spi_write */
+    {
+        handle->debug_print("nrf24l01: spi_write is null.\n");               /* spi_write is null */
+       
+        return 3;                                                            /* return error */
+    }
+    if (handle->gpio_init == NULL)                                           /* check gpio_init */
+    {
+        handle->debug_print("nrf24l01: gpio_init is null.\n");               /* gpio_init is null */
+       
+        return 3;                                                            /* return error */
+    }
+    if (handle->gpio_deinit == NULL)                                         /* check gpio_deinit */
+    {
+        handle->debug_print("nrf24l01: gpio_deinit is null.\n");             /* gpio_deinit is null */
+       
+        return 3;                                                            /* return error */
+    }
+    if (handle->gpio_write == NULL)                                          /* check gpio_write */
+    {
+        handle->debug_print("nrf24l01: gpio_write is null.\n");              /* gpio_write is null */
+       
+        return 3;                                                            /* return error */
+    }
+    if (handle->delay_ms == NULL)                                            /* check delay_ms */
+    {
+        handle->debug_print("nrf24l01: delay_ms is null.\n");                /* delay_ms is null */
+       
+        return 3;                                                            /* return error */
+    }
+    if (handle->receive_callback == NULL)                                    /* check receive_callback */
+    {
+        handle->debug_print("nrf24l01: receive_callback is null.\n");        /* receive_callback is null */
+       
+        return 3;                                                            /* return error */
+    }
+    
+    if (handle->gpio_init(handle->user_data) != 0)                           /* gpio init */
+    {
+        handle->debug_print("nrf24l01: gpio init failed.\n");                /* gpio init failed */
+       
+        return 4;                                                            /* return error */
+    }
+    if (handle->spi_init(handle->user_data) != 0)                            /* spi init */
+    {
+        handle->debug_print("nrf24l01: spi init failed.\n");                 /* spi init failed */
+        (void)handle->gpio_deinit(handle->user_data);                        /* gpio deinit */
+        
+        return 1;                                                            /* return error */
+    }
+    
+    handle->shadow = NULL;                                                   /* disable the register shadow */
+    handle->rx_drain = 0;                                                    /* disable the rx drain */
+    handle->wire_order = 0;                                                  /* keep the legacy order */
+    handle->deadline_len = 0;                                                /* no cached send deadline */
+    handle->sending = 0;                                                     /* clear sending */
+    handle->send_callback = NULL;                                            /* clear the send callback */
+    handle->stream = NULL;                                                   /* disable the tx stream */
+    handle->tx_ring = NULL;                                                  /* disable the tx ring */
+    handle->rx_queue = NULL;                                                 /* disable the rx queue */
+    memset(handle->reassembly, 0, sizeof(handle->reassembly));               /* disable the reassembly */
+    handle->ack = NULL;                                                      /* disable the ack payload channel */
+    handle->tx_sequence = 0;                                                 /* no acknowledged send */
+    handle->dispatch = NULL;                                                 /* disable the dispatch table */
+    handle->tuner = NULL;                                                    /* disable the retransmit tuner */
+    handle->stats = NULL;                                                    /* stop the statistics */
+    handle->stats_sequence = 0;                                              /* no update running */
+    handle->tx_stats = NULL;                                                 /* disable the per tx address statistics */
+    handle->stats_detail = 0;                                                /* disable the detailed statistics */
+    handle->hopping = NULL;                                                  /* stop the hopping */
+    handle->hub = NULL;                                                      /* stop the hub */
+    handle->mesh = NULL;                                                     /* stop the mesh */
+    handle->sync = NULL;                                                     /* stop the time sync */
+    handle->tdma = NULL;                                                     /* stop the tdma slots */
+    handle->power = NULL;                                                    /* stop the power state tracking */
+    handle->inited = 1;                                                      /* flag finish initialization */
+    
+    return 0;                                                                /* success return 0 */
+}
+
+/**
+ * @brief     close the chip
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 nop failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 gpio deinit failed
+ *            - 5 spi deinit failed
+ * @note      none
+ */
+uint8_t nrf24l01_deinit(nrf24l01_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t prev;
+    
+    if (handle == NULL)                                                                 /* check handle */
+    {
+        return 2;                                                                       /* return error */
+    }
+    if (handle->inited != 1)                                                            /* check handle initialization */
+    {
+        return 3;                                                                       /* return error */
+    }
+    
+    res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_NOP, NULL, 0);              /* nop */
+    if (res != 0)                                                                       /* check result */
+    {
+        handle->debug_print("nrf24l01: nop failed.\n");                                 /* nop failed */
+       
+        return 1;                                                                       /* return error */
+    }
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_CONFIG, (uint8_t *)&prev, 1);        /* get config */
+    if (res != 0)                                                                       /* check result */
+    {
+        handle->debug_print("nrf24l01: get config failed.\n");                          /* get config failed */
+       
+        return 1;                                                                       /* return error */
+    }
+    prev &= ~(1 << 1);                                                                  /* clear config */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_CONFIG, (uint8_t *)&prev, 1);       /* set config */
+    if (res != 0)                                                                       /* check result */
+    {
+        handle->debug_print("nrf24l01: set config failed.\n");                          /* set config failed */
+       
+        return 1;                                                                       /* return error */
+    }
+    res = handle->gpio_deinit(handle->user_data);                                       /* gpio deinit */
+    if (res != 0)                                                                       /* check result */
+    {
+        handle->debug_print("nrf24l01: gpio deinit failed.\n");                         /* gpio deinit failed */
+       
+        return 4;                                                                       /* return error */
+    }
+    res = handle->spi_deinit(handle->user_data);                                        /* spi deinit */
+    if (res != 0)                                                                       /* check result */
+    {
+        handle->debug_print("nrf24l01: spi deinit failed.\n");                          /* spi deinit failed */
+       
+        return 5;                                                                       /* return error */
+    }
+    handle->inited = 0;                                                                 /* flag close */
+    
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable the chip
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set active failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      waits the 130 us settling time after enabling when delay_us is linked
+ */
+uint8_t nrf24l01_set_active(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
+{
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+    
+    if (handle->gpio_write(handle->user_data, enable) != 0)           /* gpio write */
+    {
+        handle->debug_print("nrf24l01: gpio write failed.\n");        /* gpio write failed */
+       
+        return 1;                                                     /* return error */
+    }
+    if (enable != 0)                                                  /* check enable */
+    {
+        a_nrf24l01_settle(handle);                                    /* wait the settling time */
+    }
+    
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief     send data
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is over 32
+ *            - 5 send deadline missed
+ * @note      polls every 20 us when delay_us is linked and every 1 ms otherwise, the deadline is
+ *            the worst case completion time of the current link settings plus a 1 ms margin, when
+ *            it passes the send is finished from a lost TX_DS or MAX_RT in the status register,
+ *            clearing only those flags, otherwise the tx fifo is flushed and the send status is
+ *            set to NRF24L01_SEND_STATUS_DEADLINE
+ */
+uint8_t nrf24l01_send(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len)
+{
+    uint8_t res;
+    uint8_t timeout;
+    uint8_t status;
+    uint32_t deadline;
+    uint32_t t;
+    
+    res = nrf24l01_get_send_deadline(handle, len, &deadline);                                 /* get the send deadline */
+    if (res != 0)                                                                             /* check result */
+    {
+        return res;                                                                           /* return error */
+    }
+    res = nrf24l01_send_async(handle, buf, len, NULL, NULL);                                  /* send data */
+    if (res == 5)                                                                             /* check busy */
+    {
+        return 1;                                                                             /* return error */
+    }
+    else if (res != 0)                                                                        /* check result */
+    {
+        return res;                                                                           /* return error */
+    }
+    else
+    {
+        /* do nothing */
+    }
+    deadline += NRF24L01_DEADLINE_MARGIN_US;                                                  /* add the margin */
+    timeout = 0;                                                                              /* init 0 */
+    a_nrf24l01_poll_start(handle, &t);                                                        /* start the wait */
+    while ((timeout == 0) && (handle->finished == 0))                                         /* wait time */
+    {
+        timeout = a_nrf24l01_poll(handle, &t, deadline);                                      /* poll until the deadline */
+    }
+    if (handle->finished == 0)                                                                /* check deadline */
+    {
+        res = a_nrf24l01_spi_read(handle, NRF24L01_REG_STATUS, &status, 1);                   /* get status register */
+        if (res != 0)                                                                         /* check result */
+        {
+            handle->sending = 0;                                                              /* give up the send */
+            handle->debug_print("nrf24l01: get status register failed.\n");                   /* get status register failed */
+           
+            return 1;                                                                         /* return error */
+        }
+        status &= (1 << 5) | (1 << 4);                                                        /* keep the tx flags */
+        if (status != 0)                                                                      /* check a lost interrupt */
+        {
+            res = a_nrf24l01_spi_write(handle, NRF24L01_REG_STATUS, &status, 1);              /* clear only the tx flags */
+            if (res != 0)                                                                     /* check result */
+            {
+                handle->sending = 0;                                                          /* give up the send */
+                handle->debug_print("nrf24l01: set status register failed.\n");               /* set status register failed */
+               
+                return 1;                                                                     /* return error */
+            }
+        }
+        if (((status >> 4) & 0x01) != 0)                                                      /* lost max rt */
+        {
+            res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_TX, NULL, 0);       /* flush tx */
+            if (res != 0)                                                                     /* check result */
+            {
+                handle->sending = 0;                                                          /* give up the send */
+                handle->debug_print("nrf24l01: flush tx failed.\n");                          /* flush tx failed */
+               
+                return 1;                                                                     /* return error */
+            }
+            if (a_nrf24l01_send_done(handle, NRF24L01_SEND_STATUS_MAX_RT) != 0)               /* finish the send unless the irq did */
+            {
+                a_nrf24l01_stats_tx(handle, 2, 0);                                            /* max_rt++ */
+            }
+        }
+        else if (status != 0)                                                                 /* lost tx_ds */
+        {
+            if (a_nrf24l01_send_done(handle, NRF24L01_SEND_STATUS_OK) != 0)                   /* finish the send unless the irq did */
+            {
+                a_nrf24l01_stats_tx(handle, 1, 0);                                            /* tx_ds++ */
+                handle->tx_sequence++;                                                        /* sequence++ */
+            }
+        }
+        else
+        {
+            /* do nothing */
+        }
+    }
+    if (handle->finished == 0)                                                                /* check deadline */
+    {
+        res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_TX, NULL, 0);           /* flush tx */
+        if (res != 0)                                                                         /* check result */
+        {
+            handle->sending = 0;                                                              /* give up the send */
+            handle->debug_print("nrf24l01: flush tx failed.\n");                              /* flush tx failed */
+           
+            return 1;                                                                         /* return error */
+        }
+        (void)a_nrf24l01_send_done(handle, NRF24L01_SEND_STATUS_DEADLINE);                    /* give up the send */
+        handle->debug_print("nrf24l01: send deadline missed.\n");                             /* send deadline missed */
+       
+        return 5;                                                                             /* return error */
+    }
+    if (handle->finished == 1)                                                                /* check finished */
+    {
+        return 0;                                                                             /* success return 0 */
+    }
+    else
+    {
+        handle->debug_print("nrf24l01: send failed.\n");                                      /* send failed */
+       
+        return 1;                                                                             /* return error */
+    }
+}
+
+/**
+ * @brief     send data without waiting
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len buffer length
+ * @param[in] *callback pointer to a completion callback, it can be NULL
+ * @param[in] *param pointer to the callback parameter
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is over 32
+ *            - 5 send is busy
+ * @note      the completion is reported by the irq handler through the callback
+ *            and can be polled with nrf24l01_get_send_status
+ */
+uint8_t nrf24l01_send_async(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len,
+                            void (*callback)(nrf24l01_send_status_t status, void *param), void *param)
+{
+    if (handle == NULL)                                                                    /* check handle */
+    {
+        return 2;                                                                          /* return error */
+    }
+    if (handle->inited != 1)                                                               /* check handle initialization */
+    {
+        return 3;                                                                          /* return error */
+    }
+    if (len > 32)                                                                          /* check the result */
+    {
+        handle->debug_print("nrf24l01: len is over 32.\n");                                /* len is over 32 */
+       
+        return 4;                                                                          /* return error */
+    }
+
+    return a_nrf24l01_send_start(handle, NRF24L01_COMMAND_W_TX_PAYLOAD,
+                                 buf, len, callback, param);                               /* start the send */
+}
+
+/**
+ * @brief      get the status of the last send
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *status pointer to a send status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_send_status(nrf24l01_handle_t *handle, nrf24l01_send_status_t *status)
+{
+    if (handle == NULL)                                         /* check handle */
+    {
+        return 2;                                               /* return error */
+    }
+    if (handle->inited != 1)                                    /* check handle initialization */
+    {
+        return 3;                                               /* return error */
+    }
+    
+    *status = (nrf24l01_send_status_t)(handle->finished);       /* get status */
+    
+    return 0;                                                   /* success return 0 */
+}
+
+/**
+ * @brief      calculate the air time of a frame
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  rate data rate
+ * @param[in]  width address width
+ * @param[in]  crc crc length in bytes
+ * @param[in]  len payload length
+ * @param[out] *us pointer to an air time buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 param is invalid
+ * @note       the air time covers the preamble, the address, the packet control field, the payload
+ *             and the crc, crc <= 2 and len <= 32
+ */
+uint8_t nrf24l01_calculate_air_time(nrf24l01_handle_t *handle, nrf24l01_data_rate_t rate,
+                                    nrf24l01_address_width_t width, uint8_t crc, uint8_t len, uint32_t *us)
+{
+    uint32_t bits;
+    uint32_t kbps;
+    
+    if (handle == NULL)                                                             /* check handle */
+    {
+        return 2;                                                                   /* return error */
+    }
+    if (handle->inited != 1)                                                        /* check handle initialization */
+    {
+        return 3;                                                                   /* return error */
+    }
+    if ((width < NRF24L01_ADDRESS_WIDTH_3_BYTES) || (width > NRF24L01_ADDRESS_WIDTH_5_BYTES) ||
+        (crc > 2) || (len > 32))                                                    /* check param */
+    {
+        handle->debug_print("nrf24l01: param is invalid.\n");                       /* param is invalid */
+       
+        return 4;                                                                   /* return error */
+    }
+    if (rate == NRF24L01_DATA_RATE_1M)                                              /* 1 Mbps */
+    {
+        kbps = 1000;                                                                /* set 1000 kbps */
+    }
+    else if (rate == NRF24L01_DATA_RATE_2M)                                         /* 2 Mbps */
+    {
+        kbps = 2000;                                                                /* set 2000 kbps */
+    }
+    else if (rate == NRF24L01_DATA_RATE_250K)                                       /* 250 Kbps */
+    {
+        kbps = 250;                                                                 /* set 250 kbps */
+    }
+    else
+    {
+        handle->debug_print("nrf24l01: param is invalid.\n");                       /* param is invalid */
+       
+        return 4;                                                                   /* return error */
+    }
+    
+    bits = 8 * (1 + (uint32_t)width + 2 + (uint32_t)len + (uint32_t)crc) + 9;       /* preamble, address, payload, crc and pcf */
+    *us = (bits * 1000 + kbps - 1) / kbps;                                          /* round up to us */
+    
+    return 0;                                                                       /* success return 0 */
+}
+
+/**
+ * @brief      get the worst case completion time of a send
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  len payload length
+ * @param[out] *us pointer to a completion time buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get send deadline failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 len is over 32
+ * @note       every attempt is counted as the 130 us settling time, the frame air time and the full
+ *             auto retransmit delay, the attempts are the auto retransmit count plus one, the
+ *             result of the last length is cached until CONFIG, EN_AA, SETUP_AW, SETUP_RETR or
+ *             RF_SETUP is written
+ */
+uint8_t nrf24l01_get_send_deadline(nrf24l01_handle_t *handle, uint8_t len, uint32_t *us)
+{
+    uint8_t res;
+    uint8_t config;
+    uint8_t en_aa;
+    uint8_t aw;
+    uint8_t retr;
+    uint8_t setup;
+    uint8_t crc;
+    uint32_t frame;
+    nrf24l01_data_rate_t rate;
+    
+    if (handle == NULL)                                                                                    /* check handle */
+    {
+        return 2;                                                                                          /* return error */
+    }
+    if (handle->inited != 1)                                                                               /* check handle initialization */
+    {
+        return 3;                                                                                          /* return error */
+    }
+    if (len > 32)                                                                                          /* check length */
+    {
+        handle->debug_print("nrf24l01: len is over 32.\n");                                                /* len is over 32 */
+       
+        return 4;                                                                                          /* return error */
+    }
+    if (handle->deadline_len == (uint8_t)(len + 1))                                                        /* check the cached deadline */
+    {
+        *us = handle->deadline_us;                                                                         /* get the cached deadline */
+        
+        return 0;                                                                                          /* success return 0 */
+    }
+    
+    handle->deadline_len = 0xFF;                                                                           /* mark the computing */
+    NRF24L01_MEMORY_BARRIER();                                                                             /* mark before reading */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_CONFIG, &config, 1);                                    /* get config */
+    res |= a_nrf24l01_spi_read(handle, NRF24L01_REG_EN_AA, &en_aa, 1);                                     /* get enable auto acknowledgment */
+    res |= a_nrf24l01_spi_read(handle, NRF24L01_REG_SETUP_AW, &aw, 1);                                     /* get setup of address widths */
+    res |= a_nrf24l01_spi_read(handle, NRF24L01_REG_SETUP_RETR, &retr, 1);                                 /* get setup of automatic retransmission */
+    res |= a_nrf24l01_spi_read(handle, NRF24L01_REG_RF_SETUP, &setup, 1);                                  /* get rf setup register */
+    if (res != 0)                                                                                          /* check result */
+    {
+        handle->debug_print("nrf24l01: get send deadline failed.\n");                                      /* get send deadline failed */
+       
+        return 1;                                                                                          /* return error */
+    }
+    crc = 0;                                                                                               /* init 0 */
+    if (((config >> 3) & 0x01) != 0)                                                                       /* check crc */
+    {
+        crc = (uint8_t)(((config >> 2) & 0x01) + 1);                                                       /* 1 or 2 bytes */
+    }
+    if ((crc == 0) && ((en_aa & 0x3F) != 0))                                                               /* auto acknowledgment forces crc */
+    {
+        crc = 1;                                                                                           /* 1 byte */
+    }
+    aw &= 0x03;                                                                                            /* get address width */
+    if (aw == 0)                                                                                           /* check illegal width */
+    {
+        aw = NRF24L01_ADDRESS_WIDTH_5_BYTES;                                                               /* assume the longest */
+    }
+    rate = (nrf24l01_data_rate_t)(((setup >> 3) & 0x01) | ((setup >> 5) & 0x01) << 1);                     /* get rate */
+    res = nrf24l01_calculate_air_time(handle, rate, (nrf24l01_address_width_t)aw, crc, len, &frame);       /* get the frame air time */
+    if (res != 0)                                                                                          /* check result */
+    {
+        handle->debug_print("nrf24l01: get send deadline failed.\n");                                      /* get send deadline failed */
+       
+        return 1;                                                                                          /* return error */
+    }
+    *us = (uint32_t)((retr & 0x0F) + 1) * (NRF24L01_SETTLE_US + frame +
+                                           (uint32_t)(((retr >> 4) & 0x0F) + 1) * 250);                    /* attempts of settling, frame and ack wait */
+    handle->deadline_us = *us;                                                                             /* cache the deadline */
+    NRF24L01_MEMORY_BARRIER();                                                                             /* cache before marking */
+    if (handle->deadline_len == 0xFF)                                                                      /* no register written meanwhile */
+    {
+        handle->deadline_len = (uint8_t)(len + 1);                                                         /* mark the cached length */
+    }
+    
+    return 0;                                                                                              /* success return 0 */
+}
+
+/**
+ * @brief      initialize a retransmit tuner
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *tuner pointer to a caller allocated tuner, one per destination address
+ * @param[in]  delay_min min auto retransmit delay register value
+ * @param[in]  delay_max max auto retransmit delay register value
+ * @param[in]  count_min min auto retransmit count
+ * @param[in]  count_max max auto retransmit count
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 bounds are invalid
+ * @note       the bounds are register values <= 0xF, the tuner starts from the max delay and count
+ */
+uint8_t nrf24l01_retransmit_tuner_init(nrf24l01_handle_t *handle, nrf24l01_retransmit_tuner_t *tuner,
+                                       uint8_t delay_min, uint8_t delay_max, uint8_t count_min, uint8_t count_max)
+{
+    if (handle == NULL)                                                                                     /* check handle */
+    {
+        return 2;                                                                                           /* return error */
+    }
+    if (handle->inited != 1)                                                                                /* check handle initialization */
+    {
+        return 3;                                                                                           /* return error */
+    }
+    if ((delay_max > 0xF) || (count_max > 0xF) || (delay_min > delay_max) || (count_min > count_max))       /* check bounds */
+    {
+        handle->debug_print("nrf24l01: bounds are invalid.\n");                                             /* bounds are invalid */
+       
+        return 4;                                                                                           /* return error */
+    }
+    
+    memset(tuner, 0, sizeof(nrf24l01_retransmit_tuner_t));                                                  /* clear the tuner */
+    tuner->delay_min = delay_min;                                                                           /* set min delay */
+    tuner->delay_max = delay_max;                                                                           /* set max delay */
+    tuner->count_min = count_min;                                                                           /* set min count */
+    tuner->count_max = count_max;                                                                           /* set max count */
+    tuner->delay = delay_max;                                                                               /* start from the max delay */
+    tuner->count = count_max;                                                                               /* start from the max count */
+    
+    return 0;                                                                                               /* success return 0 */
+}
+
+/**
+ * @brief     set the active retransmit tuner
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *tuner pointer to an initialized tuner, NULL stops the tuning
+ * @return    status code
+ *            - 0 success
+ *            - 1 set retransmit tuner failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it with the tuner of the destination whenever the tx address changes, the tuner
+ *            delay and count are written to the chip, the irq handler samples the observe tx
+ *            register after every tx data sent or max retransmit interrupt, widens the delay and
+ *            count after a loss or a send that needed every retransmit, widens the delay when the
+ *            average retransmits stay high and narrows the delay and then the count after a run of
+ *            first attempt deliveries
+ */
+uint8_t nrf24l01_set_retransmit_tuner(nrf24l01_handle_t *handle, nrf24l01_retransmit_tuner_t *tuner)
+{
+    uint8_t res;
+    uint8_t prev;
+    
+    if (handle == NULL)                                                                     /* check handle */
+    {
+        return 2;                                                                           /* return error */
+    }
+    if (handle->inited != 1)                                                                /* check handle initialization */
+    {
+        return 3;                                                                           /* return error */
+    }
+    
+    handle->tuner = NULL;                                                                   /* stop the irq sampling */
+    if (tuner == NULL)                                                                      /* check tuner */
+    {
+        return 0;                                                                           /* success return 0 */
+    }
+    prev = (uint8_t)((tuner->delay << 4) | tuner->count);                                   /* set delay and count */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_SETUP_RETR, (uint8_t *)&prev, 1);       /* set setup of automatic retransmission */
+    if (res != 0)                                                                           /* check result */
+    {
+        handle->debug_print("nrf24l01: set retransmit tuner failed.\n");                    /* set retransmit tuner failed */
+       
+        return 1;                                                                           /* return error */
+    }
+    NRF24L01_MEMORY_BARRIER();                                                              /* write the register before the tuner */
+    handle->tuner = tuner;                                                                  /* set the tuner */
+    
+    return 0;                                                                               /* success return 0 */
+}
+
+/**
+ * @brief      get the retransmit tuner status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  *tuner pointer to an initialized tuner
+ * @param[out] *delay pointer to a current delay register value buffer
+ * @param[out] *count pointer to a current count buffer
+ * @param[out] *sent pointer to a sampled send counter buffer
+ * @param[out] *lost pointer to a lost send counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_retransmit_tuner_status(nrf24l01_handle_t *handle, nrf24l01_retransmit_tuner_t *tuner,
+                                             uint8_t *delay, uint8_t *count, uint32_t *sent, uint32_t *lost)
+{
+    if (handle == NULL)            /* check handle */
+    {
+        return 2;                  /* return error */
+    }
+    if (handle->inited != 1)       /* check handle initialization */
+    {
+        return 3;                  /* return error */
+    }
+    
+    *delay = tuner->delay;         /* get delay */
+    *count = tuner->count;         /* get count */
+    *sent = tuner->sent;           /* get sent */
+    *lost = tuner->lost;           /* get lost */
+    
+    return 0;                      /* success return 0 */
+}
+
+/**
+ * @brief      get the statistics
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *stats pointer to a statistics buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 statistics are busy
+ *             - 5 statistics are not set
+ * @note       the copy is repeated while the statistics sequence is odd or changes during the
+ *             copy so it is consistent even when the irq handler updates the counters meanwhile
+ */
+uint8_t nrf24l01_get_stats(nrf24l01_handle_t *handle, nrf24l01_stats_t *stats)
+{
+    uint8_t i;
+    uint32_t sequence;
+    
+    if (handle == NULL)                                                         /* check handle */
+    {
+        return 2;                                                               /* return error */
+    }
+    if (handle->inited != 1)                                                    /* check handle initialization */
+    {
+        return 3;                                                               /* return error */
+    }
+    if (handle->stats == NULL)                                                  /* check the statistics */
+    {
+        handle->debug_print("nrf24l01: statistics are not set.\n");             /* statistics are not set */
+        
+        return 5;                                                               /* return error */
+    }
+    
+    for (i = 0; i < 8; i++)                                                     /* retry 8 times */
+    {
+        sequence = handle->stats_sequence;                                      /* get the sequence */
+        NRF24L01_MEMORY_BARRIER();                                              /* sequence before the counters */
+        memcpy(stats, handle->stats, sizeof(nrf24l01_stats_t));                 /* copy the statistics */
+        NRF24L01_MEMORY_BARRIER();                                              /* counters before the sequence */
+        if (((sequence & 0x01) == 0) && (sequence == handle->stats_sequence))   /* check no update ran */
+        {
+            return 0;                                                           /* success return 0 */
+        }
+    }
+    handle->debug_print("nrf24l01: statistics are busy.\n");                    /* statistics are busy */
+    
+    return 4;                                                                   /* return error */
+}
+
+/**
+ * @brief     clear the statistics
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 statistics are not set
+ * @note      the per tx address statistics are owned by the caller and are not cleared
+ */
+uint8_t nrf24l01_clear_stats(nrf24l01_handle_t *handle)
+{
+    if (handle == NULL)                                                   /* check handle */
+    {
+        return 2;                                                         /* return error */
+    }
+    if (handle->inited != 1)                                              /* check handle initialization */
+    {
+        return 3;                                                         /* return error */
+    }
+    if (handle->stats == NULL)                                            /* check the statistics */
+    {
+        handle->debug_print("nrf24l01: statistics are not set.\n");       /* statistics are not set */
+        
+        return 4;                                                         /* return error */
+    }
+    
+    handle->stats_sequence++;                                             /* start the update */
+    NRF24L01_MEMORY_BARRIER();                                            /* sequence before the counters */
+    memset(handle->stats, 0, sizeof(nrf24l01_stats_t));                   /* clear the statistics */
+    NRF24L01_MEMORY_BARRIER();                                            /* counters before the sequence */
+    handle->stats_sequence++;                                             /* finish the update */
+    
+    return 0;                                                             /* success return 0 */
+}
+
+/**
+ * @brief     set the statistics
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *stats pointer to a caller allocated statistics block, NULL stops the counting
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the block is cleared before the counting starts
+ */
+uint8_t nrf24l01_set_stats(nrf24l01_handle_t *handle, nrf24l01_stats_t *stats)
+{
+    if (handle == NULL)                               /* check handle */
+    {
+        return 2;                                     /* return error */
+    }
+    if (handle->inited != 1)                          /* check handle initialization */
+    {
+        return 3;                                     /* return error */
+    }
+    
+    handle->stats = NULL;                             /* stop the counting */
+    if (stats == NULL)                                /* check stats */
+    {
+        return 0;                                     /* success return 0 */
+    }
+    memset(stats, 0, sizeof(nrf24l01_stats_t));       /* clear the statistics */
+    NRF24L01_MEMORY_BARRIER();                        /* clear before the publish */
+    handle->stats = stats;                            /* set the statistics */
+    
+    return 0;                                         /* success return 0 */
+}
+
+/**
+ * @brief     set the per tx address statistics
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *stats pointer to a caller allocated tx statistics block, NULL stops the counting
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it with the block of the destination whenever the tx address changes, the tx
+ *            counters are updated in the block and in the statistics block
+ */
+uint8_t nrf24l01_set_tx_stats(nrf24l01_handle_t *handle, nrf24l01_tx_stats_t *stats)
+{
+    if (handle == NULL)             /* check handle */
+    {
+        return 2;                   /* return error */
+    }
+    if (handle->inited != 1)        /* check handle initialization */
+    {
+        return 3;                   /* return error */
+    }
+    
+    handle->tx_stats = stats;       /* set the per tx address statistics */
+    
+    return 0;                       /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable the detailed statistics
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the detailed statistics cost one observe tx read per tx interrupt for the retransmit
+ *            histogram and one fifo status read per rx interrupt for the rx fifo full events, the
+ *            histogram is also filled while a retransmit tuner is active
+ */
+uint8_t nrf24l01_set_stats_detail(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
+{
+    if (handle == NULL)                           /* check handle */
+    {
+        return 2;                                 /* return error */
+    }
+    if (handle->inited != 1)                      /* check handle initialization */
+    {
+        return 3;                                 /* return error */
+    }
+    
+    handle->stats_detail = (uint8_t)enable;       /* set detail */
+    
+    return 0;                                     /* success return 0 */
+}
+
+/**
+ * @brief      get the detailed statistics status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_stats_detail(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
+{
+    if (handle == NULL)                                      /* check handle */
+    {
+        return 2;                                            /* return error */
+    }
+    if (handle->inited != 1)                                 /* check handle initialization */
+    {
+        return 3;                                            /* return error */
+    }
+    
+    *enable = (nrf24l01_bool_t)(handle->stats_detail);       /* get detail */
+    
+    return 0;                                                /* success return 0 */
+}
+
+/**
+ * @brief     set the tx stream
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *stream pointer to a caller allocated tx stream, NULL disables the stream
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 send is busy
+ * @note      the stream carries nrf24l01_send_stream and nrf24l01_send_message
+ */
+uint8_t nrf24l01_set_stream(nrf24l01_handle_t *handle, nrf24l01_stream_t *stream)
+{
+    if (handle == NULL)                                         /* check handle */
+    {
+        return 2;                                               /* return error */
+    }
+    if (handle->inited != 1)                                    /* check handle initialization */
+    {
+        return 3;                                               /* return error */
+    }
+    if (handle->sending != 0)                                   /* check sending */
+    {
+        handle->debug_print("nrf24l01: send is busy.\n");       /* send is busy */
+       
+        return 4;                                               /* return error */
+    }
+    
+    handle->stream = NULL;                                      /* stop the stream */
+    if (stream == NULL)                                         /* check stream */
+    {
+        return 0;                                               /* success return 0 */
+    }
+    memset(stream, 0, sizeof(nrf24l01_stream_t));               /* clear the stream */
+    NRF24L01_MEMORY_BARRIER();                                  /* clear before the publish */
+    handle->stream = stream;                                    /* set the stream */
+    
+    return 0;                                                   /* success return 0 */
+}
+
+/**
+ * @brief      send a stream of payloads without waiting
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  *buf pointer to num payloads of len bytes
+ * @param[in]  len payload length
+ * @param[in]  num payload number
+ * @param[out] *result pointer to a per payload result buffer of num entries
+ * @param[in]  *callback pointer to a completion callback, it can be NULL
+ * @param[in]  *param pointer to the callback parameter
+ * @return     status code
+ *             - 0 success
+ *             - 1 send stream failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 len is invalid
+ *             - 5 send is busy
+ *             - 6 num is 0
+ *             - 7 stream is not set
+ * @note       buf and result must stay valid until the callback runs, ce stays high and the
+ *             irq handler keeps 2 payloads in flight, the callback gets
+ *             NRF24L01_SEND_STATUS_MAX_RT if any payload failed
+ */
+uint8_t nrf24l01_send_stream(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len, uint16_t num,
+                             nrf24l01_send_status_t *result,
+                             void (*callback)(nrf24l01_send_status_t status, void *param), void *param)
+{
+    uint16_t i;
+    
+    if (handle == NULL)                                                  /* check handle */
+    {
+        return 2;                                                        /* return error */
+    }
+    if (handle->inited != 1)                                             /* check handle initialization */
+    {
+        return 3;                                                        /* return error */
+    }
+    if ((len == 0) || (len > 32))                                        /* check the length */
+    {
+        handle->debug_print("nrf24l01: len is invalid.\n");              /* len is invalid */
+       
+        return 4;                                                        /* return error */
+    }
+    if (num == 0)                                                        /* check the number */
+    {
+        handle->debug_print("nrf24l01: num is 0.\n");                    /* num is 0 */
+       
+        return 6;                                                        /* return error */
+    }
+    if (handle->stream == NULL)                                          /* check the stream */
+    {
+        handle->debug_print("nrf24l01: stream is not set.\n");           /* stream is not set */
+       
+        return 7;                                                        /* return error */
+    }
+    if (NRF24L01_CLAIM(handle->sending) == 0)                            /* claim the radio */
+    {
+        handle->debug_print("nrf24l01: send is busy.\n");                /* send is busy */
+       
+        return 5;                                                        /* return error */
+    }
+    
+    for (i = 0; i < num; i++)                                            /* run num times */
+    {
+        result[i] = NRF24L01_SEND_STATUS_PENDING;                        /* set pending */
+    }
+    handle->stream->buf = buf;                                           /* set the buffer */
+    handle->stream->len = len;                                           /* set the length */
+    handle->stream->num = num;                                           /* set the number */
+    handle->stream->result = result;                                     /* set the result */
+    handle->stream->loaded = 0;                                          /* clear loaded */
+    handle->stream->done = 0;                                            /* clear done */
+    handle->stream->failed = 0;                                          /* clear failed */
+    handle->stream->fragment = 0;                                        /* not a fragment stream */
+    handle->send_callback = callback;                                    /* set the callback */
+    handle->send_param = param;                                          /* set the callback parameter */
+    handle->finished = 0;                                                /* clear finished */
+    if (handle->gpio_write(handle->user_data, 0) != 0)                   /* gpio write */
+    {
+        handle->sending = 0;                                             /* clear sending */
+        handle->debug_print("nrf24l01: gpio write failed.\n");           /* gpio write failed */
+       
+        return 1;                                                        /* return error */
+    }
+    if (a_nrf24l01_stream_fill(handle) != 0)                             /* load the tx fifo */
+    {
+        handle->sending = 0;                                             /* clear sending */
+        handle->debug_print("nrf24l01: set tx payload failed.\n");       /* set tx payload failed */
+       
+        return 1;                                                        /* return error */
+    }
+    handle->stream->enable = 1;                                          /* start the stream */
+    if (handle->gpio_write(handle->user_data, 1) != 0)                   /* gpio write */
+    {
+        handle->stream->enable = 0;                                      /* stop the stream */
+        handle->sending = 0;                                             /* clear sending */
+        handle->debug_print("nrf24l01: gpio write failed.\n");           /* gpio write failed */
+       
+        return 1;                                                        /* return error */
+    }
+    
+    return 0;                                                            /* success return 0 */
+}
+
+/**
+ * @brief     set the tx ring
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *ring pointer to a caller allocated tx ring, NULL disables the ring
+ * @param[in] *frame pointer to a caller allocated frame buffer, NULL disables the ring
+ * @param[in] depth frame buffer depth
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 depth is invalid
+ *            - 5 send is busy
+ * @note      the ring holds depth - 1 frames
+ */
+uint8_t nrf24l01_set_tx_ring(nrf24l01_handle_t *handle, nrf24l01_tx_ring_t *ring, nrf24l01_tx_frame_t *frame, uint16_t depth)
+{
+    if (handle == NULL)                                             /* check handle */
+    {
+        return 2;                                                   /* return error */
+    }
+    if (handle->inited != 1)                                        /* check handle initialization */
+    {
+        return 3;                                                   /* return error */
+    }
+    if ((ring != NULL) && (frame != NULL) && (depth < 2))           /* check the depth */
+    {
+        handle->debug_print("nrf24l01: depth is invalid.\n");       /* depth is invalid */
+       
+        return 4;                                                   /* return error */
+    }
+    if (handle->sending != 0)                                       /* check sending */
+    {
+        handle->debug_print("nrf24l01: send is busy.\n");           /* send is busy */
+       
+        return 5;                                                   /* return error */
+    }
+    
+    handle->tx_ring = NULL;                                         /* stop the ring */
+    if ((ring == NULL) || (frame == NULL))                          /* check the ring */
+    {
+        return 0;                                                   /* success return 0 */
+    }
+    ring->frame = frame;                                            /* set the frame buffer */
+    ring->depth = depth;                                            /* set the depth */
+    ring->head = 0;                                                 /* clear head */
+    ring->load = 0;                                                 /* clear load */
+    ring->tail = 0;                                                 /* clear tail */
+    ring->sent = 0;                                                 /* clear sent */
+    ring->failed = 0;                                               /* clear failed */
+    NRF24L01_MEMORY_BARRIER();                                      /* clear before the publish */
+    handle->tx_ring = ring;                                         /* set the ring */
+    
+    return 0;                                                       /* success return 0 */
+}
+
+/**
+ * @brief     write a frame to the tx ring
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is invalid
+ *            - 5 tx ring is not set
+ *            - 6 tx ring is full
+ * @note      when the radio is idle the tx fifo is loaded at once, otherwise the irq
+ *            handler loads the frame after the next TX_DS or MAX_RT, a load failure keeps the
+ *            frame queued and releases the radio for the next write
+ */
+uint8_t nrf24l01_tx_ring_write(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len)
+{
+    uint8_t i;
+    uint16_t next;
+    nrf24l01_tx_frame_t *frame;
+    
+    if (handle == NULL)                                                                   /* check handle */
+    {
+        return 2;                                                                         /* return error */
+    }
+    if (handle->inited != 1)                                                              /* check handle initialization */
+    {
+        return 3;                                                                         /* return error */
+    }
+    if ((len == 0) || (len > 32))                                                         /* check the length */
+    {
+        handle->debug_print("nrf24l01: len is invalid.\n");                               /* len is invalid */
+       
+        return 4;                                                                         /* return error */
+    }
+    if (handle->tx_ring == NULL)                                                          /* check the ring */
+    {
+        handle->debug_print("nrf24l01: tx ring is not set.\n");                           /* tx ring is not set */
+       
+        return 5;                                                                         /* return error */
+    }
+    next = (uint16_t)((handle->tx_ring->head + 1) % handle->tx_ring->depth);              /* get the next index */
+    if (next == handle->tx_ring->tail)                                                    /* check full */
+    {
+        return 6;                                                                         /* return error */
+    }
+    
+    frame = &handle->tx_ring->frame[handle->tx_ring->head];                               /* get the frame */
+    if (handle->wire_order != 0)                                                          /* wire order */
+    {
+        memcpy(frame->buf, buf, len);                                                     /* copy data */
+    }
+    else
+    {
+        for (i = 0; i < len; i++)                                                         /* run len times */
+        {
+            frame->buf[i] = buf[len - 1 - i];                                             /* copy reversed */
+        }
+    }
+    frame->len = len;                                                                     /* set the length */
+    NRF24L01_MEMORY_BARRIER();                                                            /* write the frame before the index */
+    handle->tx_ring->head = next;                                                         /* publish the frame */
+    NRF24L01_MEMORY_BARRIER();                                                            /* publish the index before the claim */
+    if (NRF24L01_CLAIM(handle->sending) == 0)                                             /* claim the radio */
+    {
+        return 0;                                                                         /* the sender in flight loads it */
+    }
+    
+    handle->finished = 0;                                                                 /* clear finished */
+    handle->send_callback = NULL;                                                         /* clear the callback */
+    if (handle->gpio_write(handle->user_data, 0) != 0)                                    /* gpio write */
+    {
+        (void)NRF24L01_RELEASE(handle->sending);                                          /* release the radio */
+        handle->debug_print("nrf24l01: gpio write failed.\n");                            /* gpio write failed */
+       
+        return 1;                                                                         /* return error */
+    }
+    if (a_nrf24l01_tx_ring_fill(handle) != 0)                                             /* load the tx fifo */
+    {
+        (void)a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_TX, NULL, 0);       /* flush tx */
+        handle->tx_ring->load = handle->tx_ring->tail;                                    /* load the flushed frames again */
+        (void)NRF24L01_RELEASE(handle->sending);                                          /* release the radio */
+        (void)handle->gpio_write(handle->user_data, 1);                                   /* set gpio */
+        handle->debug_print("nrf24l01: set tx payload failed.\n");                        /* set tx payload failed */
+       
+        return 1;                                                                         /* return error */
+    }
+    if (handle->tx_ring->load == handle->tx_ring->tail)                                   /* nothing is loaded */
+    {
+        (void)a_nrf24l01_send_done(handle, NRF24L01_SEND_STATUS_HELD);                    /* wait for the next slot */
+    }
+    if (handle->gpio_write(handle->user_data, 1) != 0)                                    /* gpio write */
+    {
+        (void)a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_TX, NULL, 0);       /* flush tx */
+        handle->tx_ring->load = handle->tx_ring->tail;                                    /* load the flushed frames again */
+        (void)NRF24L01_RELEASE(handle->sending);                                          /* release the radio */
+        handle->debug_print("nrf24l01: gpio write failed.\n");                            /* gpio write failed */
+       
+        return 1;                                                                         /* return error */
+    }
+    
+    return 0;                                                                             /* success return 0 */
+}
+
+/**
+ * @brief      get the tx ring status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *pending pointer to a pending frame number buffer
+ * @param[out] *sent pointer to a sent frame counter buffer
+ * @param[out] *failed pointer to a failed frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 tx ring is not set
+ * @note       none
+ */
+uint8_t nrf24l01_get_tx_ring_status(nrf24l01_handle_t *handle, uint16_t *pending, uint32_t *sent, uint32_t *failed)
+{
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+    if (handle->tx_ring == NULL)                                      /* check the ring */
+    {
+        handle->debug_print("nrf24l01: tx ring is not set.\n");       /* tx ring is not set */
+       
+        return 4;                                                     /* return error */
+    }
+    
+    *pending = (uint16_t)((handle->tx_ring->head + handle->tx_ring->depth - handle->tx_ring->tail) %
+                          handle->tx_ring->depth);                    /* get pending */
+    *sent = handle->tx_ring->sent;                                    /* get sent */
+    *failed = handle->tx_ring->failed;                                /* get failed */
+    
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief     set the rx queue
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *queue pointer to a caller allocated rx queue, NULL disables the queue
+ * @param[in] *frame pointer to a caller allocated frame buffer, NULL disables the queue
+ * @param[in] depth frame buffer depth
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 depth is invalid
+ * @note      the queue holds depth - 1 frames, when it is set the irq handler pushes
+ *            the received frames into it instead of running the receive callback
+ */
+uint8_t nrf24l01_set_rx_queue(nrf24l01_handle_t *handle, nrf24l01_rx_queue_t *queue, nrf24l01_rx_frame_t *frame, uint16_t depth)
+{
+    if (handle == NULL)                                             /* check handle */
+    {
+        return 2;                                                   /* return error */
+    }
+    if (handle->inited != 1)                                        /* check handle initialization */
+    {
+        return 3;                                                   /* return error */
+    }
+    if ((queue != NULL) && (frame != NULL) && (depth < 2))          /* check the depth */
+    {
+        handle->debug_print("nrf24l01: depth is invalid.\n");       /* depth is invalid */
+       
+        return 4;                                                   /* return error */
+    }
+    
+    handle->rx_queue = NULL;                                        /* stop the irq pushing */
+    if ((queue == NULL) || (frame == NULL))                         /* check the queue */
+    {
+        return 0;                                                   /* success return 0 */
+    }
+    queue->frame = frame;                                           /* set the frame buffer */
+    queue->depth = depth;                                           /* set the depth */
+    queue->head = 0;                                                /* clear head */
+    queue->tail = 0;                                                /* clear tail */
+    queue->dropped = 0;                                             /* clear dropped */
+    NRF24L01_MEMORY_BARRIER();                                      /* clear before the publish */
+    handle->rx_queue = queue;                                       /* set the queue */
+    
+    return 0;                                                       /* success return 0 */
+}
+
+/**
+ * @brief      pop the received frames without waiting
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *frame pointer to a frame buffer
+ * @param[in]  max max frame number
+ * @param[out] *num pointer to a popped frame number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 rx queue is not set
+ * @note       only one consumer thread may pop, it runs lock free against the irq handler
+ */
+uint8_t nrf24l01_try_receive(nrf24l01_handle_t *handle, nrf24l01_rx_frame_t *frame, uint16_t max, uint16_t *num)
+{
+    uint16_t head;
+    uint16_t tail;
+    uint16_t n;
+    
+    if (handle == NULL)                                                                      /* check handle */
+    {
+        return 2;                                                                            /* return error */
+    }
+    if (handle->inited != 1)                                                                 /* check handle initialization */
+    {
+        return 3;                                                                            /* return error */
+    }
+    if (handle->rx_queue == NULL)                                                            /* check the queue */
+    {
+        handle->debug_print("nrf24l01: rx queue is not set.\n");                             /* rx queue is not set */
+       
+        return 4;                                                                            /* return error */
+    }
+    
+    head = handle->rx_queue->head;                                                           /* get head */
+    NRF24L01_MEMORY_BARRIER();                                                               /* read the index before the frames */
+    tail = handle->rx_queue->tail;                                                           /* get tail */
+    n = 0;                                                                                   /* init 0 */
+    while ((tail != head) && (n < max))                                                      /* pop the frames */
+    {
+        memcpy(&frame[n], &handle->rx_queue->frame[tail], sizeof(nrf24l01_rx_frame_t));      /* copy the frame */
+        tail = (uint16_t)((tail + 1) % handle->rx_queue->depth);                             /* tail++ */
+        n++;                                                                                 /* n++ */
+    }
+    NRF24L01_MEMORY_BARRIER();                                                               /* read the frames before freeing them */
+    handle->rx_queue->tail = tail;                                                           /* free the frames */
+    *num = n;                                                                                /* set the number */
+    
+    return 0;                                                                                /* success return 0 */
+}
+
+/**
+ * @brief      pop the received frames
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *frame pointer to a frame buffer
+ * @param[in]  max max frame number
+ * @param[out] *num pointer to a popped frame number buffer
+ * @param[in]  timeout_ms timeout in ms
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 rx queue is not set
+ *             - 5 receive timeout
+ * @note       waits until at least one frame is queued
+ */
+uint8_t nrf24l01_receive(nrf24l01_handle_t *handle, nrf24l01_rx_frame_t *frame, uint16_t max, uint16_t *num, uint32_t timeout_ms)
+{
+    uint8_t res;
+    uint32_t t;
+    
+    res = nrf24l01_try_receive(handle, frame, max, num);           /* try to receive */
+    if (res != 0)                                                  /* check result */
+    {
+        return res;                                                /* return error */
+    }
+    a_nrf24l01_poll_start(handle, &t);                             /* start the wait */
+    while ((*num == 0) && (max != 0))                              /* wait the frames */
+    {
+        if (timeout_ms == 0)                                       /* check timeout */
+        {
+            return 5;                                              /* return error */
+        }
+        if (a_nrf24l01_poll(handle, &t, 1000) != 0)                /* check 1 ms passed */
+        {
+            a_nrf24l01_poll_start(handle, &t);                     /* restart the wait */
+            timeout_ms--;                                          /* timeout-- */
+        }
+        res = nrf24l01_try_receive(handle, frame, max, num);       /* try to receive */
+        if (res != 0)                                              /* check result */
+        {
+            return res;                                            /* return error */
+        }
+    }
+    
+    return 0;                                                      /* success return 0 */
+}
+
+/**
+ * @brief      get the rx queue status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *count pointer to a queued frame number buffer
+ * @param[out] *dropped pointer to a dropped frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 rx queue is not set
+ * @note       frames are dropped when the queue is full
+ */
+uint8_t nrf24l01_get_rx_queue_status(nrf24l01_handle_t *handle, uint16_t *count, uint32_t *dropped)
+{
+    if (handle == NULL)                                                /* check handle */
+    {
+        return 2;                                                      /* return error */
+    }
+    if (handle->inited != 1)                                           /* check handle initialization */
+    {
+        return 3;                                                      /* return error */
+    }
+    if (handle->rx_queue == NULL)                                      /* check the queue */
+    {
+        handle->debug_print("nrf24l01: rx queue is not set.\n");       /* rx queue is not set */
+       
+        return 4;                                                      /* return error */
+    }
+    
+    *count = (uint16_t)((handle->rx_queue->head + handle->rx_queue->depth - handle->rx_queue->tail) %
+                        handle->rx_queue->depth);                      /* get count */
+    *dropped = handle->rx_queue->dropped;                              /* get dropped */
+    
+    return 0;                                                          /* success return 0 */
+}
+
+/**
+ * @brief     send a message larger than one payload
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a message buffer
+ * @param[in] len message length
+ * @param[in] *callback pointer to a completion callback, it can be NULL
+ * @param[in] *param pointer to the callback parameter
+ * @return    status code
+ *            - 0 success
+ *            - 1 send message failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is invalid
+ *            - 5 send is busy
+ *            - 6 stream is not set
+ * @note      the message is cut into fragments of a 2 bytes header and up to 30 bytes, which are
+ *            pipelined through the tx fifo by the irq handler like a stream, buf must stay valid
+ *            until the callback runs, a fragment reaching max rt aborts the message, the receiver
+ *            needs dynamic payload length
+ */
+uint8_t nrf24l01_send_message(nrf24l01_handle_t *handle, uint8_t *buf, uint16_t len,
+                              void (*callback)(nrf24l01_send_status_t status, void *param), void *param)
+{
+    if (handle == NULL)                                                                                       /* check handle */
+    {
+        return 2;                                                                                             /* return error */
+    }
+    if (handle->inited != 1)                                                                                  /* check handle initialization */
+    {
+        return 3;                                                                                             /* return error */
+    }
+    if ((len == 0) || (len > NRF24L01_FRAGMENT_MAX_LENGTH))                                                   /* check the length */
+    {
+        handle->debug_print("nrf24l01: len is invalid.\n");                                                   /* len is invalid */
+       
+        return 4;                                                                                             /* return error */
+    }
+    if (handle->stream == NULL)                                                                               /* check the stream */
+    {
+        handle->debug_print("nrf24l01: stream is not set.\n");                                                /* stream is not set */
+       
+        return 6;                                                                                             /* return error */
+    }
+    if (NRF24L01_CLAIM(handle->sending) == 0)                                                                 /* claim the radio */
+    {
+        handle->debug_print("nrf24l01: send is busy.\n");                                                     /* send is busy */
+       
+        return 5;                                                                                             /* return error */
+    }
+    
+    handle->stream->buf = buf;                                                                                /* set the buffer */
+    handle->stream->len = NRF24L01_FRAGMENT_PAYLOAD;                                                          /* set the fragment length */
+    handle->stream->num = (uint16_t)((len + NRF24L01_FRAGMENT_PAYLOAD - 1) / NRF24L01_FRAGMENT_PAYLOAD);      /* set the fragment number */
+    handle->stream->result = NULL;                                                                            /* no result buffer */
+    handle->stream->loaded = 0;                                                                               /* clear loaded */
+    handle->stream->done = 0;                                                                                 /* clear done */
+    handle->stream->failed = 0;                                                                               /* clear failed */
+    handle->stream->fragment = 1;                                                                             /* fragment stream */
+    handle->stream->id = handle->fragment_id;                                                                 /* set the message id */
+    handle->stream->total = len;                                                                              /* set the message length */
+    handle->fragment_id = (uint8_t)((handle->fragment_id + 1) & 0x0F);                                        /* id++ */
+    handle->send_callback = callback;                                                                         /* set the callback */
+    handle->send_param = param;                                                                               /* set the callback parameter */
+    handle->finished = 0;                                                                                     /* clear finished */
+    if (handle->gpio_write(handle->user_data, 0) != 0)                                                        /* gpio write */
+    {
+        handle->sending = 0;                                                                                  /* clear sending */
+        handle->debug_print("nrf24l01: gpio write failed.\n");                                                /* gpio write failed */
+       
+        return 1;                                                                                             /* return error */
+    }
+    if (a_nrf24l01_stream_fill(handle) != 0)                                                                  /* load the tx fifo */
+    {
+        handle->sending = 0;                                                                                  /* clear sending */
+        handle->debug_print("nrf24l01: set tx payload failed.\n");                                            /* set tx payload failed */
+       
+        return 1;                                                                                             /* return error */
+    }
+    handle->stream->enable = 1;                                                                               /* start the stream */
+    if (handle->gpio_write(handle->user_data, 1) != 0)                                                        /* gpio write */
+    {
+        handle->stream->enable = 0;                                                                           /* stop the stream */
+        handle->sending = 0;                                                                                  /* clear sending */
+        handle->debug_print("nrf24l01: gpio write failed.\n");                                                /* gpio write failed */
+       
+        return 1;                                                                                             /* return error */
+    }
+    
+    return 0;                                                                                                 /* success return 0 */
+}
+
+/**
+ * @brief     set the reassembly context of a pipe
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe rx pipe
+ * @param[in] *ctx pointer to a caller allocated context, NULL disables the reassembly
+ * @param[in] *buf pointer to a message buffer
+ * @param[in] size message buffer size
+ * @param[in] *callback pointer to a message callback
+ * @param[in] *param pointer to the callback parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 pipe is invalid
+ *            - 5 size is invalid
+ * @note      the payloads of the pipe are reassembled in the irq handler and bypass the rx queue
+ *            and the receive callback, the callback runs from the irq handler with the whole message
+ */
+uint8_t nrf24l01_set_reassembly(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, nrf24l01_reassembly_t *ctx,
+                                uint8_t *buf, uint16_t size,
+                                void (*callback)(uint8_t pipe, uint8_t *buf, uint16_t len, void *param), void *param)
+{
+    if (handle == NULL)                                            /* check handle */
+    {
+        return 2;                                                  /* return error */
+    }
+    if (handle->inited != 1)                                       /* check handle initialization */
+    {
+        return 3;                                                  /* return error */
+    }
+    if (pipe > NRF24L01_PIPE_5)                                    /* check the pipe */
+    {
+        handle->debug_print("nrf24l01: pipe is invalid.\n");       /* pipe is invalid */
+       
+        return 4;                                                  /* return error */
+    }
+    if ((ctx != NULL) && ((buf == NULL) || (size == 0)))           /* check the size */
+    {
+        handle->debug_print("nrf24l01: size is invalid.\n");       /* size is invalid */
+       
+        return 5;                                                  /* return error */
+    }
+    
+    handle->reassembly[pipe] = NULL;                               /* stop the irq pushing */
+    NRF24L01_MEMORY_BARRIER();                                     /* barrier */
+    if (ctx == NULL)                                               /* disable */
+    {
+        return 0;                                                  /* success return 0 */
+    }
+    memset(ctx, 0, sizeof(nrf24l01_reassembly_t));                 /* clear the context */
+    ctx->buf = buf;                                                /* set the buffer */
+    ctx->size = size;                                              /* set the size */
+    ctx->id = 0xFF;                                                /* no message yet */
+    ctx->callback = callback;                                      /* set the callback */
+    ctx->param = param;                                            /* set the callback parameter */
+    NRF24L01_MEMORY_BARRIER();                                     /* barrier */
+    handle->reassembly[pipe] = ctx;                                /* start the irq pushing */
+    
+    return 0;                                                      /* success return 0 */
+}
+
+/**
+ * @brief      get the reassembly status of a pipe
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  pipe rx pipe
+ * @param[out] *duplicate pointer to a duplicate fragment counter buffer
+ * @param[out] *out_of_order pointer to an out of order fragment counter buffer
+ * @param[out] *overflow pointer to a message overflow counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 pipe is invalid
+ *             - 5 reassembly is not set
+ * @note       an out of order fragment drops the partial message
+ */
+uint8_t nrf24l01_get_reassembly_status(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, uint32_t *duplicate,
+                                       uint32_t *out_of_order, uint32_t *overflow)
+{
+    if (handle == NULL)                                                  /* check handle */
+    {
+        return 2;                                                        /* return error */
+    }
+    if (handle->inited != 1)                                             /* check handle initialization */
+    {
+        return 3;                                                        /* return error */
+    }
+    if (pipe > NRF24L01_PIPE_5)                                          /* check the pipe */
+    {
+        handle->debug_print("nrf24l01: pipe is invalid.\n");             /* pipe is invalid */
+       
+        return 4;                                                        /* return error */
+    }
+    if (handle->reassembly[pipe] == NULL)                                /* check the context */
+    {
+        handle->debug_print("nrf24l01: reassembly is not set.\n");       /* reassembly is not set */
+       
+        return 5;                                                        /* return error */
+    }
+    
+    *duplicate = handle->reassembly[pipe]->duplicate;                    /* get duplicate */
+    *out_of_order = handle->reassembly[pipe]->out_of_order;              /* get out of order */
+    *overflow = handle->reassembly[pipe]->overflow;                      /* get overflow */
+    
+    return 0;                                                            /* success return 0 */
+}
+
+/**
+ * @brief     set the ack payload channel
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *ack pointer to a caller allocated ack payload channel, NULL disables the channel
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the channel is cleared, then the queues and the handler are set on it with
+ *            nrf24l01_set_ack_queue and nrf24l01_set_ack_handler
+ */
+uint8_t nrf24l01_set_ack_channel(nrf24l01_handle_t *handle, nrf24l01_ack_t *ack)
+{
+    if (handle == NULL)                             /* check handle */
+    {
+        return 2;                                   /* return error */
+    }
+    if (handle->inited != 1)                        /* check handle initialization */
+    {
+        return 3;                                   /* return error */
+    }
+    
+    handle->ack = NULL;                             /* stop the irq loading */
+    if (ack == NULL)                                /* check ack */
+    {
+        return 0;                                   /* success return 0 */
+    }
+    memset(ack, 0, sizeof(nrf24l01_ack_t));         /* clear the channel */
+    NRF24L01_MEMORY_BARRIER();                      /* clear before the publish */
+    handle->ack = ack;                              /* set the channel */
+    
+    return 0;                                       /* success return 0 */
+}
+
+/**
+ * @brief     set the ack payload queue of a pipe
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe rx pipe
+ * @param[in] *frame pointer to a caller allocated frame buffer, NULL disables the queue
+ * @param[in] depth frame buffer depth
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 pipe is invalid
+ *            - 5 depth is invalid
+ *            - 6 ack channel is not set
+ * @note      prx only, payload with ack and dynamic payload must be enabled, the queue holds depth - 1
+ *            frames and the irq handler keeps the 3 tx fifo slots loaded from all queues in turn, a
+ *            frame received on the pipe retires the head payload only when auto acknowledgment is
+ *            enabled on the pipe, a frame sent with NO_ACK looks the same on the prx side, so the
+ *            ptx must not send NO_ACK frames to a pipe with an ack queue
+ */
+uint8_t nrf24l01_set_ack_queue(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, nrf24l01_tx_frame_t *frame, uint16_t depth)
+{
+    nrf24l01_tx_ring_t *queue;
+    
+    if (handle == NULL)                                             /* check handle */
+    {
+        return 2;                                                   /* return error */
+    }
+    if (handle->inited != 1)                                        /* check handle initialization */
+    {
+        return 3;                                                   /* return error */
+    }
+    if (pipe > NRF24L01_PIPE_5)                                     /* check the pipe */
+    {
+        handle->debug_print("nrf24l01: pipe is invalid.\n");        /* pipe is invalid */
+       
+        return 4;                                                   /* return error */
+    }
+    if ((frame != NULL) && (depth < 2))                             /* check the depth */
+    {
+        handle->debug_print("nrf24l01: depth is invalid.\n");       /* depth is invalid */
+       
+        return 5;                                                   /* return error */
+    }
+    if (handle->ack == NULL)                                        /* check the channel */
+    {
+        handle->debug_print("nrf24l01: ack channel is not set.\n"); /* ack channel is not set */
+       
+        return 6;                                                   /* return error */
+    }
+    
+    queue = &handle->ack->queue[pipe];                              /* get the queue */
+    handle->ack->enable &= (uint8_t)(~(1 << pipe));                 /* stop the irq loading */
+    NRF24L01_MEMORY_BARRIER();                                      /* barrier */
+    queue->frame = frame;                                           /* set the frame buffer */
+    queue->depth = depth;                                           /* set the depth */
+    queue->head = 0;                                                /* clear head */
+    queue->load = 0;                                                /* clear load */
+    queue->tail = 0;                                                /* clear tail */
+    queue->sent = 0;                                                /* clear sent */
+    queue->failed = 0;                                              /* clear failed */
+    NRF24L01_MEMORY_BARRIER();                                      /* barrier */
+    if (frame != NULL)                                              /* enable */
+    {
+        handle->ack->enable |= (uint8_t)(1 << pipe);                /* start the irq loading */
+    }
+    
+    return 0;                                                       /* success return 0 */
+}
+
+/**
+ * @brief     write an ack payload to the queue of a pipe
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe rx pipe
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is invalid
+ *            - 5 ack queue is not set
+ *            - 6 ack queue is full
+ * @note      a free tx fifo slot is loaded at once, a payload leaves the queue when the next
+ *            packet of the pipe is received, because the chip sends it with that ack
+ */
+uint8_t nrf24l01_ack_queue_write(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, uint8_t *buf, uint8_t len)
+{
+    uint8_t i;
+    uint16_t next;
+    nrf24l01_tx_ring_t *queue;
+    nrf24l01_tx_frame_t *frame;
+    
+    if (handle == NULL)                                                                 /* check handle */
+    {
+        return 2;                                                                       /* return error */
+    }
+    if (handle->inited != 1)                                                            /* check handle initialization */
+    {
+        return 3;                                                                       /* return error */
+    }
+    if ((len == 0) || (len > 32))                                                       /* check the length */
+    {
+        handle->debug_print("nrf24l01: len is invalid.\n");                             /* len is invalid */
+       
+        return 4;                                                                       /* return error */
+    }
+    if ((pipe > NRF24L01_PIPE_5) || (handle->ack == NULL) ||
+        (((handle->ack->enable >> pipe) & 0x01) == 0))                                  /* check the queue */
+    {
+        handle->debug_print("nrf24l01: ack queue is not set.\n");                       /* ack queue is not set */
+       
+        return 5;                                                                       /* return error */
+    }
+    queue = &handle->ack->queue[pipe];                                                  /* get the queue */
+    next = (uint16_t)((queue->head + 1) % queue->depth);                                /* get the next index */
+    if (next == queue->tail)                                                            /* check full */
+    {
+        return 6;                                                                       /* return error */
+    }
+    
+    frame = &queue->frame[queue->head];                                                 /* get the frame */
+    if (handle->wire_order != 0)                                                        /* wire order */
+    {
+        memcpy(frame->buf, buf, len);                                                   /* copy data */
+    }
+    else
+    {
+        for (i = 0; i < len; i++)                                                       /* run len times */
+        {
+            frame->buf[i] = buf[len - 1 - i];                                           /* copy reversed */
+        }
+    }
+    frame->len = len;                                                                   /* set the length */
+    queue->head = next;                                                                 /* publish the frame */
+    if (a_nrf24l01_ack_fill(handle) != 0)                                               /* load the tx fifo */
+    {
+        handle->debug_print("nrf24l01: set payload with ack failed.\n");                /* set payload with ack failed */
+       
+        return 1;                                                                       /* return error */
+    }
+    
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief      get the ack payload queue status of a pipe
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  pipe rx pipe
+ * @param[out] *pending pointer to a pending frame number buffer
+ * @param[out] *sent pointer to a sent frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 pipe is invalid
+ *             - 5 ack queue is not set
+ * @note       pending counts the queued and the loaded frames
+ */
+uint8_t nrf24l01_get_ack_queue_status(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, uint16_t *pending, uint32_t *sent)
+{
+    nrf24l01_tx_ring_t *queue;
+    
+    if (handle == NULL)                                                                     /* check handle */
+    {
+        return 2;                                                                           /* return error */
+    }
+    if (handle->inited != 1)                                                                /* check handle initialization */
+    {
+        return 3;                                                                           /* return error */
+    }
+    if (pipe > NRF24L01_PIPE_5)                                                             /* check the pipe */
+    {
+        handle->debug_print("nrf24l01: pipe is invalid.\n");                                /* pipe is invalid */
+       
+        return 4;                                                                           /* return error */
+    }
+    if ((handle->ack == NULL) || (((handle->ack->enable >> pipe) & 0x01) == 0))             /* check the queue */
+    {
+        handle->debug_print("nrf24l01: ack queue is not set.\n");                           /* ack queue is not set */
+       
+        return 5;                                                                           /* return error */
+    }
+    
+    queue = &handle->ack->queue[pipe];                                                      /* get the queue */
+    *pending = (uint16_t)((queue->head + queue->depth - queue->tail) % queue->depth);       /* get pending */
+    *sent = queue->sent;                                                                    /* get sent */
+    
+    return 0;                                                                               /* success return 0 */
+}
+
+/**
+ * @brief     set the ack payload handler
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *callback pointer to an ack payload callback, NULL disables the handler
+ * @param[in] *param pointer to the callback parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 ack channel is not set
+ * @note      ptx only, the ack payloads bypass the rx queue and the receive callback and come with
+ *            the sequence of the send they answer, the sequence counts the acknowledged sends
+ *            from the first one which is 1, when several sends complete in one interrupt the ack
+ *            payloads are matched to them in order
+ */
+uint8_t nrf24l01_set_ack_handler(nrf24l01_handle_t *handle,
+                                 void (*callback)(uint32_t sequence, uint8_t *buf, uint8_t len, void *param), void *param)
+{
+    if (handle == NULL)                                                   /* check handle */
+    {
+        return 2;                                                         /* return error */
+    }
+    if (handle->inited != 1)                                              /* check handle initialization */
+    {
+        return 3;                                                         /* return error */
+    }
+    if (handle->ack == NULL)                                              /* check the channel */
+    {
+        handle->debug_print("nrf24l01: ack channel is not set.\n");       /* ack channel is not set */
+       
+        return 4;                                                         /* return error */
+    }
+    
+    handle->ack->callback = NULL;                                         /* stop the irq delivering */
+    NRF24L01_MEMORY_BARRIER();                                            /* barrier */
+    handle->ack->param = param;                                           /* set the callback parameter */
+    NRF24L01_MEMORY_BARRIER();                                            /* barrier */
+    handle->ack->callback = callback;                                     /* set the callback */
+    
+    return 0;                                                             /* success return 0 */
+}
+
+/**
+ * @brief      get the acknowledged send sequence
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *sequence pointer to a sequence buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the next acknowledged send gets sequence + 1
+ */
+uint8_t nrf24l01_get_tx_sequence(nrf24l01_handle_t *handle, uint32_t *sequence)
+{
+    if (handle == NULL)                     /* check handle */
+    {
+        return 2;                           /* return error */
+    }
+    if (handle->inited != 1)                /* check handle initialization */
+    {
+        return 3;                           /* return error */
+    }
+    
+    *sequence = handle->tx_sequence;        /* get sequence */
+    
+    return 0;                               /* success return 0 */
+}
+
+/**
+ * @brief     set the dispatch table
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *dispatch pointer to a caller allocated dispatch table, NULL disables the dispatch
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the table is cleared, then the pipe handlers, the discard flag and the tx hooks are
+ *            set on it with their setters
+ */
+uint8_t nrf24l01_set_dispatch(nrf24l01_handle_t *handle, nrf24l01_dispatch_t *dispatch)
+{
+    if (handle == NULL)                                       /* check handle */
+    {
+        return 2;                                             /* return error */
+    }
+    if (handle->inited != 1)                                  /* check handle initialization */
+    {
+        return 3;                                             /* return error */
+    }
+    
+    handle->dispatch = NULL;                                  /* stop the irq delivering */
+    if (dispatch == NULL)                                     /* check dispatch */
+    {
+        return 0;                                             /* success return 0 */
+    }
+    memset(dispatch, 0, sizeof(nrf24l01_dispatch_t));         /* clear the table */
+    NRF24L01_MEMORY_BARRIER();                                /* clear before the publish */
+    handle->dispatch = dispatch;                              /* set the table */
+    
+    return 0;                                                 /* success return 0 */
+}
+
+/**
+ * @brief     set a pipe receive handler
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe rx pipe number
+ * @param[in] *callback pointer to a pipe receive handler, NULL removes the handler
+ * @param[in] *param pointer to the handler parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 pipe is invalid
+ *            - 5 dispatch is not set
+ * @note      the payloads of the pipe go straight to the handler and bypass the rx queue and the
+ *            receive callback, a reassembly context on the same pipe takes precedence
+ */
+uint8_t nrf24l01_set_pipe_handler(nrf24l01_handle_t *handle, uint8_t pipe,
+                                  void (*callback)(uint8_t pipe, uint8_t *buf, uint8_t len, void *param), void *param)
+{
+    if (handle == NULL)                                                /* check handle */
+    {
+        return 2;                                                      /* return error */
+    }
+    if (handle->inited != 1)                                           /* check handle initialization */
+    {
+        return 3;                                                      /* return error */
+    }
+    if (pipe > 5)                                                      /* check pipe */
+    {
+        handle->debug_print("nrf24l01: pipe is invalid.\n");           /* pipe is invalid */
+       
+        return 4;                                                      /* return error */
+    }
+    if (handle->dispatch == NULL)                                      /* check dispatch */
+    {
+        handle->debug_print("nrf24l01: dispatch is not set.\n");       /* dispatch is not set */
+       
+        return 5;                                                      /* return error */
+    }
+    
+    handle->dispatch->pipe[pipe].callback = NULL;                      /* stop the irq delivering */
+    NRF24L01_MEMORY_BARRIER();                                         /* order the writes */
+    handle->dispatch->pipe[pipe].param = param;                        /* set the parameter */
+    NRF24L01_MEMORY_BARRIER();                                         /* write the parameter before the handler */
+    handle->dispatch->pipe[pipe].callback = callback;                  /* set the handler */
+    
+    return 0;                                                          /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable discarding the payloads of the pipes without consumer
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 dispatch is not set
+ * @note      when enabled the payloads of the pipes without a handler or a reassembly context are
+ *            popped from the rx fifo and dropped without being copied to the rx queue or passed to
+ *            the receive callback
+ */
+uint8_t nrf24l01_set_dispatch_discard(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
+{
+    if (handle == NULL)                                                /* check handle */
+    {
+        return 2;                                                      /* return error */
+    }
+    if (handle->inited != 1)                                           /* check handle initialization */
+    {
+        return 3;                                                      /* return error */
+    }
+    if (handle->dispatch == NULL)                                      /* check dispatch */
+    {
+        handle->debug_print("nrf24l01: dispatch is not set.\n");       /* dispatch is not set */
+       
+        return 4;                                                      /* return error */
+    }
+    
+    handle->dispatch->discard = (uint8_t)enable;                       /* set discard */
+    
+    return 0;                                                          /* success return 0 */
+}
+
+/**
+ * @brief      get the discard status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_dispatch_discard(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
+{
+    if (handle == NULL)                                                                                /* check handle */
+    {
+        return 2;                                                                                      /* return error */
+    }
+    if (handle->inited != 1)                                                                           /* check handle initialization */
+    {
+        return 3;                                                                                      /* return error */
+    }
+    
+    *enable = (nrf24l01_bool_t)((handle->dispatch != NULL) && (handle->dispatch->discard != 0));       /* get discard */
+    
+    return 0;                                                                                          /* success return 0 */
+}
+
+/**
+ * @brief     set the tx hooks
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *tx_ds pointer to a tx data sent hook, NULL disables the hook
+ * @param[in] *max_rt pointer to a max retransmit hook, NULL disables the hook
+ * @param[in] *param pointer to the hook parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 dispatch is not set
+ * @note      the hooks run from the irq handler on every tx data sent or max retransmit interrupt
+ *            next to the receive callback
+ */
+uint8_t nrf24l01_set_tx_hooks(nrf24l01_handle_t *handle, void (*tx_ds)(void *param),
+                              void (*max_rt)(void *param), void *param)
+{
+    if (handle == NULL)                                                /* check handle */
+    {
+        return 2;                                                      /* return error */
+    }
+    if (handle->inited != 1)                                           /* check handle initialization */
+    {
+        return 3;                                                      /* return error */
+    }
+    if (handle->dispatch == NULL)                                      /* check dispatch */
+    {
+        handle->debug_print("nrf24l01: dispatch is not set.\n");       /* dispatch is not set */
+       
+        return 4;                                                      /* return error */
+    }
+    
+    handle->dispatch->tx_ds = NULL;                                    /* stop the irq delivering */
+    handle->dispatch->max_rt = NULL;                                   /* stop the irq delivering */
+    NRF24L01_MEMORY_BARRIER();                                         /* order the writes */
+    handle->dispatch->param = param;                                   /* set the parameter */
+    NRF24L01_MEMORY_BARRIER();                                         /* write the parameter before the hooks */
+    handle->dispatch->tx_ds = tx_ds;                                   /* set the tx ds hook */
+    handle->dispatch->max_rt = max_rt;                                 /* set the max rt hook */
+    
+    return 0;                                                          /* success return 0 */
+}
+
+/**
+ * @brief      make a hopping sequence
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  seed shared sequence seed
+ * @param[in]  first first usable channel
+ * @param[in]  last last usable channel
+ * @param[out] *channel pointer to a channel sequence buffer
+ * @param[in]  num sequence length
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 sequence is invalid
+ * @note       last <= 0x7F, num can't exceed the usable channels, every channel of the sequence is
+ *             different and the same seed gives the same sequence on every node
+ */
+uint8_t nrf24l01_hopping_sequence(nrf24l01_handle_t *handle, uint32_t seed, uint8_t first, uint8_t last,
+                                  uint8_t *channel, uint8_t num)
+{
+    uint8_t i;
+    uint8_t j;
+    uint8_t ch;
+    uint32_t state;
+    
+    if (handle == NULL)                                                                    /* check handle */
+    {
+        return 2;                                                                          /* return error */
+    }
+    if (handle->inited != 1)                                                               /* check handle initialization */
+    {
+        return 3;                                                                          /* return error */
+    }
+    if ((last > 0x7F) || (first > last) || (num == 0) || (num > (last - first + 1)))       /* check sequence */
+    {
+        handle->debug_print("nrf24l01: sequence is invalid.\n");                           /* sequence is invalid */
+       
+        return 4;                                                                          /* return error */
+    }
+    
+    state = (seed != 0) ? seed : 1;                                                        /* xorshift needs a non zero state */
+    for (i = 0; i < num; i++)                                                              /* make all channels */
+    {
+        state ^= state << 13;                                                              /* xorshift32 */
+        state ^= state >> 17;                                                              /* xorshift32 */
+        state ^= state << 5;                                                               /* xorshift32 */
+        ch = (uint8_t)(first + state % (uint32_t)(last - first + 1));                      /* pick a channel */
+        j = 0;                                                                             /* from the first channel */
+        while (j < i)                                                                      /* check the used channels */
+        {
+            if (channel[j] == ch)                                                          /* check used */
+            {
+                ch = (ch == last) ? first : (uint8_t)(ch + 1);                             /* probe the next channel */
+                j = 0;                                                                     /* check again from the start */
+            }
+            else
+            {
+                j++;                                                                       /* next channel */
+            }
+        }
+        channel[i] = ch;                                                                   /* set the channel */
+    }
+    
+    return 0;                                                                              /* success return 0 */
+}
+
+/**
+ * @brief     start or stop the channel hopping
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *hopping pointer to a caller allocated hopping state, NULL stops the hopping
+ * @param[in] *channel pointer to a channel sequence, NULL stops the hopping
+ * @param[in] num sequence length
+ * @param[in] slot_us slot length in us
+ * @return    status code
+ *            - 0 success
+ *            - 1 set hopping failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ *            - 5 hopping is invalid
+ * @note      the state and the sequence must stay valid while hopping, slot 0 starts now on the
+ *            first channel
+ */
+uint8_t nrf24l01_set_hopping(nrf24l01_handle_t *handle, nrf24l01_hopping_t *hopping,
+                             const uint8_t *channel, uint8_t num, uint32_t slot_us)
+{
+    uint8_t i;
+    
+    if (handle == NULL)                                                   /* check handle */
+    {
+        return 2;                                                         /* return error */
+    }
+    if (handle->inited != 1)                                              /* check handle initialization */
+    {
+        return 3;                                                         /* return error */
+    }
+    
+    handle->hopping = NULL;                                               /* stop the hopping */
+    if ((hopping == NULL) || (channel == NULL))                           /* check hopping and channel */
+    {
+        return 0;                                                         /* success return 0 */
+    }
+    if (handle->timestamp_us == NULL)                                     /* check timestamp_us */
+    {
+        handle->debug_print("nrf24l01: timestamp_us is null.\n");         /* timestamp_us is null */
+       
+        return 4;                                                         /* return error */
+    }
+    if ((num == 0) || (slot_us == 0))                                     /* check num and slot */
+    {
+        handle->debug_print("nrf24l01: hopping is invalid.\n");           /* hopping is invalid */
+       
+        return 5;                                                         /* return error */
+    }
+    for (i = 0; i < num; i++)                                             /* check all channels */
+    {
+        if (channel[i] > 0x7F)                                            /* check channel */
+        {
+            handle->debug_print("nrf24l01: hopping is invalid.\n");       /* hopping is invalid */
+           
+            return 5;                                                     /* return error */
+        }
+    }
+    
+    if (a_nrf24l01_hop(handle, channel[0]) != 0)                          /* tune to the first channel */
+    {
+        handle->debug_print("nrf24l01: set hopping failed.\n");           /* set hopping failed */
+       
+        return 1;                                                         /* return error */
+    }
+    hopping->channel = channel;                                           /* set the sequence */
+    hopping->num = num;                                                   /* set the length */
+    hopping->slot_us = slot_us;                                           /* set the slot length */
+    hopping->start = handle->timestamp_us();                              /* slot 0 starts now */
+    hopping->slot = 0;                                                    /* set slot 0 */
+    hopping->missed = 0;                                                  /* clear the missed slots */
+    NRF24L01_MEMORY_BARRIER();                                            /* fill before the publish */
+    handle->hopping = hopping;                                            /* start the hopping */
+    
+    return 0;                                                             /* success return 0 */
+}
+
+/**
+ * @brief     update the channel hopping
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 hop failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it at least once per slot, it retunes to the channel of the current slot with ce
+ *            low, one rf channel write and ce high, slots passed without an update are counted as
+ *            missed and skipped, the hop waits while a send is running
+ */
+uint8_t nrf24l01_hopping_update(nrf24l01_handle_t *handle)
+{
+    uint32_t n;
+    uint32_t slot;
+    
+    if (handle == NULL)                                                                         /* check handle */
+    {
+        return 2;                                                                               /* return error */
+    }
+    if (handle->inited != 1)                                                                    /* check handle initialization */
+    {
+        return 3;                                                                               /* return error */
+    }
+    if ((handle->hopping == NULL) || (handle->sending != 0))                                    /* check hopping and sending */
+    {
+        return 0;                                                                               /* success return 0 */
+    }
+    
+    n = (handle->timestamp_us() - handle->hopping->start) / handle->hopping->slot_us;           /* get the passed slots */
+    if (n == 0)                                                                                 /* check the slot */
+    {
+        return 0;                                                                               /* success return 0 */
+    }
+    slot = handle->hopping->slot + n;                                                           /* get the current slot */
+    if (a_nrf24l01_hop(handle, handle->hopping->channel[slot % handle->hopping->num]) != 0)     /* retune */
+    {
+        handle->debug_print("nrf24l01: hop failed.\n");                                         /* hop failed */
+       
+        return 1;                                                                               /* return error */
+    }
+    handle->hopping->start += n * handle->hopping->slot_us;                                     /* move to the slot start */
+    handle->hopping->slot = slot;                                                               /* set the slot */
+    handle->hopping->missed += n - 1;                                                           /* count the skipped slots */
+    
+    return 0;                                                                                   /* success return 0 */
+}
+
+/**
+ * @brief     synchronize the channel hopping
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] slot slot of the peer
+ * @param[in] offset_us time since the peer slot started
+ * @return    status code
+ *            - 0 success
+ *            - 1 hopping sync failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 hopping is not started
+ * @note      the peer slot and offset come from nrf24l01_get_hopping_status on the peer, add the
+ *            air time of the frame that carried them to the offset
+ */
+uint8_t nrf24l01_hopping_sync(nrf24l01_handle_t *handle, uint32_t slot, uint32_t offset_us)
+{
+    uint32_t now;
+    
+    if (handle == NULL)                                                                         /* check handle */
+    {
+        return 2;                                                                               /* return error */
+    }
+    if (handle->inited != 1)                                                                    /* check handle initialization */
+    {
+        return 3;                                                                               /* return error */
+    }
+    if (handle->hopping == NULL)                                                                /* check hopping */
+    {
+        handle->debug_print("nrf24l01: hopping is not started.\n");                             /* hopping is not started */
+       
+        return 4;                                                                               /* return error */
+    }
+    
+    now = handle->timestamp_us();                                                               /* get the time */
+    slot += offset_us / handle->hopping->slot_us;                                               /* add the whole slots */
+    offset_us %= handle->hopping->slot_us;                                                      /* keep the offset in the slot */
+    if (a_nrf24l01_hop(handle, handle->hopping->channel[slot % handle->hopping->num]) != 0)     /* retune */
+    {
+        handle->debug_print("nrf24l01: hopping sync failed.\n");                                /* hopping sync failed */
+       
+        return 1;                                                                               /* return error */
+    }
+    handle->hopping->start = now - offset_us;                                                   /* set the slot start */
+    handle->hopping->slot = slot;                                                               /* set the slot */
+    
+    return 0;                                                                                   /* success return 0 */
+}
+
+/**
+ * @brief      get the channel hopping status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *slot pointer to a current slot buffer
+ * @param[out] *offset_us pointer to a time since the slot started buffer
+ * @param[out] *channel pointer to a tuned channel buffer
+ * @param[out] *missed pointer to a missed slots buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 hopping is not started
+ * @note       the slot and offset follow the clock even when the update is late
+ */
+uint8_t nrf24l01_get_hopping_status(nrf24l01_handle_t *handle, uint32_t *slot, uint32_t *offset_us,
+                                    uint8_t *channel, uint32_t *missed)
+{
+    uint32_t elapsed;
+    
+    if (handle == NULL)                                                                    /* check handle */
+    {
+        return 2;                                                                          /* return error */
+    }
+    if (handle->inited != 1)                                                               /* check handle initialization */
+    {
+        return 3;                                                                          /* return error */
+    }
+    if (handle->hopping == NULL)                                                           /* check hopping */
+    {
+        handle->debug_print("nrf24l01: hopping is not started.\n");                        /* hopping is not started */
+       
+        return 4;                                                                          /* return error */
+    }
+    
+    elapsed = handle->timestamp_us() - handle->hopping->start;                             /* get the time in the slot */
+    *slot = handle->hopping->slot + elapsed / handle->hopping->slot_us;                    /* get the slot */
+    *offset_us = elapsed % handle->hopping->slot_us;                                       /* get the offset */
+    *channel = handle->hopping->channel[handle->hopping->slot % handle->hopping->num];     /* get the tuned channel */
+    *missed = handle->hopping->missed;                                                     /* get the missed slots */
+    
+    return 0;                                                                              /* success return 0 */
+}
+
+/**
+ * @brief      initialize a channel scan
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *scan pointer to a caller allocated scan structure
+ * @param[in]  first first scanned channel
+ * @param[in]  last last scanned channel
+ * @param[in]  samples rpd samples per channel and sweep
+ * @param[in]  dwell_us rx time before every rpd sample
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scan is invalid
+ * @note       last <= 0x7F, samples >= 1, dwell_us >= 170 which is the rx settling and agc time
+ */
+uint8_t nrf24l01_scan_init(nrf24l01_handle_t *handle, nrf24l01_scan_t *scan, uint8_t first, uint8_t last,
+                           uint8_t samples, uint32_t dwell_us)
+{
+    if (handle == NULL)                                                                          /* check handle */
+    {
+        return 2;                                                                                /* return error */
+    }
+    if (handle->inited != 1)                                                                     /* check handle initialization */
+    {
+        return 3;                                                                                /* return error */
+    }
+    if ((last > 0x7F) || (first > last) || (samples == 0) || (dwell_us < NRF24L01_RPD_US))       /* check scan */
+    {
+        handle->debug_print("nrf24l01: scan is invalid.\n");                                     /* scan is invalid */
+       
+        return 4;                                                                                /* return error */
+    }
+    
+    memset(scan, 0, sizeof(nrf24l01_scan_t));                                                    /* clear the scan */
+    scan->first = first;                                                                         /* set the first channel */
+    scan->last = last;                                                                           /* set the last channel */
+    scan->samples = samples;                                                                     /* set the samples */
+    scan->dwell_us = dwell_us;                                                                   /* set the dwell time */
+    scan->channel = first;                                                                       /* start from the first channel */
+    
+    return 0;                                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     scan channels with the received power detector
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *scan pointer to an initialized scan structure
+ * @param[in] steps scanned channels, 0 means one sweep
+ * @return    status code
+ *            - 0 success
+ *            - 1 scan failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 send is running
+ *            - 5 chip is powered down
+ * @note      every channel costs ce low, one rf channel write, ce high and one rpd read per sample,
+ *            the scan continues from the last channel on the next call so a sweep can be split
+ *            between the traffic, the channel and mode are restored before returning, ce is
+ *            restored low in power down and standby-I when the power state is tracked and high
+ *            otherwise, payloads that match an rx address on a scanned channel are received as usual
+ */
+uint8_t nrf24l01_scan(nrf24l01_handle_t *handle, nrf24l01_scan_t *scan, uint8_t steps)
+{
+    uint8_t res;
+    uint8_t ce;
+    uint8_t config;
+    uint8_t rf_ch;
+    uint8_t prev;
+    uint8_t i;
+    uint8_t j;
+    uint8_t n;
+    
+    if (handle == NULL)                                                                          /* check handle */
+    {
+        return 2;                                                                                /* return error */
+    }
+    if (handle->inited != 1)                                                                     /* check handle initialization */
+    {
+        return 3;                                                                                /* return error */
+    }
+    if (handle->sending != 0)                                                                    /* check sending */
+    {
+        handle->debug_print("nrf24l01: send is running.\n");                                     /* send is running */
+       
+        return 4;                                                                                /* return error */
+    }
+    
+    ce = 1;                                                                                      /* the chip was active */
+    if ((handle->power != NULL) && (handle->power->enable != 0) &&
+        (handle->power->state <= NRF24L01_POWER_STATE_STANDBY_1))                                /* check the power state */
+    {
+        ce = 0;                                                                                  /* the chip was in standby-I */
+    }
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_CONFIG, (uint8_t *)&config, 1);               /* get config */
+    if (res != 0)                                                                                /* check result */
+    {
+        handle->debug_print("nrf24l01: get config failed.\n");                                   /* get config failed */
+       
+        return 1;                                                                                /* return error */
+    }
+    if ((config & (1 << 1)) == 0)                                                                /* check power up */
+    {
+        handle->debug_print("nrf24l01: chip is powered down.\n");                                /* chip is powered down */
+       
+        return 5;                                                                                /* return error */
+    }
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RF_CH, (uint8_t *)&rf_ch, 1);                 /* get rf channel */
+    if (res != 0)                                                                                /* check result */
+    {
+        handle->debug_print("nrf24l01: get rf channel failed.\n");                               /* get rf channel failed */
+       
+        return 1;                                                                                /* return error */
+    }
+    if ((config & (1 << 0)) == 0)                                                                /* check rx mode */
+    {
+        prev = config | (1 << 0);                                                                /* set rx mode */
+        if ((handle->gpio_write(handle->user_data, 0) != 0) ||
+            (a_nrf24l01_spi_write(handle, NRF24L01_REG_CONFIG, (uint8_t *)&prev, 1) != 0))       /* switch to rx mode */
+        {
+            handle->debug_print("nrf24l01: scan failed.\n");                                     /* scan failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                     /* set gpio */
+           
+            return 1;                                                                            /* return error */
+        }
+    }
+    
+    n = (steps == 0) ? (uint8_t)(scan->last - scan->first + 1) : steps;                          /* get the scanned channels */
+    for (i = 0; (i < n) && (res == 0); i++)                                                      /* scan all channels */
+    {
+        res = a_nrf24l01_hop(handle, scan->channel);                                             /* tune to the channel */
+        for (j = 0; (j < scan->samples) && (res == 0); j++)                                      /* sample the channel */
+        {
+            a_nrf24l01_delay_us(handle, scan->dwell_us);                                         /* dwell on the channel */
+            res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RPD, (uint8_t *)&prev, 1);            /* get rpd register */
+            if ((res == 0) && ((prev & 0x01) != 0))                                              /* check the received power */
+            {
+                scan->count[scan->channel]++;                                                    /* count the busy sample */
+            }
+        }
+        if (scan->channel == scan->last)                                                         /* check the last channel */
+        {
+            scan->channel = scan->first;                                                         /* start a new sweep */
+            scan->sweeps++;                                                                      /* count the sweep */
+        }
+        else
+        {
+            scan->channel++;                                                                     /* next channel */
+        }
+    }
+    
+    if (handle->gpio_write(handle->user_data, 0) != 0)                                           /* gpio write */
+    {
+        res = 1;                                                                                 /* set error */
+    }
+    if (a_nrf24l01_spi_write(handle, NRF24L01_REG_RF_CH, (uint8_t *)&rf_ch, 1) != 0)             /* restore rf channel */
+    {
+        res = 1;                                                                                 /* set error */
+    }
+    if (((config & (1 << 0)) == 0) &&
+        (a_nrf24l01_spi_write(handle, NRF24L01_REG_CONFIG, (uint8_t *)&config, 1) != 0))         /* restore config */
+    {
+        res = 1;                                                                                 /* set error */
+    }
+    if (handle->gpio_write(handle->user_data, ce) != 0)                                          /* restore ce */
+    {
+        res = 1;                                                                                 /* set error */
+    }
+    if (ce != 0)                                                                                 /* check ce */
+    {
+        a_nrf24l01_settle(handle);                                                               /* wait the settling time */
+    }
+    if (res != 0)                                                                                /* check result */
+    {
+        handle->debug_print("nrf24l01: scan failed.\n");                                         /* scan failed */
+       
+        return 1;                                                                                /* return error */
+    }
+    
+    return 0;                                                                                    /* success return 0 */
+}
+
+/**
+ * @brief      get the quietest scanned channels
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  *scan pointer to an initialized scan structure
+ * @param[out] *channel pointer to a channel buffer
+ * @param[in]  num channel number
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 num is invalid
+ * @note       the channels are ordered from the fewest busy samples, equal channels keep the
+ *             channel order
+ */
+uint8_t nrf24l01_scan_get_quiet(nrf24l01_handle_t *handle, nrf24l01_scan_t *scan, uint8_t *channel, uint8_t num)
+{
+    uint8_t i;
+    uint8_t j;
+    uint8_t ch;
+    uint8_t best;
+    
+    if (handle == NULL)                                                                      /* check handle */
+    {
+        return 2;                                                                            /* return error */
+    }
+    if (handle->inited != 1)                                                                 /* check handle initialization */
+    {
+        return 3;                                                                            /* return error */
+    }
+    if ((num == 0) || (num > (scan->last - scan->first + 1)))                                /* check num */
+    {
+        handle->debug_print("nrf24l01: num is invalid.\n");                                  /* num is invalid */
+       
+        return 4;                                                                            /* return error */
+    }
+    
+    for (i = 0; i < num; i++)                                                                /* select all channels */
+    {
+        best = 0xFF;                                                                         /* no channel */
+        for (ch = scan->first; ch <= scan->last; ch++)                                       /* check all scanned channels */
+        {
+            for (j = 0; j < i; j++)                                                          /* check the selected channels */
+            {
+                if (channel[j] == ch)                                                        /* check selected */
+                {
+                    break;                                                                   /* skip the channel */
+                }
+            }
+            if ((j == i) && ((best == 0xFF) || (scan->count[ch] < scan->count[best])))       /* check quieter */
+            {
+                best = ch;                                                                   /* set the best channel */
+            }
+        }
+        channel[i] = best;                                                                   /* set the channel */
+    }
+    
+    return 0;                                                                                /* success return 0 */
+}
+
+/**
+ * @brief     start or stop the star network hub
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *hub pointer to a caller allocated hub state, NULL stops the hub
+ * @param[in] *node pointer to a caller allocated node table, NULL stops the hub
+ * @param[in] num node number
+ * @param[in] slice_us rotation slice length in us
+ * @param[in] hot slice payloads that pin a node to its pipe, 0 disables
+ * @return    status code
+ *            - 0 success
+ *            - 1 set hub failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ *            - 5 hub is invalid
+ * @note      the nodes share the pipe 1 address except the lsb which is the node address byte,
+ *            set the pipe 1 address, the pipe 1 - 5 auto acknowledgment and payload widths before
+ *            starting, pipes 1 - 5 belong to the hub until it stops, nodes with pinned = 1 start
+ *            pinned and at most 4 nodes can be pinned
+ */
+uint8_t nrf24l01_set_hub(nrf24l01_handle_t *handle, nrf24l01_hub_t *hub, nrf24l01_hub_node_t *node, uint16_t num,
+                         uint32_t slice_us, uint16_t hot)
+{
+    uint8_t aw;
+    uint8_t pinned;
+    uint16_t i;
+    
+    if (handle == NULL)                                                                                       /* check handle */
+    {
+        return 2;                                                                                             /* return error */
+    }
+    if (handle->inited != 1)                                                                                  /* check handle initialization */
+    {
+        return 3;                                                                                             /* return error */
+    }
+    if ((hub == NULL) || (node == NULL))                                                                      /* stop */
+    {
+        handle->hub = NULL;                                                                                   /* disable the hub */
+        
+        return 0;                                                                                             /* success return 0 */
+    }
+    if (handle->timestamp_us == NULL)                                                                         /* check timestamp_us */
+    {
+        handle->debug_print("nrf24l01: timestamp_us is null.\n");                                             /* timestamp_us is null */
+       
+        return 4;                                                                                             /* return error */
+    }
+    pinned = 0;                                                                                               /* init 0 */
+    for (i = 0; i < num; i++)                                                                                 /* count the pinned nodes */
+    {
+        if (node[i].pinned != 0)                                                                              /* check pinned */
+        {
+            pinned++;                                                                                         /* pinned++ */
+        }
+    }
+    if ((num == 0) || (slice_us == 0) || (pinned > NRF24L01_HUB_PINNED_MAX))                                  /* check hub */
+    {
+        handle->debug_print("nrf24l01: hub is invalid.\n");                                                   /* hub is invalid */
+       
+        return 5;                                                                                             /* return error */
+    }
+    
+    handle->hub = NULL;                                                                                       /* stop the old hub */
+    if (a_nrf24l01_spi_read(handle, NRF24L01_REG_SETUP_AW, &aw, 1) != 0)                                      /* get setup of address widths */
+    {
+        handle->debug_print("nrf24l01: get setup of address widths failed.\n");                               /* get setup of address widths failed */
+       
+        return 1;                                                                                             /* return error */
+    }
+    if ((aw & 0x03) == 0)                                                                                     /* check width */
+    {
+        handle->debug_print("nrf24l01: hub is invalid.\n");                                                   /* hub is invalid */
+       
+        return 5;                                                                                             /* return error */
+    }
+    hub->width = (uint8_t)((aw & 0x03) + 2);                                                                  /* set the address width */
+    if (a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_ADDR_P1, hub->base, hub->width) != 0)                     /* get rx pipe 1 address */
+    {
+        handle->debug_print("nrf24l01: get receive address data pipe p1 register failed.\n");                 /* get receive address data pipe p1 register failed */
+       
+        return 1;                                                                                             /* return error */
+    }
+    for (i = 0; i < num; i++)                                                                                 /* init the nodes */
+    {
+        node[i].pipe = 0;                                                                                     /* waiting */
+        node[i].pinned = (uint8_t)((node[i].pinned != 0) ? 1 : 0);                                            /* pinned by the caller */
+        node[i].slice = 0;                                                                                    /* init 0 */
+        node[i].received = 0;                                                                                 /* init 0 */
+    }
+    for (i = 0; i < 6; i++)                                                                                   /* pipe 0 - 5 */
+    {
+        hub->pipe_node[i] = NRF24L01_HUB_NONE;                                                                /* no node */
+    }
+    hub->node = node;                                                                                         /* set the node table */
+    hub->num = num;                                                                                           /* set the node number */
+    hub->next = 0;                                                                                            /* start from the first node */
+    hub->hot = hot;                                                                                           /* set the hot talker threshold */
+    hub->slice_us = slice_us;                                                                                 /* set the slice length */
+    hub->rotations = 0;                                                                                       /* init 0 */
+    hub->deferred = 0;                                                                                        /* init 0 */
+    hub->enable = 0;                                                                                          /* not rotating yet */
+    NRF24L01_MEMORY_BARRIER();                                                                                /* fill before the publish */
+    handle->hub = hub;                                                                                        /* set the hub */
+    if (a_nrf24l01_hub_rotate(handle) != 0)                                                                   /* set the first nodes */
+    {
+        handle->debug_print("nrf24l01: set hub failed.\n");                                                   /* set hub failed */
+       
+        return 1;                                                                                             /* return error */
+    }
+    hub->start = handle->timestamp_us();                                                                      /* start the slice */
+    hub->enable = 1;                                                                                          /* enable the hub */
+    
+    return 0;                                                                                                 /* success return 0 */
+}
+
+/**
+ * @brief     rotate the hub nodes when the slice is over
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 hub update failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it from the main loop, the rotation waits while a send is running or the rx fifo
+ *            holds payloads so a payload is never given to the next node of its pipe, hot talkers
+ *            are pinned and pinned hot talkers without payloads in the slice go back to rotation
+ */
+uint8_t nrf24l01_hub_update(nrf24l01_handle_t *handle)
+{
+    uint8_t fifo;
+    uint8_t p;
+    uint8_t pinned;
+    uint16_t i;
+    uint32_t now;
+    nrf24l01_hub_node_t *node;
+    
+    if (handle == NULL)                                                                        /* check handle */
+    {
+        return 2;                                                                              /* return error */
+    }
+    if (handle->inited != 1)                                                                   /* check handle initialization */
+    {
+        return 3;                                                                              /* return error */
+    }
+    if ((handle->hub == NULL) || (handle->hub->enable == 0) || (handle->sending != 0))         /* check hub and sending */
+    {
+        return 0;                                                                              /* success return 0 */
+    }
+    
+    now = handle->timestamp_us();                                                              /* get the time */
+    if ((now - handle->hub->start) < handle->hub->slice_us)                                    /* check the slice */
+    {
+        return 0;                                                                              /* success return 0 */
+    }
+    if (a_nrf24l01_spi_read(handle, NRF24L01_REG_FIFO_STATUS, &fifo, 1) != 0)                  /* get fifo status */
+    {
+        handle->debug_print("nrf24l01: get fifo status failed.\n");                            /* get fifo status failed */
+       
+        return 1;                                                                              /* return error */
+    }
+    if ((fifo & 0x01) == 0)                                                                    /* check rx empty */
+    {
+        handle->hub->deferred++;                                                               /* deferred++ */
+        
+        return 0;                                                                              /* success return 0 */
+    }
+    pinned = 0;                                                                                /* init 0 */
+    for (i = 0; i < handle->hub->num; i++)                                                     /* count the pinned nodes */
+    {
+        if (handle->hub->node[i].pinned != 0)                                                  /* check pinned */
+        {
+            pinned++;                                                                          /* pinned++ */
+        }
+    }
+    for (p = 1; p < 6; p++)                                                                    /* pipe 1 - 5 */
+    {
+        if (handle->hub->pipe_node[p] == NRF24L01_HUB_NONE)                                    /* check the node */
+        {
+            continue;                                                                          /* skip the pipe */
+        }
+        node = &handle->hub->node[handle->hub->pipe_node[p]];                                  /* get the node */
+        if ((node->pinned == 2) && (node->slice == 0))                                         /* check the cold hot talker */
+        {
+            node->pinned = 0;                                                                  /* back to rotation */
+            pinned--;                                                                          /* pinned-- */
+        }
+        else if ((node->pinned == 0) && (handle->hub->hot != 0) &&
+                 (node->slice >= handle->hub->hot) && (pinned < NRF24L01_HUB_PINNED_MAX))      /* check the hot talker */
+        {
+            node->pinned = 2;                                                                  /* pin the hot talker */
+            pinned++;                                                                          /* pinned++ */
+        }
+        node->slice = 0;                                                                       /* clear the slice */
+    }
+    if (a_nrf24l01_hub_rotate(handle) != 0)                                                    /* rotate */
+    {
+        handle->debug_print("nrf24l01: hub update failed.\n");                                 /* hub update failed */
+       
+        return 1;                                                                              /* return error */
+    }
+    handle->hub->start = now;                                                                  /* start the slice */
+    handle->hub->rotations++;                                                                  /* rotations++ */
+    
+    return 0;                                                                                  /* success return 0 */
+}
+
+/**
+ * @brief     pin a hub node to a dedicated pipe
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] index node index
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 index is invalid
+ *            - 5 no free pipe
+ * @note      the node gets or leaves its pipe on the next rotation
+ */
+uint8_t nrf24l01_hub_pin(nrf24l01_handle_t *handle, uint16_t index, nrf24l01_bool_t enable)
+{
+    uint8_t pinned;
+    uint16_t i;
+    
+    if (handle == NULL)                                                                           /* check handle */
+    {
+        return 2;                                                                                 /* return error */
+    }
+    if (handle->inited != 1)                                                                      /* check handle initialization */
+    {
+        return 3;                                                                                 /* return error */
+    }
+    if ((handle->hub == NULL) || (handle->hub->enable == 0) || (index >= handle->hub->num))       /* check index */
+    {
+        handle->debug_print("nrf24l01: index is invalid.\n");                                     /* index is invalid */
+       
+        return 4;                                                                                 /* return error */
+    }
+    
+    if (enable == NRF24L01_BOOL_FALSE)                                                            /* unpin */
+    {
+        handle->hub->node[index].pinned = 0;                                                      /* back to rotation */
+        
+        return 0;                                                                                 /* success return 0 */
+    }
+    if (handle->hub->node[index].pinned != 0)                                                     /* check pinned */
+    {
+        handle->hub->node[index].pinned = 1;                                                      /* keep it pinned */
+        
+        return 0;                                                                                 /* success return 0 */
+    }
+    pinned = 0;                                                                                   /* init 0 */
+    for (i = 0; i < handle->hub->num; i++)                                                        /* count the pinned nodes */
+    {
+        if (handle->hub->node[i].pinned != 0)                                                     /* check pinned */
+        {
+            pinned++;                                                                             /* pinned++ */
+        }
+    }
+    if (pinned >= NRF24L01_HUB_PINNED_MAX)                                                        /* check the pinned nodes */
+    {
+        handle->debug_print("nrf24l01: no free pipe.\n");                                         /* no free pipe */
+       
+        return 5;                                                                                 /* return error */
+    }
+    handle->hub->node[index].pinned = 1;                                                          /* pin the node */
+    
+    return 0;                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief      get the hub node of a pipe
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  pipe received pipe
+ * @param[out] *index pointer to a node index buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 pipe has no node
+ * @note       call it from the receive callback with the received pipe
+ */
+uint8_t nrf24l01_hub_get_node(nrf24l01_handle_t *handle, uint8_t pipe, uint16_t *index)
+{
+    if (handle == NULL)                                                                                                                 /* check handle */
+    {
+        return 2;                                                                                                                       /* return error */
+    }
+    if (handle->inited != 1)                                                                                                            /* check handle initialization */
+    {
+        return 3;                                                                                                                       /* return error */
+    }
+    if ((handle->hub == NULL) || (handle->hub->enable == 0) || (pipe > 5) || (handle->hub->pipe_node[pipe] == NRF24L01_HUB_NONE))       /* check pipe */
+    {
+        return 4;                                                                                                                       /* return error */
+    }
+    
+    *index = handle->hub->pipe_node[pipe];                                                                                              /* get the node */
+    
+    return 0;                                                                                                                           /* success return 0 */
+}
+
+/**
+ * @brief     start or stop the tree network layer
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *mesh pointer to a caller allocated mesh state, NULL stops the layer
+ * @param[in] address node address
+ * @param[in] parent parent address, NRF24L01_MESH_NONE for the root
+ * @param[in] *frame pointer to a caller allocated forward queue, NULL stops the layer
+ * @param[in] depth forward queue depth
+ * @param[in] *route pointer to a caller allocated route cache
+ * @param[in] route_num route cache size
+ * @return    status code
+ *            - 0 success
+ *            - 1 set mesh failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 mesh is invalid
+ * @note      bytes 1 and 2 of the pipe 1 - 5 addresses carry the node address, the lsb the pipe
+ *            and the other bytes come from the pipe 1 address set before starting, a node hears
+ *            its parent on pipe 1 and its children on pipes 2 - 5, pipe 0 follows the next hop for
+ *            the auto acknowledgment, use dynamic payloads in prx mode, depth >= 2 and one queue
+ *            slot is kept free, leaves can run without a route cache, starting clears the message
+ *            handler
+ */
+uint8_t nrf24l01_set_mesh(nrf24l01_handle_t *handle, nrf24l01_mesh_t *mesh, uint16_t address, uint16_t parent,
+                          nrf24l01_mesh_frame_t *frame, uint16_t depth, nrf24l01_mesh_route_t *route, uint16_t route_num)
+{
+    uint8_t res;
+    uint8_t aw;
+    uint8_t p;
+    uint8_t en;
+    uint8_t addr[5];
+    uint16_t i;
+    
+    if (handle == NULL)                                                                                         /* check handle */
+    {
+        return 2;                                                                                               /* return error */
+    }
+    if (handle->inited != 1)                                                                                    /* check handle initialization */
+    {
+        return 3;                                                                                               /* return error */
+    }
+    if ((mesh == NULL) || (frame == NULL))                                                                      /* stop */
+    {
+        handle->mesh = NULL;                                                                                    /* disable the mesh */
+        
+        return 0;                                                                                               /* success return 0 */
+    }
+    if ((address == NRF24L01_MESH_NONE) || (address == parent) || (depth < 2) ||
+        ((route == NULL) && (route_num != 0)))                                                                  /* check mesh */
+    {
+        handle->debug_print("nrf24l01: mesh is invalid.\n");                                                    /* mesh is invalid */
+       
+        return 4;                                                                                               /* return error */
+    }
+    
+    handle->mesh = NULL;                                                                                        /* stop the old mesh */
+    if (a_nrf24l01_spi_read(handle, NRF24L01_REG_SETUP_AW, &aw, 1) != 0)                                        /* get setup of address widths */
+    {
+        handle->debug_print("nrf24l01: get setup of address widths failed.\n");                                 /* get setup of address widths failed */
+       
+        return 1;                                                                                               /* return error */
+    }
+    if ((aw & 0x03) == 0)                                                                                       /* check width */
+    {
+        handle->debug_print("nrf24l01: mesh is invalid.\n");                                                    /* mesh is invalid */
+       
+        return 4;                                                                                               /* return error */
+    }
+    mesh->width = (uint8_t)((aw & 0x03) + 2);                                                                   /* set the address width */
+    if (a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_ADDR_P1, mesh->base, mesh->width) != 0)                     /* get rx pipe 1 address */
+    {
+        handle->debug_print("nrf24l01: get receive address data pipe p1 register failed.\n");                   /* get receive address data pipe p1 register failed */
+       
+        return 1;                                                                                               /* return error */
+    }
+    for (i = 0; i < route_num; i++)                                                                             /* clear the route cache */
+    {
+        route[i].dst = NRF24L01_MESH_NONE;                                                                      /* no destination */
+        route[i].next = NRF24L01_MESH_NONE;                                                                     /* free */
+    }
+    mesh->frame = frame;                                                                                        /* set the forward queue */
+    mesh->depth = depth;                                                                                        /* set the depth */
+    mesh->head = 0;                                                                                             /* init 0 */
+    mesh->tail = 0;                                                                                             /* init 0 */
+    mesh->route = route;                                                                                        /* set the route cache */
+    mesh->route_num = route_num;                                                                                /* set the route cache size */
+    mesh->route_next = 0;                                                                                       /* init 0 */
+    mesh->address = address;                                                                                    /* set the node address */
+    mesh->parent = parent;                                                                                      /* set the parent */
+    mesh->delivered = 0;                                                                                        /* init 0 */
+    mesh->forwarded = 0;                                                                                        /* init 0 */
+    mesh->dropped = 0;                                                                                          /* init 0 */
+    mesh->failed = 0;                                                                                           /* init 0 */
+    mesh->callback = NULL;                                                                                      /* no message handler */
+    mesh->param = NULL;                                                                                         /* no handler parameter */
+    mesh->enable = 0;                                                                                           /* not routing yet */
+    NRF24L01_MEMORY_BARRIER();                                                                                  /* fill before the publish */
+    handle->mesh = mesh;                                                                                        /* set the mesh */
+    
+    if (handle->gpio_write(handle->user_data, 0) != 0)                                                          /* gpio write */
+    {
+        handle->debug_print("nrf24l01: gpio write failed.\n");                                                  /* gpio write failed */
+       
+        return 1;                                                                                               /* return error */
+    }
+    a_nrf24l01_mesh_address(handle, address, 1, addr);                                                          /* build the pipe 1 address */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_ADDR_P1, addr, mesh->width);                             /* set rx pipe 1 address */
+    for (p = 2; p < 6; p++)                                                                                     /* pipe 2 - 5 */
+    {
+        addr[0] = (uint8_t)(NRF24L01_MESH_PIPE_BYTE + p);                                                       /* set the pipe byte */
+        res |= a_nrf24l01_spi_write(handle, (uint8_t)(NRF24L01_REG_RX_ADDR_P1 + p - 1), addr, 1);               /* set rx pipe 2 - 5 address */
+    }
+    en = 0x3E;                                                                                                  /* enable pipe 1 - 5 */
+    res |= a_nrf24l01_spi_update(handle, NRF24L01_REG_EN_RXADDR, &en, 1, 0x3E);                                 /* update enabled rx addresses */
+    if (handle->gpio_write(handle->user_data, 1) != 0)                                                          /* gpio write */
+    {
+        handle->debug_print("nrf24l01: gpio write failed.\n");                                                  /* gpio write failed */
+       
+        return 1;                                                                                               /* return error */
+    }
+    if (res != 0)                                                                                               /* check result */
+    {
+        handle->debug_print("nrf24l01: set mesh failed.\n");                                                    /* set mesh failed */
+       
+        return 1;                                                                                               /* return error */
+    }
+    mesh->enable = 1;                                                                                           /* enable the mesh */
+    
+    return 0;                                                                                                   /* success return 0 */
+}
+
+/**
+ * @brief     set the mesh message handler
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *callback pointer to a message handler, NULL drops the messages
+ * @param[in] *param pointer to the handler parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 mesh is not set
+ * @note      the handler runs in the irq handler with the message in the read buffer
+ */
+uint8_t nrf24l01_set_mesh_handler(nrf24l01_handle_t *handle,
+                                  void (*callback)(uint16_t from, uint8_t *buf, uint8_t len, void *param), void *param)
+{
+    if (handle == NULL)                                            /* check handle */
+    {
+        return 2;                                                  /* return error */
+    }
+    if (handle->inited != 1)                                       /* check handle initialization */
+    {
+        return 3;                                                  /* return error */
+    }
+    if (handle->mesh == NULL)                                      /* check the mesh */
+    {
+        handle->debug_print("nrf24l01: mesh is not set.\n");       /* mesh is not set */
+       
+        return 4;                                                  /* return error */
+    }
+    
+    handle->mesh->callback = callback;                             /* set the callback */
+    handle->mesh->param = param;                                   /* set the callback parameter */
+    
+    return 0;                                                      /* success return 0 */
+}
+
+/**
+ * @brief     send a message over the tree network
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] to destination address
+ * @param[in] *buf pointer to a message buffer
+ * @param[in] len message length
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is over 25
+ *            - 5 no route
+ * @note      the message goes to the cached next hop, then to the parent, only the first hop is
+ *            acknowledged
+ */
+uint8_t nrf24l01_mesh_send(nrf24l01_handle_t *handle, uint16_t to, uint8_t *buf, uint8_t len)
+{
+    uint8_t res;
+    uint16_t next;
+    uint8_t frame[32];
+    
+    if (handle == NULL)                                                                           /* check handle */
+    {
+        return 2;                                                                                 /* return error */
+    }
+    if (handle->inited != 1)                                                                      /* check handle initialization */
+    {
+        return 3;                                                                                 /* return error */
+    }
+    if (len > NRF24L01_MESH_PAYLOAD)                                                              /* check length */
+    {
+        handle->debug_print("nrf24l01: len is over 25.\n");                                       /* len is over 25 */
+       
+        return 4;                                                                                 /* return error */
+    }
+    next = NRF24L01_MESH_NONE;                                                                    /* init none */
+    if ((handle->mesh != NULL) && (handle->mesh->enable != 0) && (to != handle->mesh->address))   /* check mesh and destination */
+    {
+        next = a_nrf24l01_mesh_next(handle, to);                                                  /* get the next hop */
+    }
+    if (next == NRF24L01_MESH_NONE)                                                               /* check route */
+    {
+        handle->debug_print("nrf24l01: no route.\n");                                             /* no route */
+       
+        return 5;                                                                                 /* return error */
+    }
+    
+    frame[0] = (uint8_t)(to & 0xFF);                                                              /* set the destination lsb */
+    frame[1] = (uint8_t)((to >> 8) & 0xFF);                                                       /* set the destination msb */
+    frame[2] = (uint8_t)(handle->mesh->address & 0xFF);                                           /* set the source lsb */
+    frame[3] = (uint8_t)((handle->mesh->address >> 8) & 0xFF);                                    /* set the source msb */
+    frame[4] = frame[2];                                                                          /* set the last hop lsb */
+    frame[5] = frame[3];                                                                          /* set the last hop msb */
+    frame[6] = NRF24L01_MESH_TTL;                                                                 /* set the ttl */
+    memcpy(&frame[NRF24L01_MESH_HEADER], buf, len);                                               /* copy the message */
+    res = a_nrf24l01_mesh_send(handle, next, frame, (uint8_t)(len + NRF24L01_MESH_HEADER));       /* send the frame */
+    if (res != 0)                                                                                 /* check result */
+    {
+        handle->mesh->failed++;                                                                   /* failed++ */
+        handle->debug_print("nrf24l01: mesh send failed.\n");                                     /* mesh send failed */
+       
+        return 1;                                                                                 /* return error */
+    }
+    
+    return 0;                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief     send the queued forward frames
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 mesh update failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it from the main loop, the receive path routes the frames in the queue slots they
+ *            were read into and the update writes them to the tx fifo from there
+ */
+uint8_t nrf24l01_mesh_update(nrf24l01_handle_t *handle)
+{
+    uint8_t res;
+    nrf24l01_mesh_frame_t *frame;
+    
+    if (handle == NULL)                                                                     /* check handle */
+    {
+        return 2;                                                                           /* return error */
+    }
+    if (handle->inited != 1)                                                                /* check handle initialization */
+    {
+        return 3;                                                                           /* return error */
+    }
+    if ((handle->mesh == NULL) || (handle->mesh->enable == 0) || (handle->sending != 0))    /* check mesh and sending */
+    {
+        return 0;                                                                           /* success return 0 */
+    }
+    
+    while (handle->mesh->tail != handle->mesh->head)                                        /* send the queued frames */
+    {
+        frame = &handle->mesh->frame[handle->mesh->tail];                                   /* get the oldest frame */
+        res = a_nrf24l01_mesh_send(handle, frame->next, frame->buf, frame->len);            /* send from the slot */
+        if (res == 1)                                                                       /* check result */
+        {
+            handle->debug_print("nrf24l01: mesh update failed.\n");                         /* mesh update failed */
+           
+            return 1;                                                                       /* return error */
+        }
+        else if (res == 2)                                                                  /* check send */
+        {
+            handle->mesh->failed++;                                                         /* failed++ */
+        }
+        else
+        {
+            /* do nothing */
+        }
+        handle->mesh->tail = (uint16_t)((handle->mesh->tail + 1) % handle->mesh->depth);    /* free the slot */
+    }
+    
+    return 0;                                                                               /* success return 0 */
+}
+
+/**
+ * @brief      get the tree network status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *delivered pointer to a delivered messages buffer
+ * @param[out] *forwarded pointer to a forwarded frames buffer
+ * @param[out] *dropped pointer to a dropped frames buffer
+ * @param[out] *failed pointer to a failed sends buffer
  * @return     status code
  *             - 0 success
- *             - 1 spi read failed
- * @note       none
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 mesh is not set
+ * @note       frames are dropped when the queue is full, the ttl expires or there is no route
  */
-static uint8_t a_nrf24l01_spi_read(nrf24l01_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+uint8_t nrf24l01_get_mesh_status(nrf24l01_handle_t *handle, uint32_t *delivered, uint32_t *forwarded,
+                                 uint32_t *dropped, uint32_t *failed)
 {
-    if (handle->spi_read(NRF24L01_COMMAND_R_REGISTER | reg, buf, len) != 0)   /* spi read */
+    if (handle == NULL)                                            /* check handle */
     {
-        return 1;                                                             /* return error */
+        return 2;                                                  /* return error */
     }
-    else
+    if (handle->inited != 1)                                       /* check handle initialization */
+    {
+        return 3;                                                  /* return error */
+    }
+    if (handle->mesh == NULL)                                      /* check the mesh */
     {
-        return 0;                                                             /* success return 0 */
+        handle->debug_print("nrf24l01: mesh is not set.\n");       /* mesh is not set */
+       
+        return 4;                                                  /* return error */
     }
+    
+    *delivered = handle->mesh->delivered;                          /* get the delivered messages */
+    *forwarded = handle->mesh->forwarded;                          /* get the forwarded frames */
+    *dropped = handle->mesh->dropped;                              /* get the dropped frames */
+    *failed = handle->mesh->failed;                                /* get the failed sends */
+    
+    return 0;                                                      /* success return 0 */
 }
 
 /**
- * @brief     write bytes
+ * @brief     set the time sync role
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] reg register address
- * @param[in] *buf pointer to a data buffer
- * @param[in] len data length
+ * @param[in] *sync pointer to a caller allocated sync state, NULL stops the time sync
+ * @param[in] role sync role
+ * @param[in] pipe beacon pipe of the slave
  * @return    status code
  *            - 0 success
- *            - 1 spi write failed
- * @note      none
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ *            - 5 pipe is invalid
+ * @note      the master sends the beacons with no ack so its tx_ds and the rx_dr of the slaves mark
+ *            the same air time, enable the tx payload with no ack on the master and give the
+ *            beacons a pipe of their own on the slaves, setting a role clears the estimate
  */
-static uint8_t a_nrf24l01_spi_write(nrf24l01_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+uint8_t nrf24l01_set_sync(nrf24l01_handle_t *handle, nrf24l01_sync_t *sync, nrf24l01_sync_role_t role, uint8_t pipe)
 {
-    if (handle->spi_write(NRF24L01_COMMAND_W_REGISTER | reg, buf, len) != 0)   /* spi write */
+    if (handle == NULL)                                                 /* check handle */
     {
-        return 1;                                                              /* return error */
+        return 2;                                                       /* return error */
     }
-    else
+    if (handle->inited != 1)                                            /* check handle initialization */
+    {
+        return 3;                                                       /* return error */
+    }
+    if ((sync == NULL) || (role == NRF24L01_SYNC_ROLE_NONE))            /* stop */
+    {
+        handle->sync = NULL;                                            /* disable the time sync */
+        
+        return 0;                                                       /* success return 0 */
+    }
+    if (handle->timestamp_us == NULL)                                   /* check timestamp_us */
     {
-        return 0;                                                              /* success return 0 */
+        handle->debug_print("nrf24l01: timestamp_us is null.\n");       /* timestamp_us is null */
+       
+        return 4;                                                       /* return error */
+    }
+    if (pipe > 5)                                                       /* check pipe */
+    {
+        handle->debug_print("nrf24l01: pipe is invalid.\n");            /* pipe is invalid */
+       
+        return 5;                                                       /* return error */
     }
+    
+    handle->sync = NULL;                                                /* stop the old time sync */
+    memset(sync, 0, sizeof(nrf24l01_sync_t));                           /* clear the estimate */
+    sync->pipe = pipe;                                                  /* set the pipe */
+    sync->role = (uint8_t)role;                                         /* set the role */
+    NRF24L01_MEMORY_BARRIER();                                          /* fill before the publish */
+    handle->sync = sync;                                                /* set the time sync */
+    
+    return 0;                                                           /* success return 0 */
 }
 
 /**
- * @brief     initialize the chip
+ * @brief     set the timestamp of the irq edge
  * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] us irq falling edge time on the timestamp_us clock
  * @return    status code
  *            - 0 success
- *            - 1 spi initialization failed
  *            - 2 handle is NULL
- *            - 3 linked functions is NULL
- *            - 4 gpio init failed
- * @note      none
+ *            - 3 handle is not initialized
+ * @note      call it right before nrf24l01_irq_handler when the platform stamps the edge, the
+ *            irq handler reads timestamp_us on entry otherwise, the edge is dropped without a time
+ *            sync
  */
-uint8_t nrf24l01_init(nrf24l01_handle_t *handle)
+uint8_t nrf24l01_set_irq_timestamp(nrf24l01_handle_t *handle, uint32_t us)
 {
-    if (handle == NULL)                                                      /* check handle */
+    if (handle == NULL)                 /* check handle */
     {
-        return 2;                                                            /* return error */
+        return 2;                       /* return error */
     }
-    if (handle->debug_print == NULL)                                         /* check debug_print */
+    if (handle->inited != 1)            /* check handle initialization */
     {
-        return 3;                                                            /* return error */
+        return 3;                       /* return error */
     }
-    if (handle->spi_init == NULL)                                            /* check spi_init */
+    if (handle->sync == NULL)           /* check time sync */
     {
-        handle->debug_print("nrf24l01: spi_init is null.\n");                /* spi_init is null */
-       
-        return 3;                                                            /* return error */
+        return 0;                       /* success return 0 */
     }
-    if (handle->spi_deinit == NULL)                                          /* check spi_deinit */
+    
+    handle->sync->edge = us;            /* set the edge time */
+    handle->sync->edge_valid = 1;       /* set the edge flag */
+    
+    return 0;                           /* success return 0 */
+}
+
+/**
+ * @brief     send a time sync beacon
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 send beacon failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 role is not master
+ *            - 5 send is busy
+ * @note      every beacon carries the tx_ds time of the one before, the slaves get a sample from
+ *            the second beacon on
+ */
+uint8_t nrf24l01_sync_beacon(nrf24l01_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t buf[NRF24L01_SYNC_BEACON_LENGTH];
+    
+    if (handle == NULL)                                                                    /* check handle */
     {
-        handle->debug_print("nrf24l01: spi_deinit is null.\n");              /* spi_deinit is null */
-       
-        return 3;                                                            /* return error */
+        return 2;                                                                          /* return error */
     }
-    if (handle->spi_read == NULL)                                            /* check spi_read */
+    if (handle->inited != 1)                                                               /* check handle initialization */
     {
-        handle->debug_print("nrf24l01: spi_read is null.\n");                /* spi_read is null */
+        return 3;                                                                          /* return error */
+    }
+    if ((handle->sync == NULL) || (handle->sync->role != NRF24L01_SYNC_ROLE_MASTER))       /* check role */
+    {
+        handle->debug_print("nrf24l01: role is not master.\n");                            /* role is not master */
        
-        return 3;                                                            /* return error */
+        return 4;                                                                          /* return error */
     }
-    if (handle->spi_write == NULL)                                           /* check spi_write */
+    if (handle->sending != 0)                                                              /* check sending */
     {
-        handle->debug_print("nrf24l01: spi_write is null.\n");               /* spi_write is null */
+        handle->debug_print("nrf24l01: send is busy.\n");                                  /* send is busy */
        
-        return 3;                                                            /* return error */
+        return 5;                                                                          /* return error */
     }
-    if (handle->gpio_init == NULL)                                           /* check gpio_init */
+    
+    handle->sync->sequence++;                                                              /* sequence++ */
+    buf[0] = handle->sync->sequence;                                                       /* set the sequence */
+    buf[1] = handle->sync->stamped;                                                        /* set the valid flag */
+    buf[2] = (uint8_t)(handle->sync->stamp & 0xFF);                                        /* set the last tx_ds time */
+    buf[3] = (uint8_t)((handle->sync->stamp >> 8) & 0xFF);                                 /* set the last tx_ds time */
+    buf[4] = (uint8_t)((handle->sync->stamp >> 16) & 0xFF);                                /* set the last tx_ds time */
+    buf[5] = (uint8_t)((handle->sync->stamp >> 24) & 0xFF);                                /* set the last tx_ds time */
+    handle->sync->stamped = 0;                                                             /* wait for the tx_ds of this beacon */
+    handle->sync->pending = 1;                                                             /* beacon in flight */
+    res = a_nrf24l01_send_start(handle, NRF24L01_COMMAND_W_TX_PAYLOAD_NO_ACK, buf,
+                                NRF24L01_SYNC_BEACON_LENGTH, NULL, NULL);                  /* send the beacon */
+    if (res == 5)                                                                          /* check busy */
+    {
+        handle->sync->pending = 0;                                                         /* no beacon in flight */
+        handle->sync->stamped = buf[1];                                                    /* keep the last tx_ds time */
+        handle->sync->sequence--;                                                          /* sequence-- */
+        
+        return 5;                                                                          /* return error */
+    }
+    else if (res != 0)                                                                     /* check result */
     {
-        handle->debug_print("nrf24l01: gpio_init is null.\n");               /* gpio_init is null */
+        handle->sync->pending = 0;                                                         /* no beacon in flight */
+        handle->debug_print("nrf24l01: send beacon failed.\n");                            /* send beacon failed */
        
-        return 3;                                                            /* return error */
+        return 1;                                                                          /* return error */
     }
-    if (handle->gpio_deinit == NULL)                                         /* check gpio_deinit */
+    
+    return 0;                                                                              /* success return 0 */
+}
+
+/**
+ * @brief      convert a local time to the master time
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  local local time on the timestamp_us clock
+ * @param[out] *master pointer to a master time buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 not synchronized
+ * @note       the master gets its own time, the slave applies the offset and the drift from the
+ *             last sample
+ */
+uint8_t nrf24l01_sync_get_time(nrf24l01_handle_t *handle, uint32_t local, uint32_t *master)
+{
+    int64_t drift;
+    
+    if (handle == NULL)                                                                                              /* check handle */
     {
-        handle->debug_print("nrf24l01: gpio_deinit is null.\n");             /* gpio_deinit is null */
+        return 2;                                                                                                    /* return error */
+    }
+    if (handle->inited != 1)                                                                                         /* check handle initialization */
+    {
+        return 3;                                                                                                    /* return error */
+    }
+    if (handle->sync == NULL)                                                                                        /* check time sync */
+    {
+        return 4;                                                                                                    /* return error */
+    }
+    if (handle->sync->role == NRF24L01_SYNC_ROLE_MASTER)                                                             /* check master */
+    {
+        *master = local;                                                                                             /* the master time */
+        
+        return 0;                                                                                                    /* success return 0 */
+    }
+    if ((handle->sync->role != NRF24L01_SYNC_ROLE_SLAVE) || (handle->sync->samples == 0))                            /* check samples */
+    {
+        return 4;                                                                                                    /* return error */
+    }
+    
+    drift = ((int64_t)handle->sync->drift * (int64_t)(int32_t)(local - handle->sync->reference)) / 1000000000;       /* get the drift since the sample */
+    *master = local + handle->sync->offset + (uint32_t)(int32_t)drift;                                               /* convert the time */
+    
+    return 0;                                                                                                        /* success return 0 */
+}
+
+/**
+ * @brief      get the time sync status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *offset pointer to an offset buffer in us
+ * @param[out] *drift pointer to a drift buffer in ppb
+ * @param[out] *error pointer to a last prediction error buffer in us
+ * @param[out] *samples pointer to a samples buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 sync is not set
+ * @note       the error is the last sample minus the time predicted from the sample before
+ */
+uint8_t nrf24l01_get_sync_status(nrf24l01_handle_t *handle, int32_t *offset, int32_t *drift,
+                                 int32_t *error, uint32_t *samples)
+{
+    if (handle == NULL)                                            /* check handle */
+    {
+        return 2;                                                  /* return error */
+    }
+    if (handle->inited != 1)                                       /* check handle initialization */
+    {
+        return 3;                                                  /* return error */
+    }
+    if (handle->sync == NULL)                                      /* check time sync */
+    {
+        handle->debug_print("nrf24l01: sync is not set.\n");       /* sync is not set */
        
-        return 3;                                                            /* return error */
+        return 4;                                                  /* return error */
     }
-    if (handle->gpio_write == NULL)                                          /* check gpio_write */
+    
+    *offset = (int32_t)handle->sync->offset;                       /* get the offset */
+    *drift = handle->sync->drift;                                  /* get the drift */
+    *error = handle->sync->error;                                  /* get the error */
+    *samples = handle->sync->samples;                              /* get the samples */
+    
+    return 0;                                                      /* success return 0 */
+}
+
+/**
+ * @brief     start or stop the tdma slots
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *tdma pointer to a caller allocated tdma state, NULL stops the slots
+ * @param[in] *table pointer to a slot owner table, NULL stops the slots
+ * @param[in] num slot number
+ * @param[in] node own node
+ * @param[in] slot_us slot length in us
+ * @param[in] margin_us time sync margin in us
+ * @return    status code
+ *            - 0 success
+ *            - 1 set tdma failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ *            - 5 tdma is invalid
+ *            - 6 tx ring is not set
+ * @note      the node sends the tx ring only in the slots it owns, the table must stay valid while
+ *            the slots run, a frame is loaded when the send deadline of a full frame for it and
+ *            every frame before it plus the margin fits before the slot end, the slots follow the
+ *            master time once the time sync has a sample
+ */
+uint8_t nrf24l01_set_tdma(nrf24l01_handle_t *handle, nrf24l01_tdma_t *tdma, const uint16_t *table, uint8_t num, uint16_t node,
+                          uint32_t slot_us, uint32_t margin_us)
+{
+    uint32_t frame;
+    
+    if (handle == NULL)                                                 /* check handle */
     {
-        handle->debug_print("nrf24l01: gpio_write is null.\n");              /* gpio_write is null */
+        return 2;                                                       /* return error */
+    }
+    if (handle->inited != 1)                                            /* check handle initialization */
+    {
+        return 3;                                                       /* return error */
+    }
+    
+    handle->tdma = NULL;                                                /* stop the slots */
+    if ((tdma == NULL) || (table == NULL))                              /* check table */
+    {
+        return 0;                                                       /* success return 0 */
+    }
+    if (handle->timestamp_us == NULL)                                   /* check timestamp_us */
+    {
+        handle->debug_print("nrf24l01: timestamp_us is null.\n");       /* timestamp_us is null */
        
-        return 3;                                                            /* return error */
+        return 4;                                                       /* return error */
     }
-    if (handle->delay_ms == NULL)                                            /* check delay_ms */
+    if ((num == 0) || (slot_us == 0))                                   /* check num and slot */
     {
-        handle->debug_print("nrf24l01: delay_ms is null.\n");                /* delay_ms is null */
+        handle->debug_print("nrf24l01: tdma is invalid.\n");            /* tdma is invalid */
        
-        return 3;                                                            /* return error */
+        return 5;                                                       /* return error */
     }
-    if (handle->receive_callback == NULL)                                    /* check receive_callback */
+    if (handle->tx_ring == NULL)                                        /* check the ring */
     {
-        handle->debug_print("nrf24l01: receive_callback is null.\n");        /* receive_callback is null */
+        handle->debug_print("nrf24l01: tx ring is not set.\n");         /* tx ring is not set */
        
-        return 3;                                                            /* return error */
+        return 6;                                                       /* return error */
     }
-    
-    if (handle->gpio_init() != 0)                                            /* gpio init */
+    if (nrf24l01_get_send_deadline(handle, 32, &frame) != 0)            /* get the full frame deadline */
     {
-        handle->debug_print("nrf24l01: gpio init failed.\n");                /* gpio init failed */
+        handle->debug_print("nrf24l01: set tdma failed.\n");            /* set tdma failed */
        
-        return 4;                                                            /* return error */
+        return 1;                                                       /* return error */
     }
-    if (handle->spi_init() != 0)                                             /* spi init */
+    if ((frame + margin_us) > slot_us)                                  /* check one frame fits */
     {
-        handle->debug_print("nrf24l01: spi init failed.\n");                 /* spi init failed */
-        (void)handle->gpio_deinit();                                         /* gpio deinit */
-        
-        return 1;                                                            /* return error */
+        handle->debug_print("nrf24l01: tdma is invalid.\n");            /* tdma is invalid */
+       
+        return 5;                                                       /* return error */
     }
     
-    handle->inited = 1;                                                      /* flag finish initialization */
+    tdma->table = table;                                                /* set the table */
+    tdma->num = num;                                                    /* set the slot number */
+    tdma->node = node;                                                  /* set the node */
+    tdma->slot_us = slot_us;                                            /* set the slot length */
+    tdma->frame_us = frame;                                             /* set the frame time */
+    tdma->margin_us = margin_us;                                        /* set the margin */
+    tdma->slot = 0xFFFFFFFFU;                                           /* no slot used */
+    tdma->slots = 0;                                                    /* clear the used slots */
+    tdma->held = 0;                                                     /* clear the held frames */
+    tdma->mark = handle->tx_ring->load;                                 /* count the queued frames */
+    NRF24L01_MEMORY_BARRIER();                                          /* fill before the publish */
+    handle->tdma = tdma;                                                /* start the slots */
     
-    return 0;                                                                /* success return 0 */
+    return 0;                                                           /* success return 0 */
 }
 
 /**
- * @brief     close the chip
+ * @brief     update the tdma slots
  * @param[in] *handle pointer to an nrf24l01 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 nop failed
+ *            - 1 tdma update failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 gpio deinit failed
- *            - 5 spi deinit failed
- * @note      none
+ * @note      call it at least once per own slot, it loads the tx fifo from the tx ring when the
+ *            slot opens, the irq handler keeps loading the frames back to back until the slot ends
  */
-uint8_t nrf24l01_deinit(nrf24l01_handle_t *handle)
+uint8_t nrf24l01_tdma_update(nrf24l01_handle_t *handle)
 {
-    uint8_t res;
-    uint8_t prev;
+    uint32_t slot;
     
-    if (handle == NULL)                                                                 /* check handle */
+    if (handle == NULL)                                                      /* check handle */
     {
-        return 2;                                                                       /* return error */
+        return 2;                                                            /* return error */
     }
-    if (handle->inited != 1)                                                            /* check handle initialization */
+    if (handle->inited != 1)                                                 /* check handle initialization */
     {
-        return 3;                                                                       /* return error */
+        return 3;                                                            /* return error */
+    }
+    if ((handle->tdma == NULL) || (handle->tx_ring == NULL))                 /* check tdma */
+    {
+        return 0;                                                            /* success return 0 */
+    }
+    if ((handle->tx_ring->tail != handle->tx_ring->load) ||
+        (handle->tx_ring->load == handle->tx_ring->head))                    /* check the frames in flight and the queued frames */
+    {
+        return 0;                                                            /* success return 0 */
+    }
+    if (a_nrf24l01_tdma_fit(handle, 0) == 0)                                 /* check the slot */
+    {
+        return 0;                                                            /* success return 0 */
+    }
+    if (NRF24L01_CLAIM(handle->sending) == 0)                                /* claim the radio */
+    {
+        return 0;                                                            /* the sender in flight loads the frames */
     }
     
-    res = handle->spi_write(NRF24L01_COMMAND_NOP, NULL, 0);                             /* nop */
-    if (res != 0)                                                                       /* check result */
+    slot = a_nrf24l01_tdma_now(handle) / handle->tdma->slot_us;              /* get the slot */
+    if (slot != handle->tdma->slot)                                          /* check a new slot */
     {
-        handle->debug_print("nrf24l01: nop failed.\n");                                 /* nop failed */
-       
-        return 1;                                                                       /* return error */
+        handle->tdma->slot = slot;                                           /* set the slot */
+        handle->tdma->slots++;                                               /* slots++ */
     }
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_CONFIG, (uint8_t *)&prev, 1);        /* get config */
-    if (res != 0)                                                                       /* check result */
+    handle->finished = 0;                                                    /* clear finished */
+    handle->send_callback = NULL;                                            /* clear the callback */
+    if (handle->gpio_write(handle->user_data, 0) != 0)                       /* gpio write */
     {
-        handle->debug_print("nrf24l01: get config failed.\n");                          /* get config failed */
+        handle->sending = 0;                                                 /* release the radio */
+        handle->debug_print("nrf24l01: tdma update failed.\n");              /* tdma update failed */
        
-        return 1;                                                                       /* return error */
+        return 1;                                                            /* return error */
     }
-    prev &= ~(1 << 1);                                                                  /* clear config */
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_CONFIG, (uint8_t *)&prev, 1);       /* set config */
-    if (res != 0)                                                                       /* check result */
+    if (a_nrf24l01_tx_ring_fill(handle) != 0)                                /* load the tx fifo */
     {
-        handle->debug_print("nrf24l01: set config failed.\n");                          /* set config failed */
+        handle->sending = 0;                                                 /* release the radio */
+        (void)handle->gpio_write(handle->user_data, 1);                      /* set gpio */
+        handle->debug_print("nrf24l01: tdma update failed.\n");              /* tdma update failed */
        
-        return 1;                                                                       /* return error */
+        return 1;                                                            /* return error */
     }
-    res = handle->gpio_deinit();                                                        /* gpio deinit */
-    if (res != 0)                                                                       /* check result */
+    if (handle->tx_ring->load == handle->tx_ring->tail)                      /* nothing is loaded */
     {
-        handle->debug_print("nrf24l01: gpio deinit failed.\n");                         /* gpio deinit failed */
+        (void)a_nrf24l01_send_done(handle, NRF24L01_SEND_STATUS_HELD);       /* wait for the next slot */
+    }
+    if (handle->gpio_write(handle->user_data, 1) != 0)                       /* gpio write */
+    {
+        handle->debug_print("nrf24l01: tdma update failed.\n");              /* tdma update failed */
        
-        return 4;                                                                       /* return error */
+        return 1;                                                            /* return error */
     }
-    res = handle->spi_deinit();                                                         /* spi deinit */
-    if (res != 0)                                                                       /* check result */
+    
+    return 0;                                                                /* success return 0 */
+}
+
+/**
+ * @brief      get the tdma status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *slot pointer to a current slot buffer
+ * @param[out] *guard_us pointer to a guard time buffer in us
+ * @param[out] *slots pointer to a used slots buffer
+ * @param[out] *held pointer to a held frames buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 tdma is not started
+ * @note       the guard time is the send deadline of a full frame plus the margin
+ */
+uint8_t nrf24l01_get_tdma_status(nrf24l01_handle_t *handle, uint8_t *slot, uint32_t *guard_us,
+                                 uint32_t *slots, uint32_t *held)
+{
+    if (handle == NULL)                                                                                 /* check handle */
     {
-        handle->debug_print("nrf24l01: spi deinit failed.\n");                          /* spi deinit failed */
+        return 2;                                                                                       /* return error */
+    }
+    if (handle->inited != 1)                                                                            /* check handle initialization */
+    {
+        return 3;                                                                                       /* return error */
+    }
+    if (handle->tdma == NULL)                                                                           /* check tdma */
+    {
+        handle->debug_print("nrf24l01: tdma is not started.\n");                                        /* tdma is not started */
        
-        return 5;                                                                       /* return error */
+        return 4;                                                                                       /* return error */
     }
-    handle->inited = 0;                                                                 /* flag close */
     
-    return 0;                                                                           /* success return 0 */
+    *slot = (uint8_t)((a_nrf24l01_tdma_now(handle) / handle->tdma->slot_us) % handle->tdma->num);       /* get the slot */
+    *guard_us = handle->tdma->frame_us + handle->tdma->margin_us;                                       /* get the guard time */
+    *slots = handle->tdma->slots;                                                                       /* get the used slots */
+    *held = handle->tdma->held;                                                                         /* get the held frames */
+    
+    return 0;                                                                                           /* success return 0 */
 }
 
 /**
- * @brief     enable or disable the chip
+ * @brief     set the power state tracking
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] enable bool value
+ * @param[in] *power pointer to a caller allocated power state, NULL stops the tracking
  * @return    status code
  *            - 0 success
- *            - 1 set active failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 send is busy
+ * @note      the tracking carries nrf24l01_set_power_state, the next state set restarts the
+ *            residency counters
  */
-uint8_t nrf24l01_set_active(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
+uint8_t nrf24l01_set_power_tracking(nrf24l01_handle_t *handle, nrf24l01_power_t *power)
 {
-    if (handle == NULL)                                               /* check handle */
+    if (handle == NULL)                                         /* check handle */
     {
-        return 2;                                                     /* return error */
+        return 2;                                               /* return error */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if (handle->inited != 1)                                    /* check handle initialization */
     {
-        return 3;                                                     /* return error */
+        return 3;                                               /* return error */
     }
-    
-    if (handle->gpio_write(enable) != 0)                              /* gpio write */
+    if (handle->sending != 0)                                   /* check sending */
     {
-        handle->debug_print("nrf24l01: gpio write failed.\n");        /* gpio write failed */
+        handle->debug_print("nrf24l01: send is busy.\n");       /* send is busy */
        
-        return 1;                                                     /* return error */
+        return 4;                                               /* return error */
     }
     
-    return 0;                                                         /* success return 0 */
+    handle->power = NULL;                                       /* stop the tracking */
+    if (power == NULL)                                          /* check power */
+    {
+        return 0;                                               /* success return 0 */
+    }
+    memset(power, 0, sizeof(nrf24l01_power_t));                 /* clear the power state */
+    NRF24L01_MEMORY_BARRIER();                                  /* clear before the publish */
+    handle->power = power;                                      /* set the power state */
+    
+    return 0;                                                   /* success return 0 */
 }
 
 /**
- * @brief     send data
+ * @brief     set the power state
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] *buf pointer to a data buffer
- * @param[in] len buffer length
+ * @param[in] state power state
  * @return    status code
  *            - 0 success
- *            - 1 send failed
+ *            - 1 set power state failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 len is over 32
- *            - 5 send timeout
- * @note      none
+ *            - 4 timestamp_us is null
+ *            - 5 state is invalid
+ *            - 6 send is busy
+ *            - 7 power tracking is not set
+ * @note      one config write when pwr_up or prim_rx changes and one ce write when ce changes, it
+ *            waits the 1.5 ms start up time when leaving power down and the 130 us settling time
+ *            when entering rx or tx, link delay_us for us waits, the first call after
+ *            nrf24l01_set_power_tracking starts the residency counters and the irq handler keeps ce
+ *            low in power down and standby-I
  */
-uint8_t nrf24l01_send(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len)
+uint8_t nrf24l01_set_power_state(nrf24l01_handle_t *handle, nrf24l01_power_state_t state)
 {
-    uint8_t res;
-    uint8_t i;
-    uint8_t k;
-    uint8_t tmp;
-    uint8_t buffer[32];
-    uint32_t timeout;
+    uint8_t prev;
+    uint8_t config;
+    uint8_t ce_old;
+    uint8_t ce;
     
-    if (handle == NULL)                                                                    /* check handle */
+    if (handle == NULL)                                                                             /* check handle */
     {
-        return 2;                                                                          /* return error */
+        return 2;                                                                                   /* return error */
     }
-    if (handle->inited != 1)                                                               /* check handle initialization */
+    if (handle->inited != 1)                                                                        /* check handle initialization */
     {
-        return 3;                                                                          /* return error */
+        return 3;                                                                                   /* return error */
     }
-    if (len > 32)                                                                          /* check the result */
+    if (handle->timestamp_us == NULL)                                                               /* check timestamp_us */
     {
-        handle->debug_print("nrf24l01: len is over 32.\n");                                /* len is over 32 */
+        handle->debug_print("nrf24l01: timestamp_us is null.\n");                                   /* timestamp_us is null */
        
-        return 4;                                                                          /* return error */
+        return 4;                                                                                   /* return error */
     }
-
-    memcpy((uint8_t *)buffer, buf, len);                                                   /* copy the data */
-    k = len / 2;                                                                           /* get the half */
-    for (i = 0; i < k; i++)                                                                /* run k times */
+    if (state > NRF24L01_POWER_STATE_TX)                                                            /* check state */
     {
-        tmp = buffer[i];                                                                   /* copy to tmp */
-        buffer[i] = buffer[len - 1 - i];                                                   /* buffer[i] = buffer[n - 1 - i] */
-        buffer[len - 1 - i] = tmp;                                                         /* set buffer[n - 1 - i]*/
+        handle->debug_print("nrf24l01: state is invalid.\n");                                       /* state is invalid */
+       
+        return 5;                                                                                   /* return error */
     }
-    handle->finished = 0;                                                                  /* clear finished */
-    if (handle->gpio_write(0) != 0)                                                        /* gpio write */
+    if (handle->sending != 0)                                                                       /* check sending */
     {
-        handle->debug_print("nrf24l01: gpio write failed.\n");                             /* gpio write failed */
+        handle->debug_print("nrf24l01: send is busy.\n");                                           /* send is busy */
        
-        return 1;                                                                          /* return error */
+        return 6;                                                                                   /* return error */
     }
-    res = handle->spi_write(NRF24L01_COMMAND_W_TX_PAYLOAD, (uint8_t *)buffer, len);        /* set tx payload */
-    if (res != 0)                                                                          /* check result */
+    if (handle->power == NULL)                                                                      /* check the power tracking */
     {
-        handle->debug_print("nrf24l01: set tx payload failed.\n");                         /* set tx payload failed */
+        handle->debug_print("nrf24l01: power tracking is not set.\n");                              /* power tracking is not set */
        
-        return 1;                                                                          /* return error */
+        return 7;                                                                                   /* return error */
     }
-    if (handle->gpio_write(1) != 0)                                                        /* gpio write */
+    
+    if (a_nrf24l01_spi_read(handle, NRF24L01_REG_CONFIG, (uint8_t *)&prev, 1) != 0)                 /* get config */
     {
-        handle->debug_print("nrf24l01: gpio write failed.\n");                             /* gpio write failed */
+        handle->debug_print("nrf24l01: set power state failed.\n");                                 /* set power state failed */
        
-        return 1;                                                                          /* return error */
+        return 1;                                                                                   /* return error */
     }
-    timeout = 5000;                                                                        /* set timeout */
-    while ((timeout != 0) && (handle->finished == 0))                                      /* wait time */
+    config = prev;                                                                                  /* keep the other bits */
+    if (state == NRF24L01_POWER_STATE_POWER_DOWN)                                                   /* power down */
     {
-        handle->delay_ms(1);                                                               /* delay 1 ms */
-        timeout--;                                                                         /* timeout-- */
+        config &= ~(1 << 1);                                                                        /* clear pwr_up */
     }
-    if (timeout == 0)                                                                      /* check timeout */
+    else
     {
-        handle->debug_print("nrf24l01: send timeout.\n");                                  /* send timeout failed */
-       
-        return 5;                                                                          /* return error */
+        config |= (1 << 1);                                                                         /* set pwr_up */
+    }
+    if (state == NRF24L01_POWER_STATE_RX)                                                           /* rx */
+    {
+        config |= (1 << 0);                                                                         /* set prim_rx */
+    }
+    else if ((state == NRF24L01_POWER_STATE_STANDBY_2) || (state == NRF24L01_POWER_STATE_TX))       /* standby-II or tx */
+    {
+        config &= ~(1 << 0);                                                                        /* clear prim_rx */
+    }
+    else
+    {
+        /* do nothing */
+    }
+    ce = (state > NRF24L01_POWER_STATE_STANDBY_1) ? 1 : 0;                                          /* ce of the state */
+    ce_old = 1;                                                                                     /* unknown ce is driven */
+    if (handle->power->enable != 0)                                                                 /* check the power state */
+    {
+        ce_old = (handle->power->state > NRF24L01_POWER_STATE_STANDBY_1) ? 1 : 0;                   /* ce of the state */
+    }
+    if ((ce_old != 0) && ((ce == 0) || (config != prev) || (handle->power->enable == 0)))           /* check ce low */
+    {
+        if (handle->gpio_write(handle->user_data, 0) != 0)                                          /* gpio write */
+        {
+            handle->debug_print("nrf24l01: set power state failed.\n");                             /* set power state failed */
+           
+            return 1;                                                                               /* return error */
+        }
+        ce_old = 0;                                                                                 /* ce is low */
+    }
+    if (config != prev)                                                                             /* check config */
+    {
+        if (a_nrf24l01_spi_write(handle, NRF24L01_REG_CONFIG, (uint8_t *)&config, 1) != 0)          /* set config */
+        {
+            handle->debug_print("nrf24l01: set power state failed.\n");                             /* set power state failed */
+           
+            return 1;                                                                               /* return error */
+        }
+        if ((prev & (1 << 1)) == 0)                                                                 /* check power up */
+        {
+            a_nrf24l01_delay_us(handle, NRF24L01_POWER_UP_US);                                      /* wait the crystal oscillator */
+        }
+    }
+    if ((ce != 0) && (ce_old == 0))                                                                 /* check ce high */
+    {
+        if (handle->gpio_write(handle->user_data, 1) != 0)                                          /* gpio write */
+        {
+            handle->debug_print("nrf24l01: set power state failed.\n");                             /* set power state failed */
+           
+            return 1;                                                                               /* return error */
+        }
+        if (state != NRF24L01_POWER_STATE_STANDBY_2)                                                /* check rx or tx */
+        {
+            a_nrf24l01_settle(handle);                                                              /* wait the settling time */
+        }
     }
-    if (handle->finished == 1)                                                             /* check finished */
+    if (handle->power->enable == 0)                                                                 /* check the power state */
     {
-        return 0;                                                                          /* success return 0 */
+        memset(handle->power, 0, sizeof(nrf24l01_power_t));                                         /* clear the counters */
+        handle->power->state = (uint8_t)state;                                                      /* set the state */
+        handle->power->since = handle->timestamp_us();                                              /* set the transition time */
+        handle->power->enable = 1;                                                                  /* start tracking */
     }
     else
     {
-        handle->debug_print("nrf24l01: send failed.\n");                                   /* send failed */
+        a_nrf24l01_power_enter(handle, (uint8_t)state);                                             /* enter the state */
+    }
+    
+    return 0;                                                                                       /* success return 0 */
+}
+
+/**
+ * @brief      get the power state
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *state pointer to a power state buffer
+ * @param[out] *residency pointer to a 5 entry residency buffer in us, indexed by the power state
+ * @param[out] *transitions pointer to a transitions buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 power state is not set
+ * @note       a send counts as tx until it finishes and as standby-II after that, the start up and
+ *             settling waits count to the state left
+ */
+uint8_t nrf24l01_get_power_state(nrf24l01_handle_t *handle, nrf24l01_power_state_t *state,
+                                 uint64_t *residency, uint32_t *transitions)
+{
+    uint8_t i;
+    uint32_t now;
+    
+    if (handle == NULL)                                                                         /* check handle */
+    {
+        return 2;                                                                               /* return error */
+    }
+    if (handle->inited != 1)                                                                    /* check handle initialization */
+    {
+        return 3;                                                                               /* return error */
+    }
+    if ((handle->power == NULL) || (handle->power->enable == 0))                                /* check the power state */
+    {
+        handle->debug_print("nrf24l01: power state is not set.\n");                             /* power state is not set */
        
-        return 1;                                                                          /* return error */
+        return 4;                                                                               /* return error */
+    }
+    
+    now = (handle->timestamp_us != NULL) ? handle->timestamp_us() : handle->power->since;       /* get the time */
+    for (i = 0; i < 5; i++)                                                                     /* copy all states */
+    {
+        residency[i] = handle->power->residency[i];                                             /* get the residency */
     }
+    residency[handle->power->state] += now - handle->power->since;                              /* add the current state */
+    *state = (nrf24l01_power_state_t)handle->power->state;                                      /* get the state */
+    *transitions = handle->power->transitions;                                                  /* get the transitions */
+    
+    return 0;                                                                                   /* success return 0 */
 }
 
 /**
@@ -437,129 +6003,441 @@ uint8_t nrf24l01_irq_handler(nrf24l01_handle_t *handle)
 {
     uint8_t res;
     uint8_t prev;
+    uint8_t streaming;
+    uint8_t observe;
+    uint32_t sequence;
+    uint32_t edge;
+    uint8_t ce;
     
-    if (handle == NULL)                                                                                     /* check handle */
+    if (handle == NULL)                                                                                                              /* check handle */
     {
-        return 2;                                                                                           /* return error */
+        return 2;                                                                                                                    /* return error */
     }
-    if (handle->inited != 1)                                                                                /* check handle initialization */
+    if (handle->inited != 1)                                                                                                         /* check handle initialization */
     {
-        return 3;                                                                                           /* return error */
+        return 3;                                                                                                                    /* return error */
     }
     
-    res = handle->gpio_write(0);                                                                            /* set gpio */
-    if (res != 0)                                                                                           /* check result */
+    ce = 1;                                                                                                                          /* keep the chip active */
+    if ((handle->power != NULL) && (handle->power->enable != 0) &&
+        (handle->power->state <= NRF24L01_POWER_STATE_STANDBY_1))                                                                    /* check the power state */
     {
-        handle->debug_print("nrf24l01: gpio write failed.\n");                                              /* gpio write failed */
-       
-        return 1;                                                                                           /* return error */
+        ce = 0;                                                                                                                      /* keep the chip in standby-I */
+    }
+    edge = 0;                                                                                                                        /* init 0 */
+    if (handle->sync != NULL)                                                                                                        /* check time sync */
+    {
+        edge = (handle->sync->edge_valid != 0) ? handle->sync->edge : handle->timestamp_us();                                        /* get the edge time */
+        handle->sync->edge_valid = 0;                                                                                                /* the edge is used */
     }
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_STATUS, (uint8_t *)&prev, 1);                            /* get status register */
-    if (res != 0)                                                                                           /* check result */
+    res = handle->gpio_write(handle->user_data, 0);                                                                                  /* set gpio */
+    if (res != 0)                                                                                                                    /* check result */
     {
-        handle->debug_print("nrf24l01: get status register failed.\n");                                     /* get status register failed */
-        (void)handle->gpio_write(1);                                                                        /* set gpio */
+        handle->debug_print("nrf24l01: gpio write failed.\n");                                                                       /* gpio write failed */
        
-        return 1;                                                                                           /* return error */
+        return 1;                                                                                                                    /* return error */
     }
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_STATUS, (uint8_t *)&prev, 1);                           /* clear status register */
-    if (res != 0)                                                                                           /* check result */
+    if (handle->spi_transfer != NULL)                                                                                                /* check spi_transfer */
     {
-        handle->debug_print("nrf24l01: set status register failed.\n");                                     /* set status register failed */
-        (void)handle->gpio_write(1);                                                                        /* set gpio */
-        
-        return 1;                                                                                           /* return error */
+        res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_NOP, NULL, 0);                                                       /* get status with one byte */
+        if (res != 0)                                                                                                                /* check result */
+        {
+            handle->debug_print("nrf24l01: get status register failed.\n");                                                          /* get status register failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                                                         /* set gpio */
+           
+            return 1;                                                                                                                /* return error */
+        }
+        prev = handle->status;                                                                                                       /* status before clearing */
+        res = a_nrf24l01_spi_write(handle, NRF24L01_REG_STATUS, (uint8_t *)&prev, 1);                                                /* clear only the seen flags */
+        if (res != 0)                                                                                                                /* check result */
+        {
+            handle->debug_print("nrf24l01: set status register failed.\n");                                                          /* set status register failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                                                         /* set gpio */
+            
+            return 1;                                                                                                                /* return error */
+        }
+    }
+    else
+    {
+        res = a_nrf24l01_spi_read(handle, NRF24L01_REG_STATUS, (uint8_t *)&prev, 1);                                                 /* get status register */
+        if (res != 0)                                                                                                                /* check result */
+        {
+            handle->debug_print("nrf24l01: get status register failed.\n");                                                          /* get status register failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                                                         /* set gpio */
+           
+            return 1;                                                                                                                /* return error */
+        }
+        res = a_nrf24l01_spi_write(handle, NRF24L01_REG_STATUS, (uint8_t *)&prev, 1);                                                /* clear status register */
+        if (res != 0)                                                                                                                /* check result */
+        {
+            handle->debug_print("nrf24l01: set status register failed.\n");                                                          /* set status register failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                                                         /* set gpio */
+            
+            return 1;                                                                                                                /* return error */
+        }
     }
     
-    if (((prev >> 0) & 0x01) != 0)                                                                          /* tx full */
+    if (((prev >> 0) & 0x01) != 0)                                                                                                   /* tx full */
     {
-        if (handle->receive_callback != NULL)                                                               /* if receive callback */
+        if (handle->receive_callback != NULL)                                                                                        /* if receive callback */
         {
-            handle->receive_callback(NRF24L01_INTERRUPT_TX_FULL, 0, NULL, 0);                               /* run receive callback */
+            handle->receive_callback(handle->user_data, NRF24L01_INTERRUPT_TX_FULL, 0, NULL, 0);                                     /* run receive callback */
         }
     }
-    if (((prev >> 4) & 0x01) != 0)                                                                          /* max rt */
+    streaming = 0;                                                                                                                   /* init 0 */
+    sequence = handle->tx_sequence;                                                                                                  /* sequence before the tx update */
+    if ((handle->stream != NULL) && (handle->stream->enable != 0) && (((prev >> 4) & 0x03) != 0))                                    /* check stream */
     {
-        res = handle->spi_write(NRF24L01_COMMAND_FLUSH_TX, NULL, 0);                                        /* flush tx */
-        if (res != 0)                                                                                       /* check result */
+        streaming = 1;                                                                                                               /* set streaming */
+        res = a_nrf24l01_stream_update(handle, prev);                                                                                /* update the stream */
+        if (res != 0)                                                                                                                /* check result */
         {
-            handle->debug_print("nrf24l01: flush tx failed.\n");                                            /* flush tx failed */
-            (void)handle->gpio_write(1);                                                                    /* set gpio */
+            handle->debug_print("nrf24l01: stream update failed.\n");                                                                /* stream update failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                                                         /* set gpio */
             
-            return 1;                                                                                       /* return error */
+            return 1;                                                                                                                /* return error */
+        }
+    }
+    else if ((handle->tx_ring != NULL) && (handle->tx_ring->tail != handle->tx_ring->load) &&
+             (((prev >> 4) & 0x03) != 0))                                                                                            /* check tx ring */
+    {
+        streaming = 1;                                                                                                               /* set streaming */
+        res = a_nrf24l01_tx_ring_update(handle, prev);                                                                               /* update the tx ring */
+        if (res != 0)                                                                                                                /* check result */
+        {
+            handle->debug_print("nrf24l01: tx ring update failed.\n");                                                               /* tx ring update failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                                                         /* set gpio */
+            
+            return 1;                                                                                                                /* return error */
+        }
+    }
+    else
+    {
+        /* do nothing */
+    }
+    if (((prev >> 4) & 0x01) != 0)                                                                                                   /* max rt */
+    {
+        a_nrf24l01_stats_tx(handle, 2, 0);                                                                                           /* max_rt++ */
+        if (streaming == 0)                                                                                                          /* not streaming */
+        {
+            res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_TX, NULL, 0);                                              /* flush tx */
+            if (res != 0)                                                                                                            /* check result */
+            {
+                handle->debug_print("nrf24l01: flush tx failed.\n");                                                                 /* flush tx failed */
+                (void)handle->gpio_write(handle->user_data, ce);                                                                     /* set gpio */
+                
+                return 1;                                                                                                            /* return error */
+            }
+            (void)a_nrf24l01_send_done(handle, NRF24L01_SEND_STATUS_MAX_RT);                                                         /* send done */
+        }
+        if ((handle->sync != NULL) && (handle->sync->pending != 0))                                                                  /* check the beacon */
+        {
+            handle->sync->pending = 0;                                                                                               /* beacon lost */
+            handle->sync->stamped = 0;                                                                                               /* no tx_ds time */
+        }
+        if (handle->receive_callback != NULL)                                                                                        /* if receive callback */
+        {
+            handle->receive_callback(handle->user_data, NRF24L01_INTERRUPT_MAX_RT, 0, NULL, 0);                                      /* run receive callback */
+        }
+        if ((handle->dispatch != NULL) && (handle->dispatch->max_rt != NULL))                                                        /* if max rt hook */
+        {
+            handle->dispatch->max_rt(handle->dispatch->param);                                                                       /* run max rt hook */
+        }
+    }
+    if (((prev >> 5) & 0x01) != 0)                                                                                                   /* send ok */
+    {
+        a_nrf24l01_stats_tx(handle, 1, 0);                                                                                           /* tx_ds++ */
+        if (streaming == 0)                                                                                                          /* not streaming */
+        {
+            if ((handle->sending != 0) && ((handle->sync == NULL) || (handle->sync->pending == 0)))                                  /* check sending */
+            {
+                handle->tx_sequence++;                                                                                               /* sequence++ */
+            }
+            (void)a_nrf24l01_send_done(handle, NRF24L01_SEND_STATUS_OK);                                                             /* send done */
+        }
+        if ((handle->sync != NULL) && (handle->sync->pending != 0))                                                                  /* check the beacon */
+        {
+            handle->sync->pending = 0;                                                                                               /* beacon sent */
+            handle->sync->stamp = edge;                                                                                              /* set the tx_ds time */
+            handle->sync->stamped = 1;                                                                                               /* set the stamp flag */
+        }
+        if (handle->receive_callback != NULL)                                                                                        /* if receive callback */
+        {
+            handle->receive_callback(handle->user_data, NRF24L01_INTERRUPT_TX_DS, 0, NULL, 0);                                       /* run receive callback */
+        }
+        if ((handle->dispatch != NULL) && (handle->dispatch->tx_ds != NULL))                                                         /* if tx ds hook */
+        {
+            handle->dispatch->tx_ds(handle->dispatch->param);                                                                        /* run tx ds hook */
+        }
+    }
+    if (((handle->tuner != NULL) || (handle->stats_detail != 0)) &&
+        ((prev & ((1 << 5) | (1 << 4))) != 0))                                                                                       /* sample the send */
+    {
+        res = a_nrf24l01_spi_read(handle, NRF24L01_REG_OBSERVE_TX, (uint8_t *)&observe, 1);                                          /* get transmit observe register */
+        if (res != 0)                                                                                                                /* check result */
+        {
+            handle->debug_print("nrf24l01: get transmit observe register failed.\n");                                                /* get transmit observe register failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                                                         /* set gpio */
+            
+            return 1;                                                                                                                /* return error */
+        }
+        observe &= 0x0F;                                                                                                             /* get arc count */
+        if (((prev >> 5) & 0x01) != 0)                                                                                               /* send ok */
+        {
+            a_nrf24l01_stats_tx(handle, 3, observe);                                                                                 /* histogram++ */
         }
-        handle->finished = 2;                                                                               /* set timeout */
-        if (handle->receive_callback != NULL)                                                               /* if receive callback */
+        if ((handle->tuner != NULL) &&
+            (a_nrf24l01_tuner_update(handle->tuner, (uint8_t)((prev >> 4) & 0x01), observe) != 0))                                   /* update the tuner */
         {
-            handle->receive_callback(NRF24L01_INTERRUPT_MAX_RT, 0, NULL, 0);                                /* run receive callback */
+            observe = (uint8_t)((handle->tuner->delay << 4) | handle->tuner->count);                                                 /* set the new delay and count */
+            res = a_nrf24l01_spi_write(handle, NRF24L01_REG_SETUP_RETR, (uint8_t *)&observe, 1);                                     /* set setup of automatic retransmission */
+            if (res != 0)                                                                                                            /* check result */
+            {
+                handle->debug_print("nrf24l01: set auto retransmit failed.\n");                                                      /* set auto retransmit failed */
+                (void)handle->gpio_write(handle->user_data, ce);                                                                     /* set gpio */
+                
+                return 1;                                                                                                            /* return error */
+            }
         }
     }
-    if (((prev >> 5) & 0x01) != 0)                                                                          /* send ok */
+    NRF24L01_MEMORY_BARRIER();                                                                                                       /* clear sending before reading the index */
+    if ((handle->tx_ring != NULL) && (handle->tx_ring->load != handle->tx_ring->head) &&
+        (NRF24L01_CLAIM(handle->sending) != 0))                                                                                      /* check and claim the queued frames */
     {
-        handle->finished = 1;                                                                               /* set finished */
-        if (handle->receive_callback != NULL)                                                               /* if receive callback */
+        res = a_nrf24l01_tx_ring_fill(handle);                                                                                       /* load the tx fifo */
+        if (handle->tx_ring->load == handle->tx_ring->tail)                                                                          /* nothing is loaded */
+        {
+            (void)a_nrf24l01_send_done(handle, NRF24L01_SEND_STATUS_HELD);                                                           /* wait for the next slot */
+        }
+        if (res != 0)                                                                                                                /* check result */
         {
-            handle->receive_callback(NRF24L01_INTERRUPT_TX_DS, 0, NULL, 0);                                 /* run receive callback */
+            handle->debug_print("nrf24l01: set tx payload failed.\n");                                                               /* set tx payload failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                                                         /* set gpio */
+            
+            return 1;                                                                                                                /* return error */
         }
     }
-    if (((prev >> 6) & 0x01) != 0)                                                                          /* receive */
+    if (((prev >> 6) & 0x01) != 0)                                                                                                   /* receive */
     {
         uint8_t num;
         uint8_t width;
-        uint8_t i;
-        uint8_t k;
-        uint8_t tmp;
-        uint8_t buffer[33];
+        uint8_t cnt;
+        uint8_t *p;
+        uint8_t ack;
+        uint8_t config;
+        uint8_t auto_ack;
+        uint8_t consumer;
+        uint8_t fifo;
+        uint8_t buffer[32];
+        nrf24l01_rx_frame_t *frame;
+        nrf24l01_mesh_frame_t *slot;
         
-        res = handle->spi_read(NRF24L01_COMMAND_R_RX_PL_WID, (uint8_t *)&width, 1);                         /* get payload width */
-        if (res != 0)                                                                                       /* check result */
+        ack = 0;                                                                                                                     /* no ack payload channel */
+        if ((handle->ack != NULL) && ((handle->ack->enable != 0) || (handle->ack->callback != NULL)))                                /* check the ack payload channel */
         {
-            handle->debug_print("nrf24l01: get payload width failed.\n");                                   /* get payload width failed */
-            (void)handle->gpio_write(1);                                                                    /* set gpio */
-            
-            return 1;                                                                                       /* return error */
+            res = a_nrf24l01_spi_read(handle, NRF24L01_REG_CONFIG, (uint8_t *)&config, 1);                                           /* get config */
+            if (res != 0)                                                                                                            /* check result */
+            {
+                handle->debug_print("nrf24l01: get config failed.\n");                                                               /* get config failed */
+                (void)handle->gpio_write(handle->user_data, ce);                                                                     /* set gpio */
+                
+                return 1;                                                                                                            /* return error */
+            }
+            ack = ((config & 0x01) != 0) ? 1 : 2;                                                                                    /* prx or ptx */
+        }
+        auto_ack = 0;                                                                                                                /* init 0 */
+        if (ack == 1)                                                                                                                /* prx */
+        {
+            res = a_nrf24l01_spi_read(handle, NRF24L01_REG_EN_AA, (uint8_t *)&auto_ack, 1);                                          /* get auto acknowledgment */
+            if (res != 0)                                                                                                            /* check result */
+            {
+                handle->debug_print("nrf24l01: get auto acknowledgment failed.\n");                                                  /* get auto acknowledgment failed */
+                (void)handle->gpio_write(handle->user_data, ce);                                                                     /* set gpio */
+                
+                return 1;                                                                                                            /* return error */
+            }
+        }
+        if (handle->stats_detail != 0)                                                                                               /* check detailed statistics */
+        {
+            res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FIFO_STATUS, (uint8_t *)&fifo, 1);                                        /* get fifo status */
+            if (res != 0)                                                                                                            /* check result */
+            {
+                handle->debug_print("nrf24l01: get fifo status failed.\n");                                                          /* get fifo status failed */
+                (void)handle->gpio_write(handle->user_data, ce);                                                                     /* set gpio */
+                
+                return 1;                                                                                                            /* return error */
+            }
+            if (((fifo >> 1) & 0x01) != 0)                                                                                           /* rx fifo full */
+            {
+                a_nrf24l01_stats_count(handle, 1, 0);                                                                                /* rx_fifo_full++ */
+            }
         }
-        if (width > 32)                                                                                     /* check width */
+        for (cnt = 0; cnt < NRF24L01_RX_DRAIN_MAX; cnt++)                                                                            /* drain the rx fifo */
         {
-            res = handle->spi_write(NRF24L01_COMMAND_FLUSH_RX, NULL, 0);                                    /* flush rx */
-            if (res != 0)                                                                                   /* check result */
+            res = a_nrf24l01_command_read(handle, NRF24L01_COMMAND_R_RX_PL_WID, (uint8_t *)&width, 1);                               /* get payload width */
+            if (res != 0)                                                                                                            /* check result */
+            {
+                handle->debug_print("nrf24l01: get payload width failed.\n");                                                        /* get payload width failed */
+                (void)handle->gpio_write(handle->user_data, ce);                                                                     /* set gpio */
+                
+                return 1;                                                                                                            /* return error */
+            }
+            if (handle->spi_transfer != NULL)                                                                                        /* check spi_transfer */
+            {
+                num = (handle->status >> 1) & 0x7;                                                                                   /* get number of the read payload */
+            }
+            else
+            {
+                num = (prev >> 1) & 0x7;                                                                                             /* get number */
+            }
+            if (num == 7)                                                                                                            /* rx fifo is empty */
+            {
+                break;                                                                                                               /* break */
+            }
+            if (width > 32)                                                                                                          /* check width */
+            {
+                a_nrf24l01_stats_count(handle, 2, 0);                                                                                /* oversize++ */
+                res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_RX, NULL, 0);                                          /* flush rx */
+                if (res != 0)                                                                                                        /* check result */
+                {
+                    handle->debug_print("nrf24l01: flush rx failed.\n");                                                             /* flush rx failed */
+                    (void)handle->gpio_write(handle->user_data, ce);                                                                 /* set gpio */
+                    
+                    return 1;                                                                                                        /* return error */
+                }
+                
+                break;                                                                                                               /* the rx fifo is flushed */
+            }
+            if ((ack == 1) && (num < 6) && (((auto_ack >> num) & 0x01) != 0) &&
+                (handle->ack->queue[num].tail != handle->ack->queue[num].load))                                                      /* the ack carried a payload */
+            {
+                handle->ack->queue[num].sent++;                                                                                      /* sent++ */
+                handle->ack->queue[num].tail = (uint16_t)((handle->ack->queue[num].tail + 1) %
+                                                         handle->ack->queue[num].depth);                                             /* free the frame */
+            }
+            consumer = a_nrf24l01_rx_consumer(handle, ack, num);                                                                     /* get the payload consumer */
+            frame = NULL;                                                                                                            /* init NULL */
+            slot = NULL;                                                                                                             /* init NULL */
+            if (consumer == 0)                                                                                                       /* rx queue or receive callback */
+            {
+                frame = a_nrf24l01_rx_queue_slot(handle);                                                                            /* get a free rx queue slot */
+            }
+            else if (consumer == 5)                                                                                                  /* mesh */
+            {
+                slot = a_nrf24l01_mesh_slot(handle);                                                                                 /* get a free forward queue slot */
+            }
+            else
+            {
+                /* do nothing */
+            }
+            p = (frame != NULL) ? frame->buf : (uint8_t *)buffer;                                                                    /* read into the slot when possible */
+            p = (slot != NULL) ? slot->buf : p;                                                                                      /* read a mesh frame into its forward slot */
+            if (consumer == 4)                                                                                                       /* no consumer */
+            {
+                res = a_nrf24l01_command_read(handle, NRF24L01_COMMAND_R_RX_PAYLOAD, p, width);                                      /* pop the payload as it is */
+            }
+            else
+            {
+                res = a_nrf24l01_payload_read(handle, NRF24L01_COMMAND_R_RX_PAYLOAD, p, width);                                      /* get rx payload */
+            }
+            if (res != 0)                                                                                                            /* check result */
+            {
+                handle->debug_print("nrf24l01: get rx payload failed.\n");                                                           /* get rx payload failed */
+                (void)handle->gpio_write(handle->user_data, ce);                                                                     /* set gpio */
+                
+                return 1;                                                                                                            /* return error */
+            }
+            if (num < 6)                                                                                                             /* check pipe */
+            {
+                a_nrf24l01_stats_count(handle, 4, num);                                                                              /* rx++ */
+                if ((handle->hub != NULL) && (handle->hub->enable != 0) && (handle->hub->pipe_node[num] != NRF24L01_HUB_NONE))       /* check the hub node */
+                {
+                    handle->hub->node[handle->hub->pipe_node[num]].slice++;                                                          /* slice++ */
+                    handle->hub->node[handle->hub->pipe_node[num]].received++;                                                       /* received++ */
+                }
+            }
+            if (consumer == 1)                                                                                                       /* ack payload */
+            {
+                if (sequence < handle->tx_sequence)                                                                                  /* match the sends in order */
+                {
+                    sequence++;                                                                                                      /* sequence++ */
+                }
+                handle->ack->callback(sequence, (uint8_t *)buffer, width, handle->ack->param);                                       /* run the ack callback */
+            }
+            else if (consumer == 2)                                                                                                  /* reassembly */
+            {
+                a_nrf24l01_reassembly_push(handle, num, (uint8_t *)buffer, width);                                                   /* push to the reassembly */
+            }
+            else if (consumer == 3)                                                                                                  /* pipe handler */
+            {
+                handle->dispatch->pipe[num].callback(num, (uint8_t *)buffer, width,
+                                                    handle->dispatch->pipe[num].param);                                              /* run the pipe handler */
+            }
+            else if (consumer == 4)                                                                                                  /* no consumer */
+            {
+                a_nrf24l01_stats_count(handle, 3, 0);                                                                                /* drop the payload */
+            }
+            else if (consumer == 5)                                                                                                  /* mesh */
+            {
+                a_nrf24l01_mesh_push(handle, slot, p, width);                                                                        /* deliver or forward in place */
+            }
+            else if (consumer == 6)                                                                                                  /* time sync */
             {
-                handle->debug_print("nrf24l01: flush rx failed.\n");                                        /* flush rx failed */
-                (void)handle->gpio_write(1);                                                                /* set gpio */
-                
-                return 1;                                                                                   /* return error */
+                a_nrf24l01_sync_push(handle, (uint8_t *)buffer, width, edge, (cnt == 0) ? 1 : 0);                                    /* take the beacon */
+            }
+            else if (handle->rx_queue != NULL)                                                                                       /* check rx queue */
+            {
+                a_nrf24l01_rx_queue_push(handle, frame, num, width);                                                                 /* push to the rx queue */
+            }
+            else if (handle->receive_callback != NULL)                                                                               /* if receive callback */
+            {
+                handle->receive_callback(handle->user_data, NRF24L01_INTERRUPT_RX_DR, num, (uint8_t *)buffer, width);                /* run receive callback */
+            }
+            else
+            {
+                /* do nothing */
+            }
+            if (handle->rx_drain == 0)                                                                                               /* check rx drain */
+            {
+                break;                                                                                                               /* one payload per interrupt */
+            }
+            if (handle->spi_transfer == NULL)                                                                                        /* check spi_transfer */
+            {
+                res = a_nrf24l01_spi_read(handle, NRF24L01_REG_STATUS, (uint8_t *)&prev, 1);                                         /* get status register */
+                if (res != 0)                                                                                                        /* check result */
+                {
+                    handle->debug_print("nrf24l01: get status register failed.\n");                                                  /* get status register failed */
+                    (void)handle->gpio_write(handle->user_data, ce);                                                                 /* set gpio */
+                    
+                    return 1;                                                                                                        /* return error */
+                }
+                if (((prev >> 1) & 0x7) == 7)                                                                                        /* rx fifo is empty */
+                {
+                    break;                                                                                                           /* break */
+                }
             }
         }
-        res = handle->spi_read(NRF24L01_COMMAND_R_RX_PAYLOAD, (uint8_t *)buffer, width);                    /* get rx payload */
-        if (res != 0)                                                                                       /* check result */
+    }
+    if ((handle->ack != NULL) && (handle->ack->enable != 0))                                                                         /* check the ack queues */
+    {
+        res = a_nrf24l01_ack_fill(handle);                                                                                           /* load the ack payloads */
+        if (res != 0)                                                                                                                /* check result */
         {
-            handle->debug_print("nrf24l01: get rx payload failed.\n");                                      /* get rx payload failed */
-            (void)handle->gpio_write(1);                                                                    /* set gpio */
+            handle->debug_print("nrf24l01: set payload with ack failed.\n");                                                         /* set payload with ack failed */
+            (void)handle->gpio_write(handle->user_data, ce);                                                                         /* set gpio */
             
-            return 1;                                                                                       /* return error */
-        }
-        k = width / 2;                                                                                      /* get the half */
-        for (i = 0; i < k; i++)                                                                             /* run k times */
-        {
-            tmp = buffer[i];                                                                                /* copy to tmp */
-            buffer[i] = buffer[width - 1 - i];                                                              /* buffer[i] = buffer[n - 1 - i] */
-            buffer[width - 1 - i] = tmp;                                                                    /* set buffer[n - 1 - i]*/
-        }
-        num = (prev >> 1) & 0x7;                                                                            /* get number */
-        if (handle->receive_callback != NULL)                                                               /* if receive callback */
-        {
-            handle->receive_callback(NRF24L01_INTERRUPT_RX_DR, num, (uint8_t *)buffer, width);              /* run receive callback */
+            return 1;                                                                                                                /* return error */
         }
     }
-    res = handle->gpio_write(1);                                                                            /* set gpio write */
-    if (res != 0)                                                                                           /* check result */
+    res = handle->gpio_write(handle->user_data, ce);                                                                                 /* set gpio write */
+    if (res != 0)                                                                                                                    /* check result */
     {
-        handle->debug_print("nrf24l01: gpio write failed.\n");                                              /* gpio write failed */
+        handle->debug_print("nrf24l01: gpio write failed.\n");                                                                       /* gpio write failed */
        
-        return 1;                                                                                           /* return error */
+        return 1;                                                                                                                    /* return error */
     }
     
-    return 0;                                                                                               /* success return 0 */
+    return 0;                                                                                                                        /* success return 0 */
 }
 
 /**
@@ -572,12 +6450,13 @@ uint8_t nrf24l01_irq_handler(nrf24l01_handle_t *handle)
  *            - 1 set config failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      waits the 1.5 ms start up time after powering up
  */
 uint8_t nrf24l01_set_config(nrf24l01_handle_t *handle, nrf24l01_config_t config, nrf24l01_bool_t enable)
 {
     uint8_t res;
     uint8_t prev;
+    uint8_t old;
     
     if (handle == NULL)                                                                 /* check handle */
     {
@@ -595,6 +6474,7 @@ uint8_t nrf24l01_set_config(nrf24l01_handle_t *handle, nrf24l01_config_t config,
        
         return 1;                                                                       /* return error */
     }
+    old = prev;                                                                         /* save config */
     prev &= ~(1 << config);                                                             /* clear config */
     prev |= enable << config;                                                           /* set config */
     res = a_nrf24l01_spi_write(handle, NRF24L01_REG_CONFIG, (uint8_t *)&prev, 1);       /* set config */
@@ -604,6 +6484,10 @@ uint8_t nrf24l01_set_config(nrf24l01_handle_t *handle, nrf24l01_config_t config,
        
         return 1;                                                                       /* return error */
     }
+    if (((old & (1 << 1)) == 0) && ((prev & (1 << 1)) != 0))                            /* check power up */
+    {
+        a_nrf24l01_delay_us(handle, NRF24L01_POWER_UP_US);                              /* wait the crystal oscillator */
+    }
     
     return 0;                                                                           /* success return 0 */
 }
@@ -655,12 +6539,13 @@ uint8_t nrf24l01_get_config(nrf24l01_handle_t *handle, nrf24l01_config_t config,
  *            - 1 set mode failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      waits the 130 us settling time after a mode switch when delay_us is linked
  */
 uint8_t nrf24l01_set_mode(nrf24l01_handle_t *handle, nrf24l01_mode_t mode)
 {
     uint8_t res;
     uint8_t prev;
+    uint8_t old;
     
     if (handle == NULL)                                                                 /* check handle */
     {
@@ -678,6 +6563,7 @@ uint8_t nrf24l01_set_mode(nrf24l01_handle_t *handle, nrf24l01_mode_t mode)
        
         return 1;                                                                       /* return error */
     }
+    old = prev;                                                                         /* save config */
     prev &= ~(1 << 0);                                                                  /* clear config */
     prev |= mode << 0;                                                                  /* set config */
     res = a_nrf24l01_spi_write(handle, NRF24L01_REG_CONFIG, (uint8_t *)&prev, 1);       /* set config */
@@ -687,6 +6573,10 @@ uint8_t nrf24l01_set_mode(nrf24l01_handle_t *handle, nrf24l01_mode_t mode)
        
         return 1;                                                                       /* return error */
     }
+    if (old != prev)                                                                    /* check mode switch */
+    {
+        a_nrf24l01_settle(handle);                                                      /* wait the settling time */
+    }
     
     return 0;                                                                           /* success return 0 */
 }
@@ -2534,78 +8424,312 @@ uint8_t nrf24l01_set_tx_address(nrf24l01_handle_t *handle, uint8_t *addr, uint8_
 uint8_t nrf24l01_get_tx_address(nrf24l01_handle_t *handle, uint8_t *addr, uint8_t *len)
 {
     uint8_t res;
-    uint8_t prev;
-    uint8_t width;
-    uint8_t i;
-    uint8_t k;
-    uint8_t tmp;
+    uint8_t prev;
+    uint8_t width;
+    uint8_t i;
+    uint8_t k;
+    uint8_t tmp;
+    
+    if (handle == NULL)                                                                              /* check handle */
+    {
+        return 2;                                                                                    /* return error */
+    }
+    if (handle->inited != 1)                                                                         /* check handle initialization */
+    {
+        return 3;                                                                                    /* return error */
+    }
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_SETUP_AW, (uint8_t *)&prev, 1);                   /* get setup of address widths */
+    if (res != 0)                                                                                    /* check result */
+    {
+        handle->debug_print("nrf24l01: get setup of address widths failed.\n");                      /* get setup of address widths failed */
+       
+        return 1;                                                                                    /* return error */
+    }
+    width = (nrf24l01_address_width_t)((prev >> 0) & 0x3);                                           /* get width */
+    if (width == 0)                                                                                  /* check width */
+    {
+        handle->debug_print("nrf24l01: len is too long with %d.\n", 0);                              /* len is too long */
+       
+        return 4;                                                                                    /* return error */
+    }
+    else
+    {
+        width += 2;                                                                                  /* width + 2 */
+    }
+    if (*len < width)                                                                                /* check width */
+    {
+        handle->debug_print("nrf24l01: len is too short with %d.\n", width);                         /* len is too short */
+       
+        return 4;                                                                                    /* return error */
+    }
+    *len = width;                                                                                    /* set width */
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_TX_ADDR, (uint8_t *)addr, width);                 /* get tx address register */
+    if (res != 0)                                                                                    /* check result */
+    {
+        handle->debug_print("nrf24l01: get tx address failed.\n");                                   /* get tx address failed */
+       
+        return 1;                                                                                    /* return error */
+    }
+    k = (*len) / 2;                                                                                  /* set k */
+    for (i = 0; i < k; i++)                                                                          /* run k times */
+    {
+        tmp = addr[i];                                                                               /* copy to tmp */
+        addr[i] = addr[(*len) - 1 - i];                                                              /* addr[i] = addr[n - 1 - i] */
+        addr[(*len) - 1 - i] = tmp;                                                                  /* set addr[n - 1 - i]*/
+    }
+    
+    return 0;                                                                                        /* success return 0 */
+}
+
+/**
+ * @brief     set the pipe 0 payload number
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] num payload number
+ * @return    status code
+ *            - 0 success
+ *            - 1 set pipe 0 payload number failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 num is over 0x3F
+ * @note      none
+ */
+uint8_t nrf24l01_set_pipe_0_payload_number(nrf24l01_handle_t *handle, uint8_t num)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                  /* check handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    if (num > 0x3F)                                                                      /* check num */
+    {
+        handle->debug_print("nrf24l01: num is over 0x3F.\n");                            /* num is over 0x3F */
+       
+        return 4;                                                                        /* return error */
+    }
+    
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P0, (uint8_t *)&num, 1);       /* set pipe 0 payload number failed */
+    if (res != 0)                                                                        /* check result */
+    {
+        handle->debug_print("nrf24l01: set pipe 0 payload number failed.\n");            /* set pipe 0 payload number failed */
+       
+        return 1;                                                                        /* return error */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief      get the pipe 0 payload number
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *num pointer to a payload number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get pipe 0 payload number failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_pipe_0_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                /* check handle */
+    {
+        return 2;                                                                      /* return error */
+    }
+    if (handle->inited != 1)                                                           /* check handle initialization */
+    {
+        return 3;                                                                      /* return error */
+    }
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P0, (uint8_t *)num, 1);       /* get pipe 0 payload number failed */
+    if (res != 0)                                                                      /* check result */
+    {
+        handle->debug_print("nrf24l01: get pipe 0 payload number failed.\n");          /* get pipe 0 payload number failed */
+       
+        return 1;                                                                      /* return error */
+    }
+    *num = (*num) & 0x3F;                                                              /* get number */
+    
+    return 0;                                                                          /* success return 0 */
+}
+
+/**
+ * @brief     set the pipe 1 payload number
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] num payload number
+ * @return    status code
+ *            - 0 success
+ *            - 1 set pipe 1 payload number failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 num is over 0x3F
+ * @note      none
+ */
+uint8_t nrf24l01_set_pipe_1_payload_number(nrf24l01_handle_t *handle, uint8_t num)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                  /* check handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    if (num > 0x3F)                                                                      /* check num */
+    {
+        handle->debug_print("nrf24l01: num is over 0x3F.\n");                            /* num is over 0x3F */
+       
+        return 4;                                                                        /* return error */
+    }
+    
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P1, (uint8_t *)&num, 1);       /* set pipe 1 payload number failed */
+    if (res != 0)                                                                        /* check result */
+    {
+        handle->debug_print("nrf24l01: set pipe 1 payload number failed.\n");            /* set pipe 1 payload number failed */
+       
+        return 1;                                                                        /* return error */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief      get the pipe 1 payload number
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *num pointer to a payload number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get pipe 1 payload number failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_pipe_1_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                /* check handle */
+    {
+        return 2;                                                                      /* return error */
+    }
+    if (handle->inited != 1)                                                           /* check handle initialization */
+    {
+        return 3;                                                                      /* return error */
+    }
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P1, (uint8_t *)num, 1);       /* get pipe 1 payload number failed */
+    if (res != 0)                                                                      /* check result */
+    {
+        handle->debug_print("nrf24l01: get pipe 1 payload number failed.\n");          /* get pipe 1 payload number failed */
+       
+        return 1;                                                                      /* return error */
+    }
+    *num = (*num) & 0x3F;                                                              /* get number */
+    
+    return 0;                                                                          /* success return 0 */
+}
+
+/**
+ * @brief     set the pipe 2 payload number
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] num payload number
+ * @return    status code
+ *            - 0 success
+ *            - 1 set pipe 2 payload number failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 num is over 0x3F
+ * @note      none
+ */
+uint8_t nrf24l01_set_pipe_2_payload_number(nrf24l01_handle_t *handle, uint8_t num)
+{
+    uint8_t res;
     
-    if (handle == NULL)                                                                              /* check handle */
+    if (handle == NULL)                                                                  /* check handle */
     {
-        return 2;                                                                                    /* return error */
+        return 2;                                                                        /* return error */
     }
-    if (handle->inited != 1)                                                                         /* check handle initialization */
+    if (handle->inited != 1)                                                             /* check handle initialization */
     {
-        return 3;                                                                                    /* return error */
+        return 3;                                                                        /* return error */
     }
-    
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_SETUP_AW, (uint8_t *)&prev, 1);                   /* get setup of address widths */
-    if (res != 0)                                                                                    /* check result */
+    if (num > 0x3F)                                                                      /* check num */
     {
-        handle->debug_print("nrf24l01: get setup of address widths failed.\n");                      /* get setup of address widths failed */
+        handle->debug_print("nrf24l01: num is over 0x3F.\n");                            /* num is over 0x3F */
        
-        return 1;                                                                                    /* return error */
+        return 4;                                                                        /* return error */
     }
-    width = (nrf24l01_address_width_t)((prev >> 0) & 0x3);                                           /* get width */
-    if (width == 0)                                                                                  /* check width */
+    
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P2, (uint8_t *)&num, 1);       /* set pipe 2 payload number failed */
+    if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: len is too long with %d.\n", 0);                              /* len is too long */
+        handle->debug_print("nrf24l01: set pipe 2 payload number failed.\n");            /* set pipe 2 payload number failed */
        
-        return 4;                                                                                    /* return error */
+        return 1;                                                                        /* return error */
     }
-    else
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief      get the pipe 2 payload number
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *num pointer to a payload number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get pipe 2 payload number failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_pipe_2_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                /* check handle */
     {
-        width += 2;                                                                                  /* width + 2 */
+        return 2;                                                                      /* return error */
     }
-    if (*len < width)                                                                                /* check width */
+    if (handle->inited != 1)                                                           /* check handle initialization */
     {
-        handle->debug_print("nrf24l01: len is too short with %d.\n", width);                         /* len is too short */
-       
-        return 4;                                                                                    /* return error */
+        return 3;                                                                      /* return error */
     }
-    *len = width;                                                                                    /* set width */
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_TX_ADDR, (uint8_t *)addr, width);                 /* get tx address register */
-    if (res != 0)                                                                                    /* check result */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P2, (uint8_t *)num, 1);       /* get pipe 2 payload number failed */
+    if (res != 0)                                                                      /* check result */
     {
-        handle->debug_print("nrf24l01: get tx address failed.\n");                                   /* get tx address failed */
+        handle->debug_print("nrf24l01: get pipe 2 payload number failed.\n");          /* get pipe 2 payload number failed */
        
-        return 1;                                                                                    /* return error */
-    }
-    k = (*len) / 2;                                                                                  /* set k */
-    for (i = 0; i < k; i++)                                                                          /* run k times */
-    {
-        tmp = addr[i];                                                                               /* copy to tmp */
-        addr[i] = addr[(*len) - 1 - i];                                                              /* addr[i] = addr[n - 1 - i] */
-        addr[(*len) - 1 - i] = tmp;                                                                  /* set addr[n - 1 - i]*/
+        return 1;                                                                      /* return error */
     }
+    *num = (*num) & 0x3F;                                                              /* get number */
     
-    return 0;                                                                                        /* success return 0 */
+    return 0;                                                                          /* success return 0 */
 }
 
 /**
- * @brief     set the pipe 0 payload number
+ * @brief     set the pipe 3 payload number
  * @param[in] *handle pointer to an nrf24l01 handle structure
  * @param[in] num payload number
  * @return    status code
  *            - 0 success
- *            - 1 set pipe 0 payload number failed
+ *            - 1 set pipe 3 payload number failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 num is over 0x3F
  * @note      none
  */
-uint8_t nrf24l01_set_pipe_0_payload_number(nrf24l01_handle_t *handle, uint8_t num)
+uint8_t nrf24l01_set_pipe_3_payload_number(nrf24l01_handle_t *handle, uint8_t num)
 {
     uint8_t res;
     
@@ -2624,10 +8748,10 @@ uint8_t nrf24l01_set_pipe_0_payload_number(nrf24l01_handle_t *handle, uint8_t nu
         return 4;                                                                        /* return error */
     }
     
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P0, (uint8_t *)&num, 1);       /* set pipe 0 payload number failed */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P3, (uint8_t *)&num, 1);       /* set pipe 3 payload number failed */
     if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: set pipe 0 payload number failed.\n");            /* set pipe 0 payload number failed */
+        handle->debug_print("nrf24l01: set pipe 3 payload number failed.\n");            /* set pipe 3 payload number failed */
        
         return 1;                                                                        /* return error */
     }
@@ -2636,17 +8760,17 @@ uint8_t nrf24l01_set_pipe_0_payload_number(nrf24l01_handle_t *handle, uint8_t nu
 }
 
 /**
- * @brief      get the pipe 0 payload number
+ * @brief      get the pipe 3 payload number
  * @param[in]  *handle pointer to an nrf24l01 handle structure
  * @param[out] *num pointer to a payload number buffer
  * @return     status code
  *             - 0 success
- *             - 1 get pipe 0 payload number failed
+ *             - 1 get pipe 3 payload number failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t nrf24l01_get_pipe_0_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
+uint8_t nrf24l01_get_pipe_3_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
 {
     uint8_t res;
     
@@ -2659,10 +8783,10 @@ uint8_t nrf24l01_get_pipe_0_payload_number(nrf24l01_handle_t *handle, uint8_t *n
         return 3;                                                                      /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P0, (uint8_t *)num, 1);       /* get pipe 0 payload number failed */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P3, (uint8_t *)num, 1);       /* get pipe 3 payload number failed */
     if (res != 0)                                                                      /* check result */
     {
-        handle->debug_print("nrf24l01: get pipe 0 payload number failed.\n");          /* get pipe 0 payload number failed */
+        handle->debug_print("nrf24l01: get pipe 3 payload number failed.\n");          /* get pipe 3 payload number failed */
        
         return 1;                                                                      /* return error */
     }
@@ -2672,18 +8796,18 @@ uint8_t nrf24l01_get_pipe_0_payload_number(nrf24l01_handle_t *handle, uint8_t *n
 }
 
 /**
- * @brief     set the pipe 1 payload number
+ * @brief     set the pipe 4 payload number
  * @param[in] *handle pointer to an nrf24l01 handle structure
  * @param[in] num payload number
  * @return    status code
  *            - 0 success
- *            - 1 set pipe 1 payload number failed
+ *            - 1 set pipe 4 payload number failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 num is over 0x3F
  * @note      none
  */
-uint8_t nrf24l01_set_pipe_1_payload_number(nrf24l01_handle_t *handle, uint8_t num)
+uint8_t nrf24l01_set_pipe_4_payload_number(nrf24l01_handle_t *handle, uint8_t num)
 {
     uint8_t res;
     
@@ -2702,10 +8826,10 @@ uint8_t nrf24l01_set_pipe_1_payload_number(nrf24l01_handle_t *handle, uint8_t nu
         return 4;                                                                        /* return error */
     }
     
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P1, (uint8_t *)&num, 1);       /* set pipe 1 payload number failed */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P4, (uint8_t *)&num, 1);       /* set pipe 4 payload number failed */
     if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: set pipe 1 payload number failed.\n");            /* set pipe 1 payload number failed */
+        handle->debug_print("nrf24l01: set pipe 4 payload number failed.\n");            /* set pipe 4 payload number failed */
        
         return 1;                                                                        /* return error */
     }
@@ -2714,17 +8838,17 @@ uint8_t nrf24l01_set_pipe_1_payload_number(nrf24l01_handle_t *handle, uint8_t nu
 }
 
 /**
- * @brief      get the pipe 1 payload number
+ * @brief      get the pipe 4 payload number
  * @param[in]  *handle pointer to an nrf24l01 handle structure
  * @param[out] *num pointer to a payload number buffer
  * @return     status code
  *             - 0 success
- *             - 1 get pipe 1 payload number failed
+ *             - 1 get pipe 4 payload number failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t nrf24l01_get_pipe_1_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
+uint8_t nrf24l01_get_pipe_4_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
 {
     uint8_t res;
     
@@ -2737,10 +8861,10 @@ uint8_t nrf24l01_get_pipe_1_payload_number(nrf24l01_handle_t *handle, uint8_t *n
         return 3;                                                                      /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P1, (uint8_t *)num, 1);       /* get pipe 1 payload number failed */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P4, (uint8_t *)num, 1);       /* get pipe 4 payload number failed */
     if (res != 0)                                                                      /* check result */
     {
-        handle->debug_print("nrf24l01: get pipe 1 payload number failed.\n");          /* get pipe 1 payload number failed */
+        handle->debug_print("nrf24l01: get pipe 4 payload number failed.\n");          /* get pipe 4 payload number failed */
        
         return 1;                                                                      /* return error */
     }
@@ -2750,18 +8874,18 @@ uint8_t nrf24l01_get_pipe_1_payload_number(nrf24l01_handle_t *handle, uint8_t *n
 }
 
 /**
- * @brief     set the pipe 2 payload number
+ * @brief     set the pipe 5 payload number
  * @param[in] *handle pointer to an nrf24l01 handle structure
  * @param[in] num payload number
  * @return    status code
  *            - 0 success
- *            - 1 set pipe 2 payload number failed
+ *            - 1 set pipe 5 payload number failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 num is over 0x3F
  * @note      none
  */
-uint8_t nrf24l01_set_pipe_2_payload_number(nrf24l01_handle_t *handle, uint8_t num)
+uint8_t nrf24l01_set_pipe_5_payload_number(nrf24l01_handle_t *handle, uint8_t num)
 {
     uint8_t res;
     
@@ -2780,10 +8904,10 @@ uint8_t nrf24l01_set_pipe_2_payload_number(nrf24l01_handle_t *handle, uint8_t nu
         return 4;                                                                        /* return error */
     }
     
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P2, (uint8_t *)&num, 1);       /* set pipe 2 payload number failed */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P5, (uint8_t *)&num, 1);       /* set pipe 5 payload number failed */
     if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: set pipe 2 payload number failed.\n");            /* set pipe 2 payload number failed */
+        handle->debug_print("nrf24l01: set pipe 5 payload number failed.\n");            /* set pipe 5 payload number failed */
        
         return 1;                                                                        /* return error */
     }
@@ -2792,17 +8916,17 @@ uint8_t nrf24l01_set_pipe_2_payload_number(nrf24l01_handle_t *handle, uint8_t nu
 }
 
 /**
- * @brief      get the pipe 2 payload number
+ * @brief      get the pipe 5 payload number
  * @param[in]  *handle pointer to an nrf24l01 handle structure
  * @param[out] *num pointer to a payload number buffer
  * @return     status code
  *             - 0 success
- *             - 1 get pipe 2 payload number failed
+ *             - 1 get pipe 5 payload number failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t nrf24l01_get_pipe_2_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
+uint8_t nrf24l01_get_pipe_5_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
 {
     uint8_t res;
     
@@ -2815,33 +8939,152 @@ uint8_t nrf24l01_get_pipe_2_payload_number(nrf24l01_handle_t *handle, uint8_t *n
         return 3;                                                                      /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P2, (uint8_t *)num, 1);       /* get pipe 2 payload number failed */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P5, (uint8_t *)num, 1);       /* get pipe 5 payload number failed */
     if (res != 0)                                                                      /* check result */
     {
-        handle->debug_print("nrf24l01: get pipe 2 payload number failed.\n");          /* get pipe 2 payload number failed */
+        handle->debug_print("nrf24l01: get pipe 5 payload number failed.\n");          /* get pipe 5 payload number failed */
        
         return 1;                                                                      /* return error */
     }
-    *num = (*num) & 0x3F;                                                              /* get number */
+    *num = (*num) & 0x3F;                                                              /* get number */
+    
+    return 0;                                                                          /* success return 0 */
+}
+
+/**
+ * @brief      get the fifo status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *status pointer to a fifo status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get fifo status failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_fifo_status(nrf24l01_handle_t *handle, uint8_t *status)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                      /* check handle */
+    {
+        return 2;                                                                            /* return error */
+    }
+    if (handle->inited != 1)                                                                 /* check handle initialization */
+    {
+        return 3;                                                                            /* return error */
+    }
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FIFO_STATUS, (uint8_t *)status, 1);       /* get fifo status failed */
+    if (res != 0)                                                                            /* check result */
+    {
+        handle->debug_print("nrf24l01: get fifo status failed.\n");                          /* get fifo status failed */
+       
+        return 1;                                                                            /* return error */
+    }
+    
+    return 0;                                                                                /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable the pipe dynamic payload
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe pipe number
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set pipe dynamic payload failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t nrf24l01_set_pipe_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, nrf24l01_bool_t enable)
+{
+    uint8_t res;
+    uint8_t prev;
+    
+    if (handle == NULL)                                                                        /* check handle */
+    {
+        return 2;                                                                              /* return error */
+    }
+    if (handle->inited != 1)                                                                   /* check handle initialization */
+    {
+        return 3;                                                                              /* return error */
+    }
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_DYNPD, (uint8_t *)&prev, 1);                /* get dynamic payload length register */
+    if (res != 0)                                                                              /* check result */
+    {
+        handle->debug_print("nrf24l01: get dynamic payload length register failed.\n");        /* get dynamic payload length register failed */
+       
+        return 1;                                                                              /* return error */
+    }
+    prev &= ~(1 << pipe);                                                                      /* clear config */
+    prev |= enable << pipe;                                                                    /* set bool */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_DYNPD, (uint8_t *)&prev, 1);               /* set dynamic payload length register */
+    if (res != 0)                                                                              /* check result */
+    {
+        handle->debug_print("nrf24l01: set dynamic payload length register failed.\n");        /* set dynamic payload length register failed */
+       
+        return 1;                                                                              /* return error */
+    }
+    
+    return 0;                                                                                  /* success return 0 */
+}
+
+/**
+ * @brief      get the pipe dynamic payload status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  pipe pipe number
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get pipe dynamic payload failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_pipe_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, nrf24l01_bool_t *enable)
+{
+    uint8_t res;
+    uint8_t prev;
+    
+    if (handle == NULL)                                                                        /* check handle */
+    {
+        return 2;                                                                              /* return error */
+    }
+    if (handle->inited != 1)                                                                   /* check handle initialization */
+    {
+        return 3;                                                                              /* return error */
+    }
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_DYNPD, (uint8_t *)&prev, 1);                /* get dynamic payload length register */
+    if (res != 0)                                                                              /* check result */
+    {
+        handle->debug_print("nrf24l01: get dynamic payload length register failed.\n");        /* get dynamic payload length register failed */
+       
+        return 1;                                                                              /* return error */
+    }
+    *enable = (nrf24l01_bool_t)((prev >> pipe) & 0x01);                                        /* get bool */
     
-    return 0;                                                                          /* success return 0 */
+    return 0;                                                                                  /* success return 0 */
 }
 
 /**
- * @brief     set the pipe 3 payload number
+ * @brief     enable or disable the dynamic payload
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] num payload number
+ * @param[in] enable bool value
  * @return    status code
  *            - 0 success
- *            - 1 set pipe 3 payload number failed
+ *            - 1 set dynamic payload failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 num is over 0x3F
  * @note      none
  */
-uint8_t nrf24l01_set_pipe_3_payload_number(nrf24l01_handle_t *handle, uint8_t num)
+uint8_t nrf24l01_set_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
 {
     uint8_t res;
+    uint8_t prev;
     
     if (handle == NULL)                                                                  /* check handle */
     {
@@ -2851,17 +9094,20 @@ uint8_t nrf24l01_set_pipe_3_payload_number(nrf24l01_handle_t *handle, uint8_t nu
     {
         return 3;                                                                        /* return error */
     }
-    if (num > 0x3F)                                                                      /* check num */
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
+    if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: num is over 0x3F.\n");                            /* num is over 0x3F */
+        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
        
-        return 4;                                                                        /* return error */
+        return 1;                                                                        /* return error */
     }
-    
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P3, (uint8_t *)&num, 1);       /* set pipe 3 payload number failed */
+    prev &= ~(1 << 2);                                                                   /* clear config */
+    prev |= enable << 2;                                                                 /* set bool */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);       /* set feature register */
     if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: set pipe 3 payload number failed.\n");            /* set pipe 3 payload number failed */
+        handle->debug_print("nrf24l01: set feature register failed.\n");                 /* set feature register failed */
        
         return 1;                                                                        /* return error */
     }
@@ -2870,56 +9116,57 @@ uint8_t nrf24l01_set_pipe_3_payload_number(nrf24l01_handle_t *handle, uint8_t nu
 }
 
 /**
- * @brief      get the pipe 3 payload number
+ * @brief      get the dynamic payload status
  * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[out] *num pointer to a payload number buffer
+ * @param[out] *enable pointer to a bool value buffer
  * @return     status code
  *             - 0 success
- *             - 1 get pipe 3 payload number failed
+ *             - 1 get dynamic payload failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t nrf24l01_get_pipe_3_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
+uint8_t nrf24l01_get_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
 {
     uint8_t res;
+    uint8_t prev;
     
-    if (handle == NULL)                                                                /* check handle */
+    if (handle == NULL)                                                                  /* check handle */
     {
-        return 2;                                                                      /* return error */
+        return 2;                                                                        /* return error */
     }
-    if (handle->inited != 1)                                                           /* check handle initialization */
+    if (handle->inited != 1)                                                             /* check handle initialization */
     {
-        return 3;                                                                      /* return error */
+        return 3;                                                                        /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P3, (uint8_t *)num, 1);       /* get pipe 3 payload number failed */
-    if (res != 0)                                                                      /* check result */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
+    if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: get pipe 3 payload number failed.\n");          /* get pipe 3 payload number failed */
+        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
        
-        return 1;                                                                      /* return error */
+        return 1;                                                                        /* return error */
     }
-    *num = (*num) & 0x3F;                                                              /* get number */
+    *enable = (nrf24l01_bool_t)((prev >> 2) & 0x01);                                     /* get bool */
     
-    return 0;                                                                          /* success return 0 */
+    return 0;                                                                            /* success return 0 */
 }
 
 /**
- * @brief     set the pipe 4 payload number
+ * @brief     enable or disable the payload with ack
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] num payload number
+ * @param[in] enable bool value
  * @return    status code
  *            - 0 success
- *            - 1 set pipe 4 payload number failed
+ *            - 1 set payload with ack failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 num is over 0x3F
  * @note      none
  */
-uint8_t nrf24l01_set_pipe_4_payload_number(nrf24l01_handle_t *handle, uint8_t num)
+uint8_t nrf24l01_set_payload_with_ack(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
 {
     uint8_t res;
+    uint8_t prev;
     
     if (handle == NULL)                                                                  /* check handle */
     {
@@ -2929,17 +9176,20 @@ uint8_t nrf24l01_set_pipe_4_payload_number(nrf24l01_handle_t *handle, uint8_t nu
     {
         return 3;                                                                        /* return error */
     }
-    if (num > 0x3F)                                                                      /* check num */
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
+    if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: num is over 0x3F.\n");                            /* num is over 0x3F */
+        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
        
-        return 4;                                                                        /* return error */
+        return 1;                                                                        /* return error */
     }
-    
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P4, (uint8_t *)&num, 1);       /* set pipe 4 payload number failed */
+    prev &= ~(1 << 1);                                                                   /* clear config */
+    prev |= enable << 1;                                                                 /* set bool */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);       /* set feature register */
     if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: set pipe 4 payload number failed.\n");            /* set pipe 4 payload number failed */
+        handle->debug_print("nrf24l01: set feature register failed.\n");                 /* set feature register failed */
        
         return 1;                                                                        /* return error */
     }
@@ -2948,56 +9198,57 @@ uint8_t nrf24l01_set_pipe_4_payload_number(nrf24l01_handle_t *handle, uint8_t nu
 }
 
 /**
- * @brief      get the pipe 4 payload number
+ * @brief      get the payload with ack status
  * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[out] *num pointer to a payload number buffer
+ * @param[out] *enable pointer to a bool value buffer
  * @return     status code
  *             - 0 success
- *             - 1 get pipe 4 payload number failed
+ *             - 1 get payload with ack failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t nrf24l01_get_pipe_4_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
+uint8_t nrf24l01_get_payload_with_ack(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
 {
     uint8_t res;
+    uint8_t prev;
     
-    if (handle == NULL)                                                                /* check handle */
+    if (handle == NULL)                                                                 /* check handle */
     {
-        return 2;                                                                      /* return error */
+        return 2;                                                                       /* return error */
     }
-    if (handle->inited != 1)                                                           /* check handle initialization */
+    if (handle->inited != 1)                                                            /* check handle initialization */
     {
-        return 3;                                                                      /* return error */
+        return 3;                                                                       /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P4, (uint8_t *)num, 1);       /* get pipe 4 payload number failed */
-    if (res != 0)                                                                      /* check result */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);       /* get feature register */
+    if (res != 0)                                                                       /* check result */
     {
-        handle->debug_print("nrf24l01: get pipe 4 payload number failed.\n");          /* get pipe 4 payload number failed */
+        handle->debug_print("nrf24l01: get feature register failed.\n");                /* get feature register failed */
        
-        return 1;                                                                      /* return error */
+        return 1;                                                                       /* return error */
     }
-    *num = (*num) & 0x3F;                                                              /* get number */
+    *enable = (nrf24l01_bool_t)((prev >> 1) & 0x01);                                    /* get bool */
     
-    return 0;                                                                          /* success return 0 */
+    return 0;                                                                           /* success return 0 */
 }
 
 /**
- * @brief     set the pipe 5 payload number
+ * @brief     enable or disable the tx payload with no ack
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] num payload number
+ * @param[in] enable bool value
  * @return    status code
  *            - 0 success
- *            - 1 set pipe 5 payload number failed
+ *            - 1 set tx payload with no ack failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 num is over 0x3F
  * @note      none
  */
-uint8_t nrf24l01_set_pipe_5_payload_number(nrf24l01_handle_t *handle, uint8_t num)
+uint8_t nrf24l01_set_tx_payload_with_no_ack(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
 {
     uint8_t res;
+    uint8_t prev;
     
     if (handle == NULL)                                                                  /* check handle */
     {
@@ -3007,17 +9258,20 @@ uint8_t nrf24l01_set_pipe_5_payload_number(nrf24l01_handle_t *handle, uint8_t nu
     {
         return 3;                                                                        /* return error */
     }
-    if (num > 0x3F)                                                                      /* check num */
+    
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
+    if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: num is over 0x3F.\n");                            /* num is over 0x3F */
+        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
        
-        return 4;                                                                        /* return error */
+        return 1;                                                                        /* return error */
     }
-    
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_RX_PW_P5, (uint8_t *)&num, 1);       /* set pipe 5 payload number failed */
+    prev &= ~(1 << 0);                                                                   /* clear config */
+    prev |= enable << 0;                                                                 /* set bool */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);       /* set feature register */
     if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: set pipe 5 payload number failed.\n");            /* set pipe 5 payload number failed */
+        handle->debug_print("nrf24l01: set feature register failed.\n");                 /* set feature register failed */
        
         return 1;                                                                        /* return error */
     }
@@ -3026,175 +9280,210 @@ uint8_t nrf24l01_set_pipe_5_payload_number(nrf24l01_handle_t *handle, uint8_t nu
 }
 
 /**
- * @brief      get the pipe 5 payload number
+ * @brief      get the tx payload with no ack status
  * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[out] *num pointer to a payload number buffer
+ * @param[out] *enable pointer to a bool value buffer
  * @return     status code
  *             - 0 success
- *             - 1 get pipe 5 payload number failed
+ *             - 1 get tx payload with no ack failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t nrf24l01_get_pipe_5_payload_number(nrf24l01_handle_t *handle, uint8_t *num)
+uint8_t nrf24l01_get_tx_payload_with_no_ack(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
 {
     uint8_t res;
+    uint8_t prev;
     
-    if (handle == NULL)                                                                /* check handle */
+    if (handle == NULL)                                                                  /* check handle */
     {
-        return 2;                                                                      /* return error */
+        return 2;                                                                        /* return error */
     }
-    if (handle->inited != 1)                                                           /* check handle initialization */
+    if (handle->inited != 1)                                                             /* check handle initialization */
     {
-        return 3;                                                                      /* return error */
+        return 3;                                                                        /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_PW_P5, (uint8_t *)num, 1);       /* get pipe 5 payload number failed */
-    if (res != 0)                                                                      /* check result */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
+    if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: get pipe 5 payload number failed.\n");          /* get pipe 5 payload number failed */
+        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
        
-        return 1;                                                                      /* return error */
+        return 1;                                                                        /* return error */
     }
-    *num = (*num) & 0x3F;                                                              /* get number */
+    *enable = (nrf24l01_bool_t)((prev >> 0) & 0x01);                                     /* get bool */
     
-    return 0;                                                                          /* success return 0 */
+    return 0;                                                                            /* success return 0 */
 }
 
 /**
- * @brief      get the fifo status
+ * @brief      read the rx payload
  * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[out] *status pointer to a fifo status buffer
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len buffer length
  * @return     status code
  *             - 0 success
- *             - 1 get fifo status failed
+ *             - 1 read rx payload failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 4 len is over 32
  * @note       none
  */
-uint8_t nrf24l01_get_fifo_status(nrf24l01_handle_t *handle, uint8_t *status)
+uint8_t nrf24l01_read_rx_payload(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len)
 {
     uint8_t res;
     
-    if (handle == NULL)                                                                      /* check handle */
+    if (handle == NULL)                                                                   /* check handle */
     {
-        return 2;                                                                            /* return error */
+        return 2;                                                                         /* return error */
     }
-    if (handle->inited != 1)                                                                 /* check handle initialization */
+    if (handle->inited != 1)                                                              /* check handle initialization */
     {
-        return 3;                                                                            /* return error */
+        return 3;                                                                         /* return error */
     }
-    
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FIFO_STATUS, (uint8_t *)status, 1);       /* get fifo status failed */
-    if (res != 0)                                                                            /* check result */
+    if (len > 32)
     {
-        handle->debug_print("nrf24l01: get fifo status failed.\n");                          /* get fifo status failed */
+        handle->debug_print("nrf24l01: len is over 32.\n");                               /* len is over 32 */
        
-        return 1;                                                                            /* return error */
+        return 4;                                                                         /* return error */
     }
     
-    return 0;                                                                                /* success return 0 */
+    res = a_nrf24l01_payload_read(handle, NRF24L01_COMMAND_R_RX_PAYLOAD, buf, len);       /* get rx payload */
+    if (res != 0)                                                                         /* check result */
+    {
+        handle->debug_print("nrf24l01: get rx payload failed.\n");                        /* get rx payload failed */
+       
+        return 1;                                                                         /* return error */
+    }
+
+    return 0;                                                                             /* success return 0 */
 }
 
 /**
- * @brief     enable or disable the pipe dynamic payload
+ * @brief     write the tx payload
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] pipe pipe number
- * @param[in] enable bool value
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len buffer length
  * @return    status code
  *            - 0 success
- *            - 1 set pipe dynamic payload failed
+ *            - 1 write tx payload failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
+ *            - 4 len is over 32
  * @note      none
  */
-uint8_t nrf24l01_set_pipe_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, nrf24l01_bool_t enable)
+uint8_t nrf24l01_write_tx_payload(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len)
 {
     uint8_t res;
-    uint8_t prev;
     
-    if (handle == NULL)                                                                        /* check handle */
+    if (handle == NULL)                                                                    /* check handle */
     {
-        return 2;                                                                              /* return error */
+        return 2;                                                                          /* return error */
     }
-    if (handle->inited != 1)                                                                   /* check handle initialization */
+    if (handle->inited != 1)                                                               /* check handle initialization */
     {
-        return 3;                                                                              /* return error */
+        return 3;                                                                          /* return error */
+    }
+    if (len > 32)                                                                          /* check len */
+    {
+        handle->debug_print("nrf24l01: len is over 32.\n");                                /* len is over 32 */
+       
+        return 4;                                                                          /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_DYNPD, (uint8_t *)&prev, 1);                /* get dynamic payload length register */
-    if (res != 0)                                                                              /* check result */
+    res = a_nrf24l01_payload_write(handle, NRF24L01_COMMAND_W_TX_PAYLOAD, buf, len);       /* set tx payload */
+    if (res != 0)                                                                          /* check result */
+    {
+        handle->debug_print("nrf24l01: set tx payload failed.\n");                         /* set tx payload failed */
+       
+        return 1;                                                                          /* return error */
+    }
+    a_nrf24l01_stats_tx(handle, 0, 0);                                                     /* sent++ */
+
+    return 0;                                                                              /* success return 0 */
+}
+
+/**
+ * @brief     flush tx
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush tx failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t nrf24l01_flush_tx(nrf24l01_handle_t *handle)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                               /* check handle */
+    {
+        return 2;                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                          /* check handle initialization */
     {
-        handle->debug_print("nrf24l01: get dynamic payload length register failed.\n");        /* get dynamic payload length register failed */
-       
-        return 1;                                                                              /* return error */
+        return 3;                                                                     /* return error */
     }
-    prev &= ~(1 << pipe);                                                                      /* clear config */
-    prev |= enable << pipe;                                                                    /* set bool */
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_DYNPD, (uint8_t *)&prev, 1);               /* set dynamic payload length register */
-    if (res != 0)                                                                              /* check result */
+    
+    res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_TX, NULL, 0);       /* flush tx */
+    if (res != 0)                                                                     /* check result */
     {
-        handle->debug_print("nrf24l01: set dynamic payload length register failed.\n");        /* set dynamic payload length register failed */
+        handle->debug_print("nrf24l01: flush tx failed.\n");                          /* flush tx failed */
        
-        return 1;                                                                              /* return error */
+        return 1;                                                                     /* return error */
     }
-    
-    return 0;                                                                                  /* success return 0 */
+
+    return 0;                                                                         /* success return 0 */
 }
 
 /**
- * @brief      get the pipe dynamic payload status
- * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[in]  pipe pipe number
- * @param[out] *enable pointer to a bool value buffer
- * @return     status code
- *             - 0 success
- *             - 1 get pipe dynamic payload failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ * @brief     flush rx
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush rx failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
  */
-uint8_t nrf24l01_get_pipe_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, nrf24l01_bool_t *enable)
+uint8_t nrf24l01_flush_rx(nrf24l01_handle_t *handle)
 {
     uint8_t res;
-    uint8_t prev;
     
-    if (handle == NULL)                                                                        /* check handle */
+    if (handle == NULL)                                                               /* check handle */
     {
-        return 2;                                                                              /* return error */
+        return 2;                                                                     /* return error */
     }
-    if (handle->inited != 1)                                                                   /* check handle initialization */
+    if (handle->inited != 1)                                                          /* check handle initialization */
     {
-        return 3;                                                                              /* return error */
+        return 3;                                                                     /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_DYNPD, (uint8_t *)&prev, 1);                /* get dynamic payload length register */
-    if (res != 0)                                                                              /* check result */
+    res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_RX, NULL, 0);       /* flush rx */
+    if (res != 0)                                                                     /* check result */
     {
-        handle->debug_print("nrf24l01: get dynamic payload length register failed.\n");        /* get dynamic payload length register failed */
+        handle->debug_print("nrf24l01: flush rx failed.\n");                          /* flush rx failed */
        
-        return 1;                                                                              /* return error */
+        return 1;                                                                     /* return error */
     }
-    *enable = (nrf24l01_bool_t)((prev >> pipe) & 0x01);                                        /* get bool */
-    
-    return 0;                                                                                  /* success return 0 */
+
+    return 0;                                                                         /* success return 0 */
 }
 
 /**
- * @brief     enable or disable the dynamic payload
+ * @brief     reuse the tx payload
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] enable bool value
  * @return    status code
  *            - 0 success
- *            - 1 set dynamic payload failed
+ *            - 1 reuse tx payload failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  * @note      none
  */
-uint8_t nrf24l01_set_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
+uint8_t nrf24l01_reuse_tx_payload(nrf24l01_handle_t *handle)
 {
     uint8_t res;
-    uint8_t prev;
     
     if (handle == NULL)                                                                  /* check handle */
     {
@@ -3205,41 +9494,31 @@ uint8_t nrf24l01_set_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_bool_t
         return 3;                                                                        /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
-    if (res != 0)                                                                        /* check result */
-    {
-        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
-       
-        return 1;                                                                        /* return error */
-    }
-    prev &= ~(1 << 2);                                                                   /* clear config */
-    prev |= enable << 2;                                                                 /* set bool */
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);       /* set feature register */
+    res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_REUSE_TX_PL, NULL, 0);       /* reuse tx payload */
     if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: set feature register failed.\n");                 /* set feature register failed */
+        handle->debug_print("nrf24l01: reuse tx payload failed.\n");                     /* reuse tx payload failed */
        
         return 1;                                                                        /* return error */
     }
-    
+
     return 0;                                                                            /* success return 0 */
 }
 
 /**
- * @brief      get the dynamic payload status
+ * @brief      get the rx payload width
  * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[out] *enable pointer to a bool value buffer
+ * @param[out] *width pointer to a width buffer
  * @return     status code
  *             - 0 success
- *             - 1 get dynamic payload failed
+ *             - 1 get rx payload width failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t nrf24l01_get_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
+uint8_t nrf24l01_get_rx_payload_width(nrf24l01_handle_t *handle, uint8_t *width)
 {
     uint8_t res;
-    uint8_t prev;
     
     if (handle == NULL)                                                                  /* check handle */
     {
@@ -3250,581 +9529,773 @@ uint8_t nrf24l01_get_dynamic_payload(nrf24l01_handle_t *handle, nrf24l01_bool_t
         return 3;                                                                        /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
+    res = a_nrf24l01_command_read(handle, NRF24L01_COMMAND_R_RX_PL_WID, width, 1);       /* get payload width */
     if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
+        handle->debug_print("nrf24l01: get payload width failed.\n");                    /* get payload width failed */
        
         return 1;                                                                        /* return error */
     }
-    *enable = (nrf24l01_bool_t)((prev >> 2) & 0x01);                                     /* get bool */
-    
+
     return 0;                                                                            /* success return 0 */
 }
 
 /**
- * @brief     enable or disable the payload with ack
+ * @brief     write the payload with ack
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] enable bool value
+ * @param[in] pipe pipe number
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len buffer length
  * @return    status code
  *            - 0 success
- *            - 1 set payload with ack failed
+ *            - 1 write payload with ack failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 len is over 32
+ * @note      used in rx mode
  */
-uint8_t nrf24l01_set_payload_with_ack(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
+uint8_t nrf24l01_write_payload_with_ack(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, uint8_t *buf, uint8_t len)
 {
     uint8_t res;
-    uint8_t prev;
     
-    if (handle == NULL)                                                                  /* check handle */
+    if (handle == NULL)                                                        /* check handle */
     {
-        return 2;                                                                        /* return error */
+        return 2;                                                              /* return error */
     }
-    if (handle->inited != 1)                                                             /* check handle initialization */
+    if (handle->inited != 1)                                                   /* check handle initialization */
     {
-        return 3;                                                                        /* return error */
+        return 3;                                                              /* return error */
     }
-    
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
-    if (res != 0)                                                                        /* check result */
+    if (len > 32)                                                              /* check len */
     {
-        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
+        handle->debug_print("nrf24l01: len is over 32.\n");                    /* len is over 32 */
        
-        return 1;                                                                        /* return error */
+        return 4;                                                              /* return error */
     }
-    prev &= ~(1 << 1);                                                                   /* clear config */
-    prev |= enable << 1;                                                                 /* set bool */
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);       /* set feature register */
-    if (res != 0)                                                                        /* check result */
+    
+    res = a_nrf24l01_payload_write(handle, (uint8_t)(NRF24L01_COMMAND_W_ACK_PAYLOAD | pipe),
+                                   buf, len);                                  /* set payload with ack */
+    if (res != 0)                                                              /* check result */
     {
-        handle->debug_print("nrf24l01: set feature register failed.\n");                 /* set feature register failed */
+        handle->debug_print("nrf24l01: set payload with ack failed.\n");       /* set payload with ack failed */
        
-        return 1;                                                                        /* return error */
+        return 1;                                                              /* return error */
     }
-    
-    return 0;                                                                            /* success return 0 */
+
+    return 0;                                                                  /* success return 0 */
 }
 
 /**
- * @brief      get the payload with ack status
- * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[out] *enable pointer to a bool value buffer
- * @return     status code
- *             - 0 success
- *             - 1 get payload with ack failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ * @brief     write the payload with no ack
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write payload with no ack failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is over 32
+ * @note      none
  */
-uint8_t nrf24l01_get_payload_with_ack(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
+uint8_t nrf24l01_write_payload_with_no_ack(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len)
 {
     uint8_t res;
-    uint8_t prev;
     
-    if (handle == NULL)                                                                 /* check handle */
+    if (handle == NULL)                                                                           /* check handle */
     {
-        return 2;                                                                       /* return error */
+        return 2;                                                                                 /* return error */
     }
-    if (handle->inited != 1)                                                            /* check handle initialization */
+    if (handle->inited != 1)                                                                      /* check handle initialization */
     {
-        return 3;                                                                       /* return error */
+        return 3;                                                                                 /* return error */
     }
-    
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);       /* get feature register */
-    if (res != 0)                                                                       /* check result */
+    if (len > 32)                                                                                 /* check len */
     {
-        handle->debug_print("nrf24l01: get feature register failed.\n");                /* get feature register failed */
+        handle->debug_print("nrf24l01: len is over 32.\n");                                       /* len is over 32 */
        
-        return 1;                                                                       /* return error */
+        return 4;                                                                                 /* return error */
     }
-    *enable = (nrf24l01_bool_t)((prev >> 1) & 0x01);                                    /* get bool */
     
-    return 0;                                                                           /* success return 0 */
+    res = a_nrf24l01_payload_write(handle, NRF24L01_COMMAND_W_TX_PAYLOAD_NO_ACK, buf, len);       /* set payload with no ack */
+    if (res != 0)                                                                                 /* check result */
+    {
+        handle->debug_print("nrf24l01: set payload with no ack failed.\n");                       /* set payload with no ack failed */
+       
+        return 1;                                                                                 /* return error */
+    }
+    a_nrf24l01_stats_tx(handle, 0, 0);                                                            /* sent++ */
+
+    return 0;                                                                                     /* success return 0 */
 }
 
 /**
- * @brief     enable or disable the tx payload with no ack
+ * @brief     nop
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] enable bool value
  * @return    status code
  *            - 0 success
- *            - 1 set tx payload with no ack failed
+ *            - 1 nop failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  * @note      none
  */
-uint8_t nrf24l01_set_tx_payload_with_no_ack(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
+uint8_t nrf24l01_nop(nrf24l01_handle_t *handle)
 {
     uint8_t res;
-    uint8_t prev;
     
-    if (handle == NULL)                                                                  /* check handle */
+    if (handle == NULL)                                                          /* check handle */
     {
-        return 2;                                                                        /* return error */
+        return 2;                                                                /* return error */
     }
-    if (handle->inited != 1)                                                             /* check handle initialization */
+    if (handle->inited != 1)                                                     /* check handle initialization */
     {
-        return 3;                                                                        /* return error */
+        return 3;                                                                /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
-    if (res != 0)                                                                        /* check result */
-    {
-        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
-       
-        return 1;                                                                        /* return error */
-    }
-    prev &= ~(1 << 0);                                                                   /* clear config */
-    prev |= enable << 0;                                                                 /* set bool */
-    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);       /* set feature register */
-    if (res != 0)                                                                        /* check result */
+    res = a_nrf24l01_command_write(handle, NRF24L01_COMMAND_NOP, NULL, 0);       /* nop */
+    if (res != 0)                                                                /* check result */
     {
-        handle->debug_print("nrf24l01: set feature register failed.\n");                 /* set feature register failed */
+        handle->debug_print("nrf24l01: nop failed.\n");                          /* nop failed */
        
-        return 1;                                                                        /* return error */
+        return 1;                                                                /* return error */
     }
-    
-    return 0;                                                                            /* success return 0 */
+
+    return 0;                                                                    /* success return 0 */
 }
 
 /**
- * @brief      get the tx payload with no ack status
+ * @brief      get the last status
  * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[out] *enable pointer to a bool value buffer
+ * @param[out] *status pointer to a status buffer
  * @return     status code
  *             - 0 success
- *             - 1 get tx payload with no ack failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
- * @note       none
+ * @note       no spi transaction, the status is refreshed by every command when spi_transfer
+ *             is linked, otherwise only by the status register reads
  */
-uint8_t nrf24l01_get_tx_payload_with_no_ack(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
+uint8_t nrf24l01_get_last_status(nrf24l01_handle_t *handle, uint8_t *status)
 {
-    uint8_t res;
-    uint8_t prev;
-    
-    if (handle == NULL)                                                                  /* check handle */
+    if (handle == NULL)                 /* check handle */
     {
-        return 2;                                                                        /* return error */
+        return 2;                       /* return error */
     }
-    if (handle->inited != 1)                                                             /* check handle initialization */
+    if (handle->inited != 1)            /* check handle initialization */
     {
-        return 3;                                                                        /* return error */
+        return 3;                       /* return error */
+    }
+
+    *status = handle->status;           /* get status */
+
+    return 0;                           /* success return 0 */
+}
+
+/**
+ * @brief     set the register shadow
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *shadow pointer to a caller allocated register shadow, NULL disables the shadow
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the shadow is emptied on every call, when set the setters only write
+ *            the chip and the getters answer from the shadow after the first access
+ */
+uint8_t nrf24l01_set_register_shadow(nrf24l01_handle_t *handle, nrf24l01_shadow_t *shadow)
+{
+    if (handle == NULL)                   /* check handle */
+    {
+        return 2;                         /* return error */
+    }
+    if (handle->inited != 1)              /* check handle initialization */
+    {
+        return 3;                         /* return error */
     }
     
-    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_FEATURE, (uint8_t *)&prev, 1);        /* get feature register */
-    if (res != 0)                                                                        /* check result */
+    handle->shadow = NULL;                /* stop the shadow */
+    if (shadow == NULL)                   /* check shadow */
     {
-        handle->debug_print("nrf24l01: get feature register failed.\n");                 /* get feature register failed */
-       
-        return 1;                                                                        /* return error */
+        return 0;                         /* success return 0 */
     }
-    *enable = (nrf24l01_bool_t)((prev >> 0) & 0x01);                                     /* get bool */
+    shadow->valid = 0;                    /* clear the valid mask */
+    handle->shadow = shadow;              /* set the shadow */
     
-    return 0;                                                                            /* success return 0 */
+    return 0;                             /* success return 0 */
 }
 
 /**
- * @brief      read the rx payload
+ * @brief      get the register shadow status
  * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[out] *buf pointer to a data buffer
- * @param[in]  len buffer length
+ * @param[out] *enable pointer to a bool value buffer
  * @return     status code
  *             - 0 success
- *             - 1 read rx payload failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
- *             - 4 len is over 32
  * @note       none
  */
-uint8_t nrf24l01_read_rx_payload(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len)
+uint8_t nrf24l01_get_register_shadow(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
 {
-    uint8_t res;
-    uint8_t i;
-    uint8_t k;
-    uint8_t tmp;
-    
-    if (handle == NULL)                                                     /* check handle */
-    {
-        return 2;                                                           /* return error */
-    }
-    if (handle->inited != 1)                                                /* check handle initialization */
-    {
-        return 3;                                                           /* return error */
-    }
-    if (len > 32)
-    {
-        handle->debug_print("nrf24l01: len is over 32.\n");                 /* len is over 32 */
-       
-        return 4;                                                           /* return error */
-    }
-    
-    res = handle->spi_read(NRF24L01_COMMAND_R_RX_PAYLOAD, buf, len);        /* get rx payload */
-    if (res != 0)                                                           /* check result */
+    if (handle == NULL)                                              /* check handle */
     {
-        handle->debug_print("nrf24l01: get rx payload failed.\n");          /* get rx payload failed */
-       
-        return 1;                                                           /* return error */
+        return 2;                                                    /* return error */
     }
-    k = len / 2;                                                            /* get the half */
-    for (i = 0; i < k; i++)                                                 /* run k times */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        tmp = buf[i];                                                       /* copy to tmp */
-        buf[i] = buf[len - 1 - i];                                          /* buf[i] = buf[n - 1 - i] */
-        buf[len - 1 - i] = tmp;                                             /* set buf[n - 1 - i]*/
+        return 3;                                                    /* return error */
     }
-
-    return 0;                                                               /* success return 0 */
+    
+    *enable = (nrf24l01_bool_t)(handle->shadow != NULL);             /* get enable */
+    
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief     write the tx payload
+ * @brief     invalidate the register shadow
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] *buf pointer to a data buffer
- * @param[in] len buffer length
  * @return    status code
  *            - 0 success
- *            - 1 write tx payload failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 len is over 32
- * @note      none
+ * @note      call it after the chip is reset or powered off outside the driver
  */
-uint8_t nrf24l01_write_tx_payload(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len)
+uint8_t nrf24l01_register_shadow_invalidate(nrf24l01_handle_t *handle)
 {
-    uint8_t res;
-    uint8_t i;
-    uint8_t k;
-    uint8_t tmp;
-    uint8_t buffer[32];
-    
-    if (handle == NULL)                                                                    /* check handle */
+    if (handle == NULL)                    /* check handle */
     {
-        return 2;                                                                          /* return error */
-    }
-    if (handle->inited != 1)                                                               /* check handle initialization */
-    {
-        return 3;                                                                          /* return error */
+        return 2;                          /* return error */
     }
-    if (len > 32)                                                                          /* check len */
+    if (handle->inited != 1)               /* check handle initialization */
     {
-        handle->debug_print("nrf24l01: len is over 32.\n");                                /* len is over 32 */
-       
-        return 4;                                                                          /* return error */
+        return 3;                          /* return error */
     }
     
-    for (i = 0; i < len; i++)                                                              /* copy the data */
-    {
-        buffer[i] = buf[i];                                                                /* copy */
-    }
-    k = len / 2;                                                                           /* get the half */
-    for (i = 0; i < k; i++)                                                                /* run k times */
-    {
-        tmp = buffer[i];                                                                   /* copy to tmp */
-        buffer[i] = buffer[len - 1 - i];                                                   /* buffer[i] = buffer[n - 1 - i] */
-        buffer[len - 1 - i] = tmp;                                                         /* set buffer[n - 1 - i]*/
-    }
-    res = handle->spi_write(NRF24L01_COMMAND_W_TX_PAYLOAD, (uint8_t *)buffer, len);        /* set tx payload */
-    if (res != 0)                                                                          /* check result */
+    if (handle->shadow != NULL)            /* check shadow */
     {
-        handle->debug_print("nrf24l01: set tx payload failed.\n");                         /* set tx payload failed */
-       
-        return 1;                                                                          /* return error */
+        handle->shadow->valid = 0;         /* clear the valid mask */
     }
-
-    return 0;                                                                              /* success return 0 */
+    
+    return 0;                              /* success return 0 */
 }
 
 /**
- * @brief     flush tx
+ * @brief     resync the register shadow from the chip
  * @param[in] *handle pointer to an nrf24l01 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 flush tx failed
+ *            - 1 register shadow sync failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
+ *            - 4 register shadow is disabled
  * @note      none
  */
-uint8_t nrf24l01_flush_tx(nrf24l01_handle_t *handle)
+uint8_t nrf24l01_register_shadow_sync(nrf24l01_handle_t *handle)
 {
     uint8_t res;
+    uint8_t reg;
+    uint8_t buf[5];
     
-    if (handle == NULL)                                                 /* check handle */
+    if (handle == NULL)                                                                          /* check handle */
     {
-        return 2;                                                       /* return error */
+        return 2;                                                                                /* return error */
     }
-    if (handle->inited != 1)                                            /* check handle initialization */
+    if (handle->inited != 1)                                                                     /* check handle initialization */
     {
-        return 3;                                                       /* return error */
+        return 3;                                                                                /* return error */
+    }
+    if (handle->shadow == NULL)                                                                  /* check shadow */
+    {
+        handle->debug_print("nrf24l01: register shadow is disabled.\n");                         /* register shadow is disabled */
+        
+        return 4;                                                                                /* return error */
     }
     
-    res = handle->spi_write(NRF24L01_COMMAND_FLUSH_TX, NULL, 0);        /* flush tx */
-    if (res != 0)                                                       /* check result */
+    handle->shadow->valid = 0;                                                                   /* clear the valid mask */
+    for (reg = NRF24L01_REG_CONFIG; reg <= NRF24L01_REG_FEATURE; reg++)                          /* read all registers */
     {
-        handle->debug_print("nrf24l01: flush tx failed.\n");            /* flush tx failed */
-       
-        return 1;                                                       /* return error */
+        if ((NRF24L01_SHADOW_MASK & (1UL << reg)) == 0)                                          /* skip the volatile registers */
+        {
+            continue;                                                                            /* next */
+        }
+        res = a_nrf24l01_spi_read(handle, reg, (uint8_t *)buf,
+                                  (a_nrf24l01_shadow_address_index(reg) != 0xFF) ? 5 : 1);       /* read register */
+        if (res != 0)                                                                            /* check result */
+        {
+            handle->debug_print("nrf24l01: register shadow sync failed.\n");                     /* register shadow sync failed */
+            handle->shadow->valid = 0;                                                           /* clear the valid mask */
+            
+            return 1;                                                                            /* return error */
+        }
     }
-
-    return 0;                                                           /* success return 0 */
+    
+    return 0;                                                                                    /* success return 0 */
 }
 
 /**
- * @brief     flush rx
+ * @brief     enable or disable the rx fifo drain
  * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] enable bool value
  * @return    status code
  *            - 0 success
- *            - 1 flush rx failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      when enabled the irq handler delivers every payload in the rx fifo
+ *            until the status pipe field reads empty
  */
-uint8_t nrf24l01_flush_rx(nrf24l01_handle_t *handle)
+uint8_t nrf24l01_set_rx_drain(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
 {
-    uint8_t res;
-    
-    if (handle == NULL)                                                 /* check handle */
+    if (handle == NULL)                          /* check handle */
     {
-        return 2;                                                       /* return error */
+        return 2;                                /* return error */
     }
-    if (handle->inited != 1)                                            /* check handle initialization */
+    if (handle->inited != 1)                     /* check handle initialization */
     {
-        return 3;                                                       /* return error */
+        return 3;                                /* return error */
     }
     
-    res = handle->spi_write(NRF24L01_COMMAND_FLUSH_RX, NULL, 0);        /* flush rx */
-    if (res != 0)                                                       /* check result */
+    handle->rx_drain = (uint8_t)enable;          /* set enable */
+    
+    return 0;                                    /* success return 0 */
+}
+
+/**
+ * @brief      get the rx fifo drain status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_rx_drain(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
+{
+    if (handle == NULL)                                       /* check handle */
     {
-        handle->debug_print("nrf24l01: flush rx failed.\n");            /* flush rx failed */
-       
-        return 1;                                                       /* return error */
+        return 2;                                             /* return error */
     }
-
-    return 0;                                                           /* success return 0 */
+    if (handle->inited != 1)                                  /* check handle initialization */
+    {
+        return 3;                                             /* return error */
+    }
+    
+    *enable = (nrf24l01_bool_t)(handle->rx_drain);            /* get enable */
+    
+    return 0;                                                 /* success return 0 */
 }
 
 /**
- * @brief     reuse the tx payload
+ * @brief     enable or disable the payload wire order
  * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] enable bool value
  * @return    status code
  *            - 0 success
- *            - 1 reuse tx payload failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      when enabled payloads are passed to and from the chip untouched, the first byte
+ *            on the air is the first byte of the buffer, when disabled the legacy reversed order is kept
  */
-uint8_t nrf24l01_reuse_tx_payload(nrf24l01_handle_t *handle)
+uint8_t nrf24l01_set_wire_order(nrf24l01_handle_t *handle, nrf24l01_bool_t enable)
 {
-    uint8_t res;
-    
-    if (handle == NULL)                                                     /* check handle */
+    if (handle == NULL)                         /* check handle */
     {
-        return 2;                                                           /* return error */
+        return 2;                               /* return error */
     }
-    if (handle->inited != 1)                                                /* check handle initialization */
+    if (handle->inited != 1)                    /* check handle initialization */
     {
-        return 3;                                                           /* return error */
+        return 3;                               /* return error */
     }
     
-    res = handle->spi_write(NRF24L01_COMMAND_REUSE_TX_PL, NULL, 0);         /* reuse tx payload */
-    if (res != 0)                                                           /* check result */
-    {
-        handle->debug_print("nrf24l01: reuse tx payload failed.\n");        /* reuse tx payload failed */
-       
-        return 1;                                                           /* return error */
-    }
-
-    return 0;                                                               /* success return 0 */
+    handle->wire_order = (uint8_t)enable;       /* set enable */
+    
+    return 0;                                   /* success return 0 */
 }
 
 /**
- * @brief      get the rx payload width
+ * @brief      get the payload wire order status
  * @param[in]  *handle pointer to an nrf24l01 handle structure
- * @param[out] *width pointer to a width buffer
+ * @param[out] *enable pointer to a bool value buffer
  * @return     status code
  *             - 0 success
- *             - 1 get rx payload width failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t nrf24l01_get_rx_payload_width(nrf24l01_handle_t *handle, uint8_t *width)
+uint8_t nrf24l01_get_wire_order(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable)
 {
-    uint8_t res;
-    
-    if (handle == NULL)                                                     /* check handle */
+    if (handle == NULL)                                    /* check handle */
     {
-        return 2;                                                           /* return error */
+        return 2;                                          /* return error */
     }
-    if (handle->inited != 1)                                                /* check handle initialization */
+    if (handle->inited != 1)                               /* check handle initialization */
     {
-        return 3;                                                           /* return error */
+        return 3;                                          /* return error */
     }
     
-    res = handle->spi_read(NRF24L01_COMMAND_R_RX_PL_WID, width, 1);         /* get payload width */
-    if (res != 0)                                                           /* check result */
-    {
-        handle->debug_print("nrf24l01: get payload width failed.\n");       /* get payload width failed */
-       
-        return 1;                                                           /* return error */
-    }
-
-    return 0;                                                               /* success return 0 */
+    *enable = (nrf24l01_bool_t)(handle->wire_order);       /* get enable */
+    
+    return 0;                                              /* success return 0 */
 }
 
 /**
- * @brief     write the payload with ack
+ * @brief     apply a configuration profile
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] pipe pipe number
- * @param[in] *buf pointer to a data buffer
- * @param[in] len buffer length
+ * @param[in] *profile pointer to a profile structure
  * @return    status code
  *            - 0 success
- *            - 1 write payload with ack failed
+ *            - 1 apply profile failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 len is over 32
- * @note      used in rx mode
+ *            - 4 profile is invalid
+ *            - 5 send is busy
+ * @note      every register is composed in full and only written when it differs from the chip,
+ *            with the register shadow enabled the comparison needs no spi read, the pending
+ *            interrupts are left to the caller, addresses use the same byte order as the address
+ *            setters and ce should be low while applying, powering the chip up waits
+ *            the 1.5 ms start up time
  */
-uint8_t nrf24l01_write_payload_with_ack(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, uint8_t *buf, uint8_t len)
+uint8_t nrf24l01_apply_profile(nrf24l01_handle_t *handle, const nrf24l01_profile_t *profile)
 {
     uint8_t res;
     uint8_t i;
-    uint8_t k;
-    uint8_t tmp;
-    uint8_t buffer[32];
+    uint8_t len;
+    uint8_t config;
+    uint8_t reg[15];
+    uint8_t mask[15];
+    uint8_t value[15];
+    uint8_t addr[3][5];
     
-    if (handle == NULL)                                                                            /* check handle */
+    if (handle == NULL)                                                                                                /* check handle */
     {
-        return 2;                                                                                  /* return error */
+        return 2;                                                                                                      /* return error */
     }
-    if (handle->inited != 1)                                                                       /* check handle initialization */
+    if (handle->inited != 1)                                                                                           /* check handle initialization */
     {
-        return 3;                                                                                  /* return error */
+        return 3;                                                                                                      /* return error */
     }
-    if (len > 32)                                                                                  /* check len */
+    if (profile == NULL)                                                                                               /* check profile */
     {
-        handle->debug_print("nrf24l01: len is over 32.\n");                                        /* len is over 32 */
-       
-        return 4;                                                                                  /* return error */
+        handle->debug_print("nrf24l01: profile is null.\n");                                                           /* profile is null */
+        
+        return 4;                                                                                                      /* return error */
+    }
+    if (handle->sending != 0)                                                                                          /* check sending */
+    {
+        handle->debug_print("nrf24l01: send is busy.\n");                                                              /* send is busy */
+        
+        return 5;                                                                                                      /* return error */
+    }
+    if ((profile->address_width < NRF24L01_ADDRESS_WIDTH_3_BYTES) ||
+        (profile->address_width > NRF24L01_ADDRESS_WIDTH_5_BYTES))                                                     /* check address width */
+    {
+        handle->debug_print("nrf24l01: address width is invalid.\n");                                                  /* address width is invalid */
+        
+        return 4;                                                                                                      /* return error */
+    }
+    if ((profile->retransmit_delay > 0xF) || (profile->retransmit_count > 0xF))                                        /* check retransmit */
+    {
+        handle->debug_print("nrf24l01: retransmit is over 0xF.\n");                                                    /* retransmit is over 0xF */
+        
+        return 4;                                                                                                      /* return error */
+    }
+    if (profile->channel_frequency > 0x7F)                                                                             /* check channel frequency */
+    {
+        handle->debug_print("nrf24l01: channel frequency is over 0x7F.\n");                                            /* channel frequency is over 0x7F */
+        
+        return 4;                                                                                                      /* return error */
+    }
+    if ((profile->data_rate > NRF24L01_DATA_RATE_250K) || (profile->output_power > NRF24L01_OUTPUT_POWER_0_DBM))       /* check rf setup */
+    {
+        handle->debug_print("nrf24l01: rf setup is invalid.\n");                                                       /* rf setup is invalid */
+        
+        return 4;                                                                                                      /* return error */
+    }
+    for (i = 0; i < 6; i++)                                                                                            /* check all pipes */
+    {
+        if (profile->payload_number[i] > 32)                                                                           /* check payload number */
+        {
+            handle->debug_print("nrf24l01: payload number is over 32.\n");                                             /* payload number is over 32 */
+            
+            return 4;                                                                                                  /* return error */
+        }
+    }
+    
+    reg[0] = NRF24L01_REG_CONFIG;                                                                                      /* config register */
+    mask[0] = 0x7F;                                                                                                    /* all config bits */
+    value[0] = (uint8_t)(((profile->mask_rx_dr & 0x1) << 6) | ((profile->mask_tx_ds & 0x1) << 5) |
+                         ((profile->mask_max_rt & 0x1) << 4) | ((profile->crc & 0x1) << 3) |
+                         ((profile->crco & 0x1) << 2) | ((profile->power_up & 0x1) << 1) |
+                         ((profile->mode & 0x1) << 0));                                                                /* set config */
+    reg[1] = NRF24L01_REG_EN_AA;                                                                                       /* enable auto acknowledgment register */
+    reg[2] = NRF24L01_REG_EN_RXADDR;                                                                                   /* enabled rx addresses register */
+    reg[14] = NRF24L01_REG_DYNPD;                                                                                      /* enable dynamic payload length register */
+    mask[1] = 0x3F;                                                                                                    /* pipe 0 - 5 */
+    mask[2] = 0x3F;                                                                                                    /* pipe 0 - 5 */
+    mask[14] = 0x3F;                                                                                                   /* pipe 0 - 5 */
+    value[1] = 0;                                                                                                      /* init 0 */
+    value[2] = 0;                                                                                                      /* init 0 */
+    value[14] = 0;                                                                                                     /* init 0 */
+    for (i = 0; i < 6; i++)                                                                                            /* set all pipes */
+    {
+        value[1] |= (uint8_t)((profile->auto_acknowledgment[i] & 0x1) << i);                                           /* set auto acknowledgment */
+        value[2] |= (uint8_t)((profile->rx_pipe[i] & 0x1) << i);                                                       /* set rx pipe */
+        value[14] |= (uint8_t)((profile->pipe_dynamic_payload[i] & 0x1) << i);                                         /* set pipe dynamic payload */
+        reg[7 + i] = (uint8_t)(NRF24L01_REG_RX_PW_P0 + i);                                                             /* rx payload width register */
+        mask[7 + i] = 0x3F;                                                                                            /* width bits */
+        value[7 + i] = profile->payload_number[i];                                                                     /* set payload number */
+    }
+    reg[3] = NRF24L01_REG_SETUP_AW;                                                                                    /* setup of address widths register */
+    mask[3] = 0x03;                                                                                                    /* width bits */
+    value[3] = (uint8_t)profile->address_width;                                                                        /* set address width */
+    reg[4] = NRF24L01_REG_SETUP_RETR;                                                                                  /* setup of automatic retransmission register */
+    mask[4] = 0xFF;                                                                                                    /* delay and count bits */
+    value[4] = (uint8_t)((profile->retransmit_delay << 4) | profile->retransmit_count);                                /* set retransmit */
+    reg[5] = NRF24L01_REG_RF_CH;                                                                                       /* rf channel register */
+    mask[5] = 0x7F;                                                                                                    /* channel bits */
+    value[5] = profile->channel_frequency;                                                                             /* set channel frequency */
+    reg[6] = NRF24L01_REG_RF_SETUP;                                                                                    /* rf setup register */
+    mask[6] = 0xBE;                                                                                                    /* cont wave, rate, pll lock and power bits */
+    value[6] = (uint8_t)(((profile->continuous_carrier_transmit & 0x1) << 7) |
+                         (((profile->data_rate >> 1) & 0x1) << 5) |
+                         ((profile->force_pll_lock_signal & 0x1) << 4) |
+                         (((profile->data_rate >> 0) & 0x1) << 3) |
+                         (profile->output_power << 1));                                                                /* set rf setup */
+    reg[13] = NRF24L01_REG_FEATURE;                                                                                    /* feature register */
+    mask[13] = 0x07;                                                                                                   /* feature bits */
+    value[13] = (uint8_t)(((profile->dynamic_payload & 0x1) << 2) | ((profile->payload_with_ack & 0x1) << 1) |
+                          ((profile->tx_payload_with_no_ack & 0x1) << 0));                                             /* set feature */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_CONFIG, &config, 1);                                                /* get config */
+    if (res != 0)                                                                                                      /* check result */
+    {
+        handle->debug_print("nrf24l01: get config failed.\n");                                                         /* get config failed */
+        
+        return 1;                                                                                                      /* return error */
+    }
+    for (i = 0; i < 15; i++)                                                                                           /* update all registers in order */
+    {
+        res = a_nrf24l01_spi_update(handle, reg[i], &value[i], 1, mask[i]);                                            /* update register */
+        if (res != 0)                                                                                                  /* check result */
+        {
+            handle->debug_print("nrf24l01: update register 0x%02X failed.\n", reg[i]);                                 /* update register failed */
+            
+            return 1;                                                                                                  /* return error */
+        }
     }
     
-    for (i = 0; i < len; i++)                                                                      /* copy the data */
+    len = (uint8_t)(profile->address_width + 2);                                                                       /* get address length */
+    for (i = 0; i < len; i++)                                                                                          /* reverse the addresses */
     {
-        buffer[i] = buf[i];                                                                        /* copy */
+        addr[0][i] = profile->rx_pipe_0_address[len - 1 - i];                                                          /* rx pipe 0 */
+        addr[1][i] = profile->rx_pipe_1_address[len - 1 - i];                                                          /* rx pipe 1 */
+        addr[2][i] = profile->tx_address[len - 1 - i];                                                                 /* tx address */
     }
-    k = len / 2;                                                                                   /* get the half */
-    for (i = 0; i < k; i++)                                                                        /* run k times */
+    res = a_nrf24l01_spi_update(handle, NRF24L01_REG_RX_ADDR_P0, addr[0], len, 0xFF);                                  /* update rx pipe 0 address */
+    if (res != 0)                                                                                                      /* check result */
     {
-        tmp = buffer[i];                                                                           /* copy to tmp */
-        buffer[i] = buffer[len - 1 - i];                                                           /* buffer[i] = buffer[n - 1 - i] */
-        buffer[len - 1 - i] = tmp;                                                                 /* set buffer[n - 1 - i]*/
+        handle->debug_print("nrf24l01: update rx pipe 0 address failed.\n");                                           /* update rx pipe 0 address failed */
+        
+        return 1;                                                                                                      /* return error */
     }
-    res = handle->spi_write((uint8_t)(NRF24L01_COMMAND_W_ACK_PAYLOAD | pipe),
-                            (uint8_t *)buffer, len);                                               /* set payload with ack */
-    if (res != 0)                                                                                  /* check result */
+    res = a_nrf24l01_spi_update(handle, NRF24L01_REG_RX_ADDR_P1, addr[1], len, 0xFF);                                  /* update rx pipe 1 address */
+    if (res != 0)                                                                                                      /* check result */
     {
-        handle->debug_print("nrf24l01: set payload with ack failed.\n");                           /* set payload with ack failed */
-       
-        return 1;                                                                                  /* return error */
+        handle->debug_print("nrf24l01: update rx pipe 1 address failed.\n");                                           /* update rx pipe 1 address failed */
+        
+        return 1;                                                                                                      /* return error */
     }
-
-    return 0;                                                                                      /* success return 0 */
+    for (i = 0; i < 4; i++)                                                                                            /* rx pipe 2 - 5 */
+    {
+        value[0] = profile->rx_pipe_address[i];                                                                        /* set address byte */
+        res = a_nrf24l01_spi_update(handle, (uint8_t)(NRF24L01_REG_RX_ADDR_P2 + i), &value[0], 1, 0xFF);               /* update rx pipe address */
+        if (res != 0)                                                                                                  /* check result */
+        {
+            handle->debug_print("nrf24l01: update rx pipe %d address failed.\n", i + 2);                               /* update rx pipe address failed */
+            
+            return 1;                                                                                                  /* return error */
+        }
+    }
+    res = a_nrf24l01_spi_update(handle, NRF24L01_REG_TX_ADDR, addr[2], len, 0xFF);                                     /* update tx address */
+    if (res != 0)                                                                                                      /* check result */
+    {
+        handle->debug_print("nrf24l01: update tx address failed.\n");                                                  /* update tx address failed */
+        
+        return 1;                                                                                                      /* return error */
+    }
+    if (((config & (1 << 1)) == 0) && (profile->power_up != 0))                                                        /* check power up */
+    {
+        a_nrf24l01_delay_us(handle, NRF24L01_POWER_UP_US);                                                             /* wait the crystal oscillator */
+    }
+    
+    return 0;                                                                                                          /* success return 0 */
 }
 
 /**
- * @brief     write the payload with no ack
- * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] *buf pointer to a data buffer
- * @param[in] len buffer length
- * @return    status code
- *            - 0 success
- *            - 1 write payload with no ack failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- *            - 4 len is over 32
- * @note      none
+ * @brief      take a snapshot of the register file
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *buf pointer to a snapshot buffer
+ * @param[in]  len snapshot buffer length
+ * @return     status code
+ *             - 0 success
+ *             - 1 snapshot failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 len is too short
+ * @note       len must be at least NRF24L01_SNAPSHOT_LENGTH, the blob holds the configuration
+ *             registers and the pipe addresses in chip order followed by a crc16
  */
-uint8_t nrf24l01_write_payload_with_no_ack(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len)
+uint8_t nrf24l01_snapshot(nrf24l01_handle_t *handle, uint8_t *buf, uint16_t len)
 {
     uint8_t res;
     uint8_t i;
-    uint8_t k;
-    uint8_t tmp;
-    uint8_t buffer[32];
+    uint16_t crc;
     
-    if (handle == NULL)                                                                            /* check handle */
+    if (handle == NULL)                                                                                          /* check handle */
     {
-        return 2;                                                                                  /* return error */
+        return 2;                                                                                                /* return error */
     }
-    if (handle->inited != 1)                                                                       /* check handle initialization */
+    if (handle->inited != 1)                                                                                     /* check handle initialization */
     {
-        return 3;                                                                                  /* return error */
+        return 3;                                                                                                /* return error */
     }
-    if (len > 32)                                                                                  /* check len */
+    if (len < NRF24L01_SNAPSHOT_LENGTH)                                                                          /* check length */
     {
-        handle->debug_print("nrf24l01: len is over 32.\n");                                        /* len is over 32 */
-       
-        return 4;                                                                                  /* return error */
+        handle->debug_print("nrf24l01: len is too short.\n");                                                    /* len is too short */
+        
+        return 4;                                                                                                /* return error */
     }
     
-    for (i = 0; i < len; i++)                                                                      /* copy the data */
+    buf[0] = NRF24L01_SNAPSHOT_MAGIC;                                                                            /* set magic */
+    for (i = 0; i < NRF24L01_SNAPSHOT_REG_NUM; i++)                                                              /* read all registers */
     {
-        buffer[i] = buf[i];                                                                        /* copy */
+        res = a_nrf24l01_spi_read(handle, gsc_nrf24l01_snapshot_reg[i], &buf[1 + i], 1);                         /* read register */
+        if (res != 0)                                                                                            /* check result */
+        {
+            handle->debug_print("nrf24l01: read register 0x%02X failed.\n", gsc_nrf24l01_snapshot_reg[i]);       /* read register failed */
+            
+            return 1;                                                                                            /* return error */
+        }
     }
-    k = len / 2;                                                                                   /* get the half */
-    for (i = 0; i < k; i++)                                                                        /* run k times */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_ADDR_P0, &buf[20], 5);                                     /* read rx pipe 0 address */
+    if (res != 0)                                                                                                /* check result */
     {
-        tmp = buffer[i];                                                                           /* copy to tmp */
-        buffer[i] = buffer[len - 1 - i];                                                           /* buffer[i] = buffer[n - 1 - i] */
-        buffer[len - 1 - i] = tmp;                                                                 /* set buffer[n - 1 - i]*/
+        handle->debug_print("nrf24l01: get rx pipe 0 address failed.\n");                                        /* get rx pipe 0 address failed */
+        
+        return 1;                                                                                                /* return error */
     }
-    
-    res = handle->spi_write(NRF24L01_COMMAND_W_TX_PAYLOAD_NO_ACK, (uint8_t *)buffer, len);         /* set payload with no ack */
-    if (res != 0)                                                                                  /* check result */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_RX_ADDR_P1, &buf[25], 5);                                     /* read rx pipe 1 address */
+    if (res != 0)                                                                                                /* check result */
     {
-        handle->debug_print("nrf24l01: set payload with no ack failed.\n");                        /* set payload with no ack failed */
-       
-        return 1;                                                                                  /* return error */
+        handle->debug_print("nrf24l01: get rx pipe 1 address failed.\n");                                        /* get rx pipe 1 address failed */
+        
+        return 1;                                                                                                /* return error */
     }
-
-    return 0;                                                                                      /* success return 0 */
+    res = a_nrf24l01_spi_read(handle, NRF24L01_REG_TX_ADDR, &buf[30], 5);                                        /* read tx address */
+    if (res != 0)                                                                                                /* check result */
+    {
+        handle->debug_print("nrf24l01: get tx address failed.\n");                                               /* get tx address failed */
+        
+        return 1;                                                                                                /* return error */
+    }
+    crc = a_nrf24l01_crc16(buf, NRF24L01_SNAPSHOT_LENGTH - 2);                                                   /* get crc */
+    buf[35] = (uint8_t)((crc >> 8) & 0xFF);                                                                      /* set crc msb */
+    buf[36] = (uint8_t)((crc >> 0) & 0xFF);                                                                      /* set crc lsb */
+    
+    return 0;                                                                                                    /* success return 0 */
 }
 
 /**
- * @brief     nop
+ * @brief     restore the register file from a snapshot
  * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a snapshot buffer
+ * @param[in] len snapshot buffer length
  * @return    status code
  *            - 0 success
- *            - 1 nop failed
+ *            - 1 restore failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 snapshot is invalid
+ *            - 5 crc check failed
+ * @note      every register is written without read back, config is written last, then the
+ *            interrupts are cleared and both fifos are flushed, ce should be low while restoring
  */
-uint8_t nrf24l01_nop(nrf24l01_handle_t *handle)
+uint8_t nrf24l01_restore(nrf24l01_handle_t *handle, const uint8_t *buf, uint16_t len)
 {
     uint8_t res;
+    uint8_t i;
+    uint8_t prev;
+    uint8_t addr[5];
+    uint16_t crc;
     
-    if (handle == NULL)                                            /* check handle */
+    if (handle == NULL)                                                                                           /* check handle */
     {
-        return 2;                                                  /* return error */
+        return 2;                                                                                                 /* return error */
     }
-    if (handle->inited != 1)                                       /* check handle initialization */
+    if (handle->inited != 1)                                                                                      /* check handle initialization */
     {
-        return 3;                                                  /* return error */
+        return 3;                                                                                                 /* return error */
+    }
+    if ((buf == NULL) || (len < NRF24L01_SNAPSHOT_LENGTH) || (buf[0] != NRF24L01_SNAPSHOT_MAGIC))                 /* check snapshot */
+    {
+        handle->debug_print("nrf24l01: snapshot is invalid.\n");                                                  /* snapshot is invalid */
+        
+        return 4;                                                                                                 /* return error */
+    }
+    crc = a_nrf24l01_crc16(buf, NRF24L01_SNAPSHOT_LENGTH - 2);                                                    /* get crc */
+    if (crc != (uint16_t)(((uint16_t)buf[35] << 8) | buf[36]))                                                    /* check crc */
+    {
+        handle->debug_print("nrf24l01: crc check failed.\n");                                                     /* crc check failed */
+        
+        return 5;                                                                                                 /* return error */
     }
     
-    res = handle->spi_write(NRF24L01_COMMAND_NOP, NULL, 0);        /* nop */
-    if (res != 0)                                                  /* check result */
+    for (i = 0; i < 3; i++)                                                                                       /* write all addresses */
     {
-        handle->debug_print("nrf24l01: nop failed.\n");            /* nop failed */
-       
-        return 1;                                                  /* return error */
+        memcpy(addr, &buf[20 + i * 5], 5);                                                                        /* copy address */
+        res = a_nrf24l01_spi_write(handle, (i < 2) ? (uint8_t)(NRF24L01_REG_RX_ADDR_P0 + i) : NRF24L01_REG_TX_ADDR,
+                                   addr, 5);                                                                      /* write address */
+        if (res != 0)                                                                                             /* check result */
+        {
+            handle->debug_print("nrf24l01: set address failed.\n");                                               /* set address failed */
+            
+            return 1;                                                                                             /* return error */
+        }
     }
-
-    return 0;                                                      /* success return 0 */
+    for (i = 0; i < NRF24L01_SNAPSHOT_REG_NUM; i++)                                                               /* write all registers */
+    {
+        prev = buf[1 + i];                                                                                        /* get register */
+        res = a_nrf24l01_spi_write(handle, gsc_nrf24l01_snapshot_reg[i], &prev, 1);                               /* write register */
+        if (res != 0)                                                                                             /* check result */
+        {
+            handle->debug_print("nrf24l01: write register 0x%02X failed.\n", gsc_nrf24l01_snapshot_reg[i]);       /* write register failed */
+            
+            return 1;                                                                                             /* return error */
+        }
+    }
+    prev = (1 << 6) | (1 << 5) | (1 << 4);                                                                        /* rx_dr, tx_ds and max_rt */
+    res = a_nrf24l01_spi_write(handle, NRF24L01_REG_STATUS, &prev, 1);                                            /* clear the pending interrupts */
+    if (res != 0)                                                                                                 /* check result */
+    {
+        handle->debug_print("nrf24l01: clear interrupt failed.\n");                                               /* clear interrupt failed */
+        
+        return 1;                                                                                                 /* return error */
+    }
+    if (a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_TX, NULL, 0) != 0)                                /* flush tx */
+    {
+        handle->debug_print("nrf24l01: flush tx failed.\n");                                                      /* flush tx failed */
+        
+        return 1;                                                                                                 /* return error */
+    }
+    if (a_nrf24l01_command_write(handle, NRF24L01_COMMAND_FLUSH_RX, NULL, 0) != 0)                                /* flush rx */
+    {
+        handle->debug_print("nrf24l01: flush rx failed.\n");                                                      /* flush rx failed */
+        
+        return 1;                                                                                                 /* return error */
+    }
+    if ((buf[NRF24L01_SNAPSHOT_REG_NUM] & (1 << 1)) != 0)                                                         /* check power up */
+    {
+        a_nrf24l01_delay_us(handle, NRF24L01_POWER_UP_US);                                                        /* wait the crystal oscillator */
+    }
+    
+    return 0;                                                                                                     /* success return 0 */
 }
 
 /**
@@ -155,23 +155,468 @@ typedef enum
     NRF24L01_FIFO_STATUS_RX_EMPTY = 0,        /**< rx empty */
 } nrf24l01_fifo_status_t;
 
+/**
+ * @brief nrf24l01 send status enumeration definition
+ */
+typedef enum
+{
+    NRF24L01_SEND_STATUS_PENDING  = 0,        /**< waiting for the completion */
+    NRF24L01_SEND_STATUS_OK       = 1,        /**< tx data sent */
+    NRF24L01_SEND_STATUS_MAX_RT   = 2,        /**< maximum number of tx retransmits */
+    NRF24L01_SEND_STATUS_DEADLINE = 3,        /**< completion deadline missed */
+    NRF24L01_SEND_STATUS_HELD     = 4,        /**< tdma frames held for the next slot */
+} nrf24l01_send_status_t;
+
+/**
+ * @brief nrf24l01 sync role enumeration definition
+ */
+typedef enum
+{
+    NRF24L01_SYNC_ROLE_NONE   = 0x00,        /**< no time sync */
+    NRF24L01_SYNC_ROLE_MASTER = 0x01,        /**< send the beacons */
+    NRF24L01_SYNC_ROLE_SLAVE  = 0x02,        /**< follow the beacons */
+} nrf24l01_sync_role_t;
+
+/**
+ * @brief nrf24l01 power state enumeration definition
+ */
+typedef enum
+{
+    NRF24L01_POWER_STATE_POWER_DOWN = 0x00,        /**< pwr_up cleared */
+    NRF24L01_POWER_STATE_STANDBY_1  = 0x01,        /**< pwr_up set and ce low */
+    NRF24L01_POWER_STATE_STANDBY_2  = 0x02,        /**< ptx with ce high and no payload */
+    NRF24L01_POWER_STATE_RX         = 0x03,        /**< prx with ce high */
+    NRF24L01_POWER_STATE_TX         = 0x04,        /**< ptx with ce high sending */
+} nrf24l01_power_state_t;
+
+/**
+ * @brief nrf24l01 register shadow structure definition
+ */
+typedef struct nrf24l01_shadow_s
+{
+    uint32_t valid;              /**< valid register mask */
+    uint8_t reg[30];             /**< register 0x00 - 0x1D buffer */
+    uint8_t addr[3][5];          /**< rx pipe 0, rx pipe 1 and tx address buffer */
+    uint8_t addr_len[3];         /**< valid address length */
+} nrf24l01_shadow_t;
+
+/**
+ * @brief nrf24l01 tx stream structure definition
+ */
+typedef struct nrf24l01_stream_s
+{
+    uint8_t enable;                        /**< enable flag */
+    uint8_t failed;                        /**< failed flag */
+    uint8_t len;                           /**< payload length */
+    uint8_t *buf;                          /**< payload buffer */
+    nrf24l01_send_status_t *result;        /**< per payload result buffer */
+    uint16_t num;                          /**< payload number */
+    uint16_t loaded;                       /**< loaded payload number */
+    uint16_t done;                         /**< completed payload number */
+    uint8_t fragment;                      /**< fragment flag */
+    uint8_t id;                            /**< fragment message id */
+    uint16_t total;                        /**< fragment message length */
+} nrf24l01_stream_t;
+
+/**
+ * @brief nrf24l01 tx frame structure definition
+ */
+typedef struct nrf24l01_tx_frame_s
+{
+    uint8_t len;            /**< payload length */
+    uint8_t buf[32];        /**< payload buffer in the air order */
+} nrf24l01_tx_frame_t;
+
+/**
+ * @brief nrf24l01 tx ring structure definition
+ */
+typedef struct nrf24l01_tx_ring_s
+{
+    nrf24l01_tx_frame_t *frame;        /**< caller allocated frame buffer */
+    uint16_t depth;                    /**< frame buffer depth */
+    volatile uint16_t head;            /**< next frame to write */
+    volatile uint16_t load;            /**< next frame to load into the tx fifo */
+    volatile uint16_t tail;            /**< oldest frame in the tx fifo */
+    volatile uint32_t sent;            /**< sent frame counter */
+    volatile uint32_t failed;          /**< failed frame counter */
+} nrf24l01_tx_ring_t;
+
+/**
+ * @brief nrf24l01 rx frame structure definition
+ */
+typedef struct nrf24l01_rx_frame_s
+{
+    uint32_t timestamp;        /**< receive timestamp in us */
+    uint8_t pipe;              /**< pipe number */
+    uint8_t len;               /**< payload length */
+    uint8_t buf[32];           /**< payload buffer */
+} nrf24l01_rx_frame_t;
+
+/**
+ * @brief nrf24l01 rx queue structure definition
+ */
+typedef struct nrf24l01_rx_queue_s
+{
+    nrf24l01_rx_frame_t *frame;        /**< caller allocated frame buffer */
+    uint16_t depth;                    /**< frame buffer depth */
+    volatile uint16_t head;            /**< next frame to push, written by the irq handler only */
+    volatile uint16_t tail;            /**< next frame to pop, written by the application only */
+    volatile uint32_t dropped;         /**< dropped frame counter */
+} nrf24l01_rx_queue_t;
+
+/**
+ * @brief nrf24l01 reassembly structure definition
+ */
+typedef struct nrf24l01_reassembly_s
+{
+    uint8_t *buf;                                                                   /**< caller allocated message buffer */
+    uint16_t size;                                                                  /**< message buffer size */
+    uint16_t len;                                                                   /**< received message length */
+    uint16_t next;                                                                  /**< next fragment index */
+    uint8_t id;                                                                     /**< message id */
+    uint8_t active;                                                                 /**< active flag */
+    void (*callback)(uint8_t pipe, uint8_t *buf, uint16_t len, void *param);        /**< message callback */
+    void *param;                                                                    /**< message callback parameter */
+    uint32_t duplicate;                                                             /**< duplicate fragment counter */
+    uint32_t out_of_order;                                                          /**< out of order fragment counter */
+    uint32_t overflow;                                                              /**< message overflow counter */
+} nrf24l01_reassembly_t;
+
+/**
+ * @brief nrf24l01 ack payload structure definition
+ */
+typedef struct nrf24l01_ack_s
+{
+    nrf24l01_tx_ring_t queue[6];                                                        /**< pipe 0 - 5 downlink queue */
+    uint8_t enable;                                                                     /**< enabled queue mask */
+    uint8_t pipe;                                                                       /**< next pipe to load */
+    void (*callback)(uint32_t sequence, uint8_t *buf, uint8_t len, void *param);        /**< uplink ack payload callback */
+    void *param;                                                                        /**< uplink ack payload callback parameter */
+} nrf24l01_ack_t;
+
+/**
+ * @brief nrf24l01 pipe handler structure definition
+ */
+typedef struct nrf24l01_pipe_handler_s
+{
+    void (*callback)(uint8_t pipe, uint8_t *buf, uint8_t len, void *param);        /**< pipe receive handler */
+    void *param;                                                                   /**< pipe receive handler parameter */
+} nrf24l01_pipe_handler_t;
+
+/**
+ * @brief nrf24l01 dispatch structure definition
+ */
+typedef struct nrf24l01_dispatch_s
+{
+    nrf24l01_pipe_handler_t pipe[6];          /**< pipe 0 - 5 receive handler */
+    uint8_t discard;                          /**< discard the payloads of the pipes without consumer */
+    void (*tx_ds)(void *param);               /**< tx data sent hook */
+    void (*max_rt)(void *param);              /**< max retransmit hook */
+    void *param;                              /**< tx hook parameter */
+} nrf24l01_dispatch_t;
+
+/**
+ * @brief nrf24l01 retransmit tuner structure definition
+ */
+typedef struct nrf24l01_retransmit_tuner_s
+{
+    uint8_t delay_min;             /**< min auto retransmit delay register value */
+    uint8_t delay_max;             /**< max auto retransmit delay register value */
+    uint8_t count_min;             /**< min auto retransmit count */
+    uint8_t count_max;             /**< max auto retransmit count */
+    uint8_t delay;                 /**< current auto retransmit delay register value */
+    uint8_t count;                 /**< current auto retransmit count */
+    uint8_t streak;                /**< first attempt delivery streak */
+    uint16_t average;              /**< average retransmits in 1/16 */
+    uint32_t sent;                 /**< sampled send counter */
+    uint32_t lost;                 /**< lost send counter */
+} nrf24l01_retransmit_tuner_t;
+
+/**
+ * @brief nrf24l01 tx statistics structure definition
+ */
+typedef struct nrf24l01_tx_stats_s
+{
+    uint32_t sent;                  /**< tx payloads loaded */
+    uint32_t tx_ds;                 /**< tx data sent interrupts */
+    uint32_t max_rt;                /**< max retransmit interrupts */
+    uint32_t retransmit[16];        /**< retransmit histogram of the delivered payloads */
+} nrf24l01_tx_stats_t;
+
+/**
+ * @brief nrf24l01 statistics structure definition
+ */
+typedef struct nrf24l01_stats_s
+{
+    nrf24l01_tx_stats_t tx;         /**< tx counters of all addresses */
+    uint32_t rx[6];                 /**< pipe 0 - 5 received payloads */
+    uint32_t rx_fifo_full;          /**< rx fifo full events */
+    uint32_t oversize;              /**< oversize width flushes */
+    uint32_t discarded;             /**< payloads discarded without consumer */
+    uint32_t spi_error;             /**< failed spi transfers */
+} nrf24l01_stats_t;
+
+/**
+ * @brief nrf24l01 hopping structure definition
+ */
+typedef struct nrf24l01_hopping_s
+{
+    const uint8_t *channel;        /**< caller allocated channel sequence */
+    uint8_t num;                   /**< sequence length */
+    uint32_t slot_us;              /**< slot length in us */
+    uint32_t start;                /**< start timestamp of the current slot */
+    uint32_t slot;                 /**< current slot */
+    uint32_t missed;               /**< missed slots */
+} nrf24l01_hopping_t;
+
+/**
+ * @brief nrf24l01 scan structure definition
+ */
+typedef struct nrf24l01_scan_s
+{
+    uint8_t first;                 /**< first scanned channel */
+    uint8_t last;                  /**< last scanned channel */
+    uint8_t samples;               /**< rpd samples per channel and sweep */
+    uint8_t channel;               /**< next scanned channel */
+    uint32_t dwell_us;             /**< rx time before every rpd sample */
+    uint32_t sweeps;               /**< finished sweeps */
+    uint32_t count[128];           /**< channel 0 - 127 busy samples */
+} nrf24l01_scan_t;
+
+/**
+ * @brief nrf24l01 hub definition
+ */
+#define NRF24L01_HUB_NONE        0xFFFF        /**< pipe without a node */
+
+/**
+ * @brief nrf24l01 hub node structure definition
+ */
+typedef struct nrf24l01_hub_node_s
+{
+    uint8_t addr;                  /**< address byte, the other bytes come from the pipe 1 address */
+    uint8_t pipe;                  /**< pipe 1 - 5 of the node, 0 means waiting */
+    uint8_t pinned;                /**< 0 rotating, 1 pinned by the caller, 2 pinned as a hot talker */
+    uint16_t slice;                /**< received payloads in the current slice */
+    uint32_t received;             /**< received payloads */
+} nrf24l01_hub_node_t;
+
+/**
+ * @brief nrf24l01 hub structure definition
+ */
+typedef struct nrf24l01_hub_s
+{
+    nrf24l01_hub_node_t *node;     /**< caller allocated node table */
+    uint16_t num;                  /**< node number */
+    uint16_t next;                 /**< next rotating node */
+    uint16_t pipe_node[6];         /**< node of pipe 1 - 5 */
+    uint16_t hot;                  /**< slice payloads that pin a node, 0 disables */
+    uint8_t base[5];               /**< pipe 1 address, lsb first */
+    uint8_t width;                 /**< address width */
+    uint8_t enable;                /**< enable flag */
+    uint32_t slice_us;             /**< slice length in us */
+    uint32_t start;                /**< start timestamp of the current slice */
+    uint32_t rotations;            /**< finished rotations */
+    uint32_t deferred;             /**< rotations deferred by unread payloads */
+} nrf24l01_hub_t;
+
+/**
+ * @brief nrf24l01 mesh definition
+ */
+#define NRF24L01_MESH_NONE        0xFFFF        /**< no node, the parent of the root */
+#define NRF24L01_MESH_HEADER      7             /**< to, from, via and ttl bytes */
+#define NRF24L01_MESH_PAYLOAD     25            /**< message bytes in one mesh frame */
+
+/**
+ * @brief nrf24l01 mesh frame structure definition
+ */
+typedef struct nrf24l01_mesh_frame_s
+{
+    uint16_t next;                 /**< next hop address */
+    uint8_t len;                   /**< frame length */
+    uint8_t buf[32];               /**< header and message */
+} nrf24l01_mesh_frame_t;
+
+/**
+ * @brief nrf24l01 mesh route structure definition
+ */
+typedef struct nrf24l01_mesh_route_s
+{
+    uint16_t dst;                  /**< destination address */
+    uint16_t next;                 /**< next hop address, NRF24L01_MESH_NONE means free */
+} nrf24l01_mesh_route_t;
+
+/**
+ * @brief nrf24l01 mesh structure definition
+ */
+typedef struct nrf24l01_mesh_s
+{
+    nrf24l01_mesh_frame_t *frame;                                                   /**< caller allocated forward queue */
+    uint16_t depth;                                                                 /**< forward queue depth */
+    volatile uint16_t head;                                                         /**< next frame to push, written by the irq handler only */
+    volatile uint16_t tail;                                                         /**< next frame to send, written by the update only */
+    nrf24l01_mesh_route_t *route;                                                   /**< caller allocated route cache */
+    uint16_t route_num;                                                             /**< route cache size */
+    uint16_t route_next;                                                            /**< next replaced route */
+    uint16_t address;                                                               /**< node address */
+    uint16_t parent;                                                                /**< parent address */
+    uint8_t base[5];                                                                /**< network address, lsb first */
+    uint8_t width;                                                                  /**< address width */
+    uint8_t enable;                                                                 /**< enable flag */
+    void (*callback)(uint16_t from, uint8_t *buf, uint8_t len, void *param);        /**< message callback */
+    void *param;                                                                    /**< message callback parameter */
+    uint32_t delivered;                                                             /**< delivered messages */
+    uint32_t forwarded;                                                             /**< forwarded frames */
+    uint32_t dropped;                                                               /**< dropped frames */
+    uint32_t failed;                                                                /**< failed sends */
+} nrf24l01_mesh_t;
+
+/**
+ * @brief nrf24l01 sync beacon length definition
+ */
+#define NRF24L01_SYNC_BEACON_LENGTH        6        /**< sequence, valid flag and the last tx_ds time */
+
+/**
+ * @brief nrf24l01 sync structure definition
+ */
+typedef struct nrf24l01_sync_s
+{
+    uint8_t role;                  /**< sync role */
+    uint8_t pipe;                  /**< beacon pipe of the slave */
+    uint8_t sequence;              /**< last beacon sequence */
+    uint8_t pending;               /**< master beacon in flight */
+    uint8_t stamped;               /**< stamp belongs to the last beacon */
+    volatile uint8_t edge_valid;   /**< irq edge timestamp flag */
+    volatile uint32_t edge;        /**< irq edge timestamp */
+    uint32_t stamp;                /**< tx_ds or rx_dr timestamp of the last beacon */
+    uint32_t offset;               /**< master time minus local time at the reference */
+    uint32_t reference;            /**< local time of the last offset sample */
+    int32_t drift;                 /**< drift in ppb */
+    int32_t error;                 /**< last prediction error in us */
+    uint32_t samples;              /**< offset samples */
+} nrf24l01_sync_t;
+
+/**
+ * @brief nrf24l01 tdma structure definition
+ */
+typedef struct nrf24l01_tdma_s
+{
+    const uint16_t *table;         /**< caller allocated slot owner table */
+    uint8_t num;                   /**< slot number */
+    uint16_t node;                 /**< own node */
+    uint32_t slot_us;              /**< slot length in us */
+    uint32_t frame_us;             /**< worst case time of one full frame */
+    uint32_t margin_us;            /**< time sync margin in us */
+    uint32_t slot;                 /**< last used slot */
+    uint32_t slots;                /**< used slots */
+    uint32_t held;                 /**< frames held for the next slot */
+    uint16_t mark;                 /**< tx ring index after the last counted held frame */
+} nrf24l01_tdma_t;
+
+/**
+ * @brief nrf24l01 power structure definition
+ */
+typedef struct nrf24l01_power_s
+{
+    uint8_t enable;                /**< state tracking flag */
+    uint8_t state;                 /**< current power state */
+    uint32_t since;                /**< timestamp of the last transition */
+    uint64_t residency[5];         /**< time in each power state in us */
+    uint32_t transitions;          /**< state transitions */
+} nrf24l01_power_t;
+
+/**
+ * @brief nrf24l01 snapshot length definition
+ */
+#define NRF24L01_SNAPSHOT_LENGTH        37        /**< magic, 19 registers, 3 addresses and crc16 */
+
+/**
+ * @brief nrf24l01 fragment definition
+ */
+#define NRF24L01_FRAGMENT_PAYLOAD       30           /**< message bytes in one fragment */
+#define NRF24L01_FRAGMENT_MAX_LENGTH    61440        /**< max message length, 2048 fragments */
+
+/**
+ * @brief nrf24l01 profile structure definition
+ */
+typedef struct nrf24l01_profile_s
+{
+    nrf24l01_mode_t mode;                               /**< chip mode */
+    nrf24l01_bool_t power_up;                           /**< power up */
+    nrf24l01_bool_t crc;                                /**< enable crc */
+    nrf24l01_bool_t crco;                               /**< enable 2 bytes crc */
+    nrf24l01_bool_t mask_rx_dr;                         /**< mask the rx_dr interrupt */
+    nrf24l01_bool_t mask_tx_ds;                         /**< mask the tx_ds interrupt */
+    nrf24l01_bool_t mask_max_rt;                        /**< mask the max_rt interrupt */
+    nrf24l01_bool_t auto_acknowledgment[6];             /**< pipe 0 - 5 auto acknowledgment */
+    nrf24l01_bool_t rx_pipe[6];                         /**< enable rx pipe 0 - 5 */
+    nrf24l01_address_width_t address_width;             /**< address width */
+    uint8_t retransmit_delay;                           /**< auto retransmit delay register value */
+    uint8_t retransmit_count;                           /**< auto retransmit count */
+    uint8_t channel_frequency;                          /**< channel frequency */
+    nrf24l01_data_rate_t data_rate;                     /**< data rate */
+    nrf24l01_output_power_t output_power;               /**< output power */
+    nrf24l01_bool_t continuous_carrier_transmit;        /**< continuous carrier transmit */
+    nrf24l01_bool_t force_pll_lock_signal;              /**< force pll lock signal */
+    uint8_t payload_number[6];                          /**< pipe 0 - 5 payload number */
+    nrf24l01_bool_t pipe_dynamic_payload[6];            /**< pipe 0 - 5 dynamic payload */
+    nrf24l01_bool_t dynamic_payload;                    /**< enable dynamic payload */
+    nrf24l01_bool_t payload_with_ack;                   /**< enable payload with ack */
+    nrf24l01_bool_t tx_payload_with_no_ack;             /**< enable tx payload with no ack */
+    uint8_t rx_pipe_0_address[5];                       /**< rx pipe 0 address */
+    uint8_t rx_pipe_1_address[5];                       /**< rx pipe 1 address */
+    uint8_t rx_pipe_address[4];                         /**< rx pipe 2 - 5 address byte */
+    uint8_t tx_address[5];                              /**< tx address */
+} nrf24l01_profile_t;
+
 /**
  * @brief nrf24l01 handle structure definition
  */
 typedef struct nrf24l01_handle_s
 {
-    uint8_t (*gpio_init)(void);                                                            /**< point to a gpio_init function address */
-    uint8_t (*gpio_deinit)(void);                                                          /**< point to a gpio_deinit function address */
-    uint8_t (*gpio_write)(uint8_t value);                                                  /**< point to a gpio_write function address */
-    uint8_t (*spi_init)(void);                                                             /**< point to a spi_init function address */
-    uint8_t (*spi_deinit)(void);                                                           /**< point to a spi_deinit function address */
-    uint8_t (*spi_read)(uint8_t reg, uint8_t *buf, uint16_t len);                          /**< point to a spi_read function address */
-    uint8_t (*spi_write)(uint8_t reg, uint8_t *buf, uint16_t len);                         /**< point to a spi_write function address */
-    void (*delay_ms)(uint32_t ms);                                                         /**< point to a delay_ms function address */
-    void (*debug_print)(const char *const fmt, ...);                                       /**< point to a debug_print function address */
-    void (*receive_callback)(uint8_t type, uint8_t num, uint8_t *buf, uint8_t len);        /**< point to a receive_callback function address */
-    uint8_t inited;                                                                        /**< inited flag */
-    uint8_t finished;                                                                      /**< finished flag */
+    uint8_t (*gpio_init)(void *user_data);                                                                 /**< point to a gpio_init function address */
+    uint8_t (*gpio_deinit)(void *user_data);                                                               /**< point to a gpio_deinit function address */
+    uint8_t (*gpio_write)(void *user_data, uint8_t value);                                                 /**< point to a gpio_write function address */
+    uint8_t (*spi_init)(void *user_data);                                                                  /**< point to a spi_init function address */
+    uint8_t (*spi_deinit)(void *user_data);                                                                /**< point to a spi_deinit function address */
+    uint8_t (*spi_read)(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len);                         /**< point to a spi_read function address */
+    uint8_t (*spi_write)(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len);                        /**< point to a spi_write function address */
+    uint8_t (*spi_transfer)(void *user_data, uint8_t *tx, uint8_t *rx, uint16_t len);                      /**< point to a spi_transfer function address */
+    void (*delay_ms)(uint32_t ms);                                                                         /**< point to a delay_ms function address */
+    void (*delay_us)(uint32_t us);                                                                         /**< point to a delay_us function address */
+    uint32_t (*timestamp_us)(void);                                                                        /**< point to a timestamp_us function address */
+    void (*debug_print)(const char *const fmt, ...);                                                       /**< point to a debug_print function address */
+    void (*receive_callback)(void *user_data, uint8_t type, uint8_t num, uint8_t *buf, uint8_t len);       /**< point to a receive_callback function address */
+    void *user_data;                                                                                       /**< user data passed to the interface hooks */
+    void (*send_callback)(nrf24l01_send_status_t status, void *param);                                     /**< point to a send_callback function address */
+    void *send_param;                                                                                      /**< send callback parameter */
+    uint8_t inited;                                                                                        /**< inited flag */
+    uint8_t finished;                                                                                      /**< finished flag */
+    uint8_t status;                                                                                        /**< last status */
+    uint8_t sending;                                                                                       /**< sending flag */
+    uint8_t rx_drain;                                                                                      /**< rx drain flag */
+    uint8_t wire_order;                                                                                    /**< wire order flag */
+    uint8_t deadline_len;                                                                                  /**< cached send deadline length plus one, 0 is none */
+    uint32_t deadline_us;                                                                                  /**< cached send deadline in us */
+    volatile uint32_t stats_sequence;                                                                      /**< statistics sequence, odd while updating */
+    nrf24l01_shadow_t *shadow;                                                                             /**< register shadow */
+    nrf24l01_stream_t *stream;                                                                             /**< tx stream */
+    nrf24l01_tx_ring_t *tx_ring;                                                                           /**< tx ring */
+    nrf24l01_rx_queue_t *rx_queue;                                                                         /**< rx queue */
+    nrf24l01_reassembly_t *reassembly[6];                                                                  /**< pipe 0 - 5 reassembly context */
+    uint8_t fragment_id;                                                                                   /**< next fragment message id */
+    nrf24l01_ack_t *ack;                                                                                   /**< ack payload channel */
+    volatile uint32_t tx_sequence;                                                                         /**< acknowledged send counter */
+    nrf24l01_dispatch_t *dispatch;                                                                         /**< receive dispatch table and tx hooks */
+    nrf24l01_retransmit_tuner_t *tuner;                                                                    /**< active retransmit tuner */
+    nrf24l01_stats_t *stats;                                                                               /**< statistics */
+    nrf24l01_tx_stats_t *tx_stats;                                                                         /**< active per tx address statistics */
+    uint8_t stats_detail;                                                                                  /**< detailed statistics flag */
+    nrf24l01_hopping_t *hopping;                                                                           /**< channel hopping */
+    nrf24l01_hub_t *hub;                                                                                   /**< star network hub */
+    nrf24l01_mesh_t *mesh;                                                                                 /**< tree network layer */
+    nrf24l01_sync_t *sync;                                                                                 /**< time sync */
+    nrf24l01_tdma_t *tdma;                                                                                 /**< tdma slots */
+    nrf24l01_power_t *power;                                                                               /**< power state */
 } nrf24l01_handle_t;
 
 /**
@@ -231,139 +676,1247 @@ typedef struct nrf24l01_info_s
  * @param[in] FUC pointer to a spi_read function address
  * @note      none
  */
-#define DRIVER_NRF24L01_LINK_SPI_READ(HANDLE, FUC)          (HANDLE)->spi_read = FUC
+#define DRIVER_NRF24L01_LINK_SPI_READ(HANDLE, FUC)          (HANDLE)->spi_read = FUC
+
+/**
+ * @brief     link gpio_write function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a gpio_write function address
+ * @note      none
+ */
+#define DRIVER_NRF24L01_LINK_SPI_WRITE(HANDLE, FUC)         (HANDLE)->spi_write = FUC
+
+/**
+ * @brief     link spi_transfer function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a spi_transfer function address
+ * @note      optional, the status byte of every command is captured when linked
+ */
+#define DRIVER_NRF24L01_LINK_SPI_TRANSFER(HANDLE, FUC)      (HANDLE)->spi_transfer = FUC
+
+/**
+ * @brief     link gpio_init function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a gpio_init function address
+ * @note      none
+ */
+#define DRIVER_NRF24L01_LINK_GPIO_INIT(HANDLE, FUC)         (HANDLE)->gpio_init = FUC
+
+/**
+ * @brief     link gpio_deinit function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a gpio_deinit function address
+ * @note      none
+ */
+#define DRIVER_NRF24L01_LINK_GPIO_DEINIT(HANDLE, FUC)       (HANDLE)->gpio_deinit = FUC
+
+/**
+ * @brief     link gpio_write function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a gpio_write function address
+ * @note      none
+ */
+#define DRIVER_NRF24L01_LINK_GPIO_WRITE(HANDLE, FUC)        (HANDLE)->gpio_write = FUC
+
+/**
+ * @brief     link delay_ms function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a delay_ms function address
+ * @note      none
+ */
+#define DRIVER_NRF24L01_LINK_DELAY_MS(HANDLE, FUC)          (HANDLE)->delay_ms = FUC
+
+/**
+ * @brief     link delay_us function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a delay_us function address
+ * @note      optional, enables the settling delays and the sub millisecond completion polling
+ */
+#define DRIVER_NRF24L01_LINK_DELAY_US(HANDLE, FUC)          (HANDLE)->delay_us = FUC
+
+/**
+ * @brief     link timestamp_us function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a timestamp_us function address
+ * @note      optional, a free running microsecond counter, received frames are stamped 0 when not linked
+ *            and the timeouts are counted from the delays
+ */
+#define DRIVER_NRF24L01_LINK_TIMESTAMP_US(HANDLE, FUC)      (HANDLE)->timestamp_us = FUC
+
+/**
+ * @brief     link debug_print function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a debug_print function address
+ * @note      none
+ */
+#define DRIVER_NRF24L01_LINK_DEBUG_PRINT(HANDLE, FUC)       (HANDLE)->debug_print = FUC
+
+/**
+ * @brief     link receive_callback function
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] FUC pointer to a receive_callback function address
+ * @note      none
+ */
+#define DRIVER_NRF24L01_LINK_RECEIVE_CALLBACK(HANDLE, FUC)  (HANDLE)->receive_callback = FUC
+
+/**
+ * @brief     link the user data
+ * @param[in] HANDLE pointer to an nrf24l01 handle structure
+ * @param[in] DATA pointer to the user data
+ * @note      optional, passed to the gpio, spi and receive callback functions so one interface
+ *            can drive several chips, NULL selects the default chip of the interface
+ */
+#define DRIVER_NRF24L01_LINK_USER_DATA(HANDLE, DATA)        (HANDLE)->user_data = DATA
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup nrf24l01_basic_driver nrf24l01 basic driver function
+ * @brief    nrf24l01 basic driver modules
+ * @ingroup  nrf24l01_driver
+ * @{
+ */
+
+/**
+ * @brief      get chip's information
+ * @param[out] *info pointer to an nrf24l01 info structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       none
+ */
+uint8_t nrf24l01_info(nrf24l01_info_t *info);
+
+/**
+ * @brief     irq handler
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t nrf24l01_irq_handler(nrf24l01_handle_t *handle);
+
+/**
+ * @brief     initialize the chip
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi initialization failed
+ *            - 2 handle is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 gpio init failed
+ * @note      none
+ */
+uint8_t nrf24l01_init(nrf24l01_handle_t *handle);
+
+/**
+ * @brief     close the chip
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 nop failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 gpio deinit failed
+ *            - 5 spi deinit failed
+ * @note      none
+ */
+uint8_t nrf24l01_deinit(nrf24l01_handle_t *handle);
+
+/**
+ * @brief     send data
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is over 32
+ *            - 5 send deadline missed
+ * @note      polls every 20 us when delay_us is linked and every 1 ms otherwise, the deadline is
+ *            the worst case completion time of the current link settings plus a 1 ms margin, when
+ *            it passes the send is finished from a lost TX_DS or MAX_RT in the status register,
+ *            clearing only those flags, otherwise the tx fifo is flushed and the send status is
+ *            set to NRF24L01_SEND_STATUS_DEADLINE
+ */
+uint8_t nrf24l01_send(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len);
+
+/**
+ * @brief     send data without waiting
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len buffer length
+ * @param[in] *callback pointer to a completion callback, it can be NULL
+ * @param[in] *param pointer to the callback parameter
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is over 32
+ *            - 5 send is busy
+ * @note      the completion is reported by the irq handler through the callback
+ *            and can be polled with nrf24l01_get_send_status
+ */
+uint8_t nrf24l01_send_async(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len,
+                            void (*callback)(nrf24l01_send_status_t status, void *param), void *param);
+
+/**
+ * @brief      get the status of the last send
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *status pointer to a send status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_send_status(nrf24l01_handle_t *handle, nrf24l01_send_status_t *status);
+
+/**
+ * @brief      calculate the air time of a frame
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  rate data rate
+ * @param[in]  width address width
+ * @param[in]  crc crc length in bytes
+ * @param[in]  len payload length
+ * @param[out] *us pointer to an air time buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 param is invalid
+ * @note       the air time covers the preamble, the address, the packet control field, the payload
+ *             and the crc, crc <= 2 and len <= 32
+ */
+uint8_t nrf24l01_calculate_air_time(nrf24l01_handle_t *handle, nrf24l01_data_rate_t rate,
+                                    nrf24l01_address_width_t width, uint8_t crc, uint8_t len, uint32_t *us);
+
+/**
+ * @brief      get the worst case completion time of a send
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  len payload length
+ * @param[out] *us pointer to a completion time buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get send deadline failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 len is over 32
+ * @note       every attempt is counted as the 130 us settling time, the frame air time and the full
+ *             auto retransmit delay, the attempts are the auto retransmit count plus one, the
+ *             result of the last length is cached until CONFIG, EN_AA, SETUP_AW, SETUP_RETR or
+ *             RF_SETUP is written
+ */
+uint8_t nrf24l01_get_send_deadline(nrf24l01_handle_t *handle, uint8_t len, uint32_t *us);
+
+/**
+ * @brief      initialize a retransmit tuner
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *tuner pointer to a caller allocated tuner, one per destination address
+ * @param[in]  delay_min min auto retransmit delay register value
+ * @param[in]  delay_max max auto retransmit delay register value
+ * @param[in]  count_min min auto retransmit count
+ * @param[in]  count_max max auto retransmit count
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 bounds are invalid
+ * @note       the bounds are register values <= 0xF, the tuner starts from the max delay and count
+ */
+uint8_t nrf24l01_retransmit_tuner_init(nrf24l01_handle_t *handle, nrf24l01_retransmit_tuner_t *tuner,
+                                       uint8_t delay_min, uint8_t delay_max, uint8_t count_min, uint8_t count_max);
+
+/**
+ * @brief     set the active retransmit tuner
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *tuner pointer to an initialized tuner, NULL stops the tuning
+ * @return    status code
+ *            - 0 success
+ *            - 1 set retransmit tuner failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it with the tuner of the destination whenever the tx address changes, the tuner
+ *            delay and count are written to the chip, the irq handler samples the observe tx
+ *            register after every tx data sent or max retransmit interrupt, widens the delay and
+ *            count after a loss or a send that needed every retransmit, widens the delay when the
+ *            average retransmits stay high and narrows the delay and then the count after a run of
+ *            first attempt deliveries
+ */
+uint8_t nrf24l01_set_retransmit_tuner(nrf24l01_handle_t *handle, nrf24l01_retransmit_tuner_t *tuner);
+
+/**
+ * @brief      get the retransmit tuner status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  *tuner pointer to an initialized tuner
+ * @param[out] *delay pointer to a current delay register value buffer
+ * @param[out] *count pointer to a current count buffer
+ * @param[out] *sent pointer to a sampled send counter buffer
+ * @param[out] *lost pointer to a lost send counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_retransmit_tuner_status(nrf24l01_handle_t *handle, nrf24l01_retransmit_tuner_t *tuner,
+                                             uint8_t *delay, uint8_t *count, uint32_t *sent, uint32_t *lost);
+
+/**
+ * @brief      get the statistics
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *stats pointer to a statistics buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 statistics are busy
+ *             - 5 statistics are not set
+ * @note       the copy is repeated while the statistics sequence is odd or changes during the
+ *             copy so it is consistent even when the irq handler updates the counters meanwhile
+ */
+uint8_t nrf24l01_get_stats(nrf24l01_handle_t *handle, nrf24l01_stats_t *stats);
+
+/**
+ * @brief     clear the statistics
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 statistics are not set
+ * @note      the per tx address statistics are owned by the caller and are not cleared
+ */
+uint8_t nrf24l01_clear_stats(nrf24l01_handle_t *handle);
+
+/**
+ * @brief     set the statistics
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *stats pointer to a caller allocated statistics block, NULL stops the counting
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the block is cleared before the counting starts
+ */
+uint8_t nrf24l01_set_stats(nrf24l01_handle_t *handle, nrf24l01_stats_t *stats);
+
+/**
+ * @brief     set the per tx address statistics
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *stats pointer to a caller allocated tx statistics block, NULL stops the counting
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it with the block of the destination whenever the tx address changes, the tx
+ *            counters are updated in the block and in the statistics block
+ */
+uint8_t nrf24l01_set_tx_stats(nrf24l01_handle_t *handle, nrf24l01_tx_stats_t *stats);
+
+/**
+ * @brief     enable or disable the detailed statistics
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the detailed statistics cost one observe tx read per tx interrupt for the retransmit
+ *            histogram and one fifo status read per rx interrupt for the rx fifo full events, the
+ *            histogram is also filled while a retransmit tuner is active
+ */
+uint8_t nrf24l01_set_stats_detail(nrf24l01_handle_t *handle, nrf24l01_bool_t enable);
+
+/**
+ * @brief      get the detailed statistics status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_stats_detail(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable);
+
+/**
+ * @brief     set the tx stream
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *stream pointer to a caller allocated tx stream, NULL disables the stream
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 send is busy
+ * @note      the stream carries nrf24l01_send_stream and nrf24l01_send_message
+ */
+uint8_t nrf24l01_set_stream(nrf24l01_handle_t *handle, nrf24l01_stream_t *stream);
+
+/**
+ * @brief      send a stream of payloads without waiting
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  *buf pointer to num payloads of len bytes
+ * @param[in]  len payload length
+ * @param[in]  num payload number
+ * @param[out] *result pointer to a per payload result buffer of num entries
+ * @param[in]  *callback pointer to a completion callback, it can be NULL
+ * @param[in]  *param pointer to the callback parameter
+ * @return     status code
+ *             - 0 success
+ *             - 1 send stream failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 len is invalid
+ *             - 5 send is busy
+ *             - 6 num is 0
+ *             - 7 stream is not set
+ * @note       buf and result must stay valid until the callback runs, ce stays high and the
+ *             irq handler keeps 2 payloads in flight, the callback gets
+ *             NRF24L01_SEND_STATUS_MAX_RT if any payload failed
+ */
+uint8_t nrf24l01_send_stream(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len, uint16_t num,
+                             nrf24l01_send_status_t *result,
+                             void (*callback)(nrf24l01_send_status_t status, void *param), void *param);
+
+/**
+ * @brief     set the tx ring
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *ring pointer to a caller allocated tx ring, NULL disables the ring
+ * @param[in] *frame pointer to a caller allocated frame buffer, NULL disables the ring
+ * @param[in] depth frame buffer depth
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 depth is invalid
+ *            - 5 send is busy
+ * @note      the ring holds depth - 1 frames
+ */
+uint8_t nrf24l01_set_tx_ring(nrf24l01_handle_t *handle, nrf24l01_tx_ring_t *ring, nrf24l01_tx_frame_t *frame, uint16_t depth);
+
+/**
+ * @brief     write a frame to the tx ring
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is invalid
+ *            - 5 tx ring is not set
+ *            - 6 tx ring is full
+ * @note      when the radio is idle the tx fifo is loaded at once, otherwise the irq
+ *            handler loads the frame after the next TX_DS or MAX_RT, a load failure keeps the
+ *            frame queued and releases the radio for the next write
+ */
+uint8_t nrf24l01_tx_ring_write(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len);
+
+/**
+ * @brief      get the tx ring status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *pending pointer to a pending frame number buffer
+ * @param[out] *sent pointer to a sent frame counter buffer
+ * @param[out] *failed pointer to a failed frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 tx ring is not set
+ * @note       none
+ */
+uint8_t nrf24l01_get_tx_ring_status(nrf24l01_handle_t *handle, uint16_t *pending, uint32_t *sent, uint32_t *failed);
+
+/**
+ * @brief     set the rx queue
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *queue pointer to a caller allocated rx queue, NULL disables the queue
+ * @param[in] *frame pointer to a caller allocated frame buffer, NULL disables the queue
+ * @param[in] depth frame buffer depth
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 depth is invalid
+ * @note      the queue holds depth - 1 frames, when it is set the irq handler pushes
+ *            the received frames into it instead of running the receive callback
+ */
+uint8_t nrf24l01_set_rx_queue(nrf24l01_handle_t *handle, nrf24l01_rx_queue_t *queue, nrf24l01_rx_frame_t *frame, uint16_t depth);
+
+/**
+ * @brief      pop the received frames without waiting
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *frame pointer to a frame buffer
+ * @param[in]  max max frame number
+ * @param[out] *num pointer to a popped frame number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 rx queue is not set
+ * @note       only one consumer thread may pop, it runs lock free against the irq handler
+ */
+uint8_t nrf24l01_try_receive(nrf24l01_handle_t *handle, nrf24l01_rx_frame_t *frame, uint16_t max, uint16_t *num);
+
+/**
+ * @brief      pop the received frames
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *frame pointer to a frame buffer
+ * @param[in]  max max frame number
+ * @param[out] *num pointer to a popped frame number buffer
+ * @param[in]  timeout_ms timeout in ms
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 rx queue is not set
+ *             - 5 receive timeout
+ * @note       waits until at least one frame is queued
+ */
+uint8_t nrf24l01_receive(nrf24l01_handle_t *handle, nrf24l01_rx_frame_t *frame, uint16_t max, uint16_t *num, uint32_t timeout_ms);
+
+/**
+ * @brief      get the rx queue status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *count pointer to a queued frame number buffer
+ * @param[out] *dropped pointer to a dropped frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 rx queue is not set
+ * @note       frames are dropped when the queue is full
+ */
+uint8_t nrf24l01_get_rx_queue_status(nrf24l01_handle_t *handle, uint16_t *count, uint32_t *dropped);
+
+/**
+ * @brief     send a message larger than one payload
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a message buffer
+ * @param[in] len message length
+ * @param[in] *callback pointer to a completion callback, it can be NULL
+ * @param[in] *param pointer to the callback parameter
+ * @return    status code
+ *            - 0 success
+ *            - 1 send message failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is invalid
+ *            - 5 send is busy
+ *            - 6 stream is not set
+ * @note      the message is cut into fragments of a 2 bytes header and up to 30 bytes, which are
+ *            pipelined through the tx fifo by the irq handler like a stream, buf must stay valid
+ *            until the callback runs, a fragment reaching max rt aborts the message, the receiver
+ *            needs dynamic payload length
+ */
+uint8_t nrf24l01_send_message(nrf24l01_handle_t *handle, uint8_t *buf, uint16_t len,
+                              void (*callback)(nrf24l01_send_status_t status, void *param), void *param);
+
+/**
+ * @brief     set the reassembly context of a pipe
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe rx pipe
+ * @param[in] *ctx pointer to a caller allocated context, NULL disables the reassembly
+ * @param[in] *buf pointer to a message buffer
+ * @param[in] size message buffer size
+ * @param[in] *callback pointer to a message callback
+ * @param[in] *param pointer to the callback parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 pipe is invalid
+ *            - 5 size is invalid
+ * @note      the payloads of the pipe are reassembled in the irq handler and bypass the rx queue
+ *            and the receive callback, the callback runs from the irq handler with the whole message
+ */
+uint8_t nrf24l01_set_reassembly(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, nrf24l01_reassembly_t *ctx,
+                                uint8_t *buf, uint16_t size,
+                                void (*callback)(uint8_t pipe, uint8_t *buf, uint16_t len, void *param), void *param);
+
+/**
+ * @brief      get the reassembly status of a pipe
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  pipe rx pipe
+ * @param[out] *duplicate pointer to a duplicate fragment counter buffer
+ * @param[out] *out_of_order pointer to an out of order fragment counter buffer
+ * @param[out] *overflow pointer to a message overflow counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 pipe is invalid
+ *             - 5 reassembly is not set
+ * @note       an out of order fragment drops the partial message
+ */
+uint8_t nrf24l01_get_reassembly_status(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, uint32_t *duplicate,
+                                       uint32_t *out_of_order, uint32_t *overflow);
+
+/**
+ * @brief     set the ack payload channel
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *ack pointer to a caller allocated ack payload channel, NULL disables the channel
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the channel is cleared, then the queues and the handler are set on it with
+ *            nrf24l01_set_ack_queue and nrf24l01_set_ack_handler
+ */
+uint8_t nrf24l01_set_ack_channel(nrf24l01_handle_t *handle, nrf24l01_ack_t *ack);
+
+/**
+ * @brief     set the ack payload queue of a pipe
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe rx pipe
+ * @param[in] *frame pointer to a caller allocated frame buffer, NULL disables the queue
+ * @param[in] depth frame buffer depth
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 pipe is invalid
+ *            - 5 depth is invalid
+ *            - 6 ack channel is not set
+ * @note      prx only, payload with ack and dynamic payload must be enabled, the queue holds depth - 1
+ *            frames and the irq handler keeps the 3 tx fifo slots loaded from all queues in turn, a
+ *            frame received on the pipe retires the head payload only when auto acknowledgment is
+ *            enabled on the pipe, a frame sent with NO_ACK looks the same on the prx side, so the
+ *            ptx must not send NO_ACK frames to a pipe with an ack queue
+ */
+uint8_t nrf24l01_set_ack_queue(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, nrf24l01_tx_frame_t *frame, uint16_t depth);
+
+/**
+ * @brief     write an ack payload to the queue of a pipe
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe rx pipe
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is invalid
+ *            - 5 ack queue is not set
+ *            - 6 ack queue is full
+ * @note      a free tx fifo slot is loaded at once, a payload leaves the queue when the next
+ *            packet of the pipe is received, because the chip sends it with that ack
+ */
+uint8_t nrf24l01_ack_queue_write(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, uint8_t *buf, uint8_t len);
+
+/**
+ * @brief      get the ack payload queue status of a pipe
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  pipe rx pipe
+ * @param[out] *pending pointer to a pending frame number buffer
+ * @param[out] *sent pointer to a sent frame counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 pipe is invalid
+ *             - 5 ack queue is not set
+ * @note       pending counts the queued and the loaded frames
+ */
+uint8_t nrf24l01_get_ack_queue_status(nrf24l01_handle_t *handle, nrf24l01_pipe_t pipe, uint16_t *pending, uint32_t *sent);
+
+/**
+ * @brief     set the ack payload handler
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *callback pointer to an ack payload callback, NULL disables the handler
+ * @param[in] *param pointer to the callback parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 ack channel is not set
+ * @note      ptx only, the ack payloads bypass the rx queue and the receive callback and come with
+ *            the sequence of the send they answer, the sequence counts the acknowledged sends
+ *            from the first one which is 1, when several sends complete in one interrupt the ack
+ *            payloads are matched to them in order
+ */
+uint8_t nrf24l01_set_ack_handler(nrf24l01_handle_t *handle,
+                                 void (*callback)(uint32_t sequence, uint8_t *buf, uint8_t len, void *param), void *param);
+
+/**
+ * @brief      get the acknowledged send sequence
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *sequence pointer to a sequence buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the next acknowledged send gets sequence + 1
+ */
+uint8_t nrf24l01_get_tx_sequence(nrf24l01_handle_t *handle, uint32_t *sequence);
+
+/**
+ * @brief     set the dispatch table
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *dispatch pointer to a caller allocated dispatch table, NULL disables the dispatch
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the table is cleared, then the pipe handlers, the discard flag and the tx hooks are
+ *            set on it with their setters
+ */
+uint8_t nrf24l01_set_dispatch(nrf24l01_handle_t *handle, nrf24l01_dispatch_t *dispatch);
+
+/**
+ * @brief     set a pipe receive handler
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] pipe rx pipe number
+ * @param[in] *callback pointer to a pipe receive handler, NULL removes the handler
+ * @param[in] *param pointer to the handler parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 pipe is invalid
+ *            - 5 dispatch is not set
+ * @note      the payloads of the pipe go straight to the handler and bypass the rx queue and the
+ *            receive callback, a reassembly context on the same pipe takes precedence
+ */
+uint8_t nrf24l01_set_pipe_handler(nrf24l01_handle_t *handle, uint8_t pipe,
+                                  void (*callback)(uint8_t pipe, uint8_t *buf, uint8_t len, void *param), void *param);
+
+/**
+ * @brief     enable or disable discarding the payloads of the pipes without consumer
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 dispatch is not set
+ * @note      when enabled the payloads of the pipes without a handler or a reassembly context are
+ *            popped from the rx fifo and dropped without being copied to the rx queue or passed to
+ *            the receive callback
+ */
+uint8_t nrf24l01_set_dispatch_discard(nrf24l01_handle_t *handle, nrf24l01_bool_t enable);
+
+/**
+ * @brief      get the discard status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_dispatch_discard(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable);
+
+/**
+ * @brief     set the tx hooks
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *tx_ds pointer to a tx data sent hook, NULL disables the hook
+ * @param[in] *max_rt pointer to a max retransmit hook, NULL disables the hook
+ * @param[in] *param pointer to the hook parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 dispatch is not set
+ * @note      the hooks run from the irq handler on every tx data sent or max retransmit interrupt
+ *            next to the receive callback
+ */
+uint8_t nrf24l01_set_tx_hooks(nrf24l01_handle_t *handle, void (*tx_ds)(void *param),
+                              void (*max_rt)(void *param), void *param);
+
+/**
+ * @brief      make a hopping sequence
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  seed shared sequence seed
+ * @param[in]  first first usable channel
+ * @param[in]  last last usable channel
+ * @param[out] *channel pointer to a channel sequence buffer
+ * @param[in]  num sequence length
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 sequence is invalid
+ * @note       last <= 0x7F, num can't exceed the usable channels, every channel of the sequence is
+ *             different and the same seed gives the same sequence on every node
+ */
+uint8_t nrf24l01_hopping_sequence(nrf24l01_handle_t *handle, uint32_t seed, uint8_t first, uint8_t last,
+                                  uint8_t *channel, uint8_t num);
+
+/**
+ * @brief     start or stop the channel hopping
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *hopping pointer to a caller allocated hopping state, NULL stops the hopping
+ * @param[in] *channel pointer to a channel sequence, NULL stops the hopping
+ * @param[in] num sequence length
+ * @param[in] slot_us slot length in us
+ * @return    status code
+ *            - 0 success
+ *            - 1 set hopping failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ *            - 5 hopping is invalid
+ * @note      the state and the sequence must stay valid while hopping, slot 0 starts now on the
+ *            first channel
+ */
+uint8_t nrf24l01_set_hopping(nrf24l01_handle_t *handle, nrf24l01_hopping_t *hopping,
+                             const uint8_t *channel, uint8_t num, uint32_t slot_us);
+
+/**
+ * @brief     update the channel hopping
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 hop failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it at least once per slot, it retunes to the channel of the current slot with ce
+ *            low, one rf channel write and ce high, slots passed without an update are counted as
+ *            missed and skipped, the hop waits while a send is running
+ */
+uint8_t nrf24l01_hopping_update(nrf24l01_handle_t *handle);
+
+/**
+ * @brief     synchronize the channel hopping
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] slot slot of the peer
+ * @param[in] offset_us time since the peer slot started
+ * @return    status code
+ *            - 0 success
+ *            - 1 hopping sync failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 hopping is not started
+ * @note      the peer slot and offset come from nrf24l01_get_hopping_status on the peer, add the
+ *            air time of the frame that carried them to the offset
+ */
+uint8_t nrf24l01_hopping_sync(nrf24l01_handle_t *handle, uint32_t slot, uint32_t offset_us);
+
+/**
+ * @brief      get the channel hopping status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *slot pointer to a current slot buffer
+ * @param[out] *offset_us pointer to a time since the slot started buffer
+ * @param[out] *channel pointer to a tuned channel buffer
+ * @param[out] *missed pointer to a missed slots buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 hopping is not started
+ * @note       the slot and offset follow the clock even when the update is late
+ */
+uint8_t nrf24l01_get_hopping_status(nrf24l01_handle_t *handle, uint32_t *slot, uint32_t *offset_us,
+                                    uint8_t *channel, uint32_t *missed);
+
+/**
+ * @brief      initialize a channel scan
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *scan pointer to a caller allocated scan structure
+ * @param[in]  first first scanned channel
+ * @param[in]  last last scanned channel
+ * @param[in]  samples rpd samples per channel and sweep
+ * @param[in]  dwell_us rx time before every rpd sample
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 scan is invalid
+ * @note       last <= 0x7F, samples >= 1, dwell_us >= 170 which is the rx settling and agc time
+ */
+uint8_t nrf24l01_scan_init(nrf24l01_handle_t *handle, nrf24l01_scan_t *scan, uint8_t first, uint8_t last,
+                           uint8_t samples, uint32_t dwell_us);
+
+/**
+ * @brief     scan channels with the received power detector
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *scan pointer to an initialized scan structure
+ * @param[in] steps scanned channels, 0 means one sweep
+ * @return    status code
+ *            - 0 success
+ *            - 1 scan failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 send is running
+ *            - 5 chip is powered down
+ * @note      every channel costs ce low, one rf channel write, ce high and one rpd read per sample,
+ *            the scan continues from the last channel on the next call so a sweep can be split
+ *            between the traffic, the channel and mode are restored before returning, ce is
+ *            restored low in power down and standby-I when the power state is tracked and high
+ *            otherwise, payloads that match an rx address on a scanned channel are received as usual
+ */
+uint8_t nrf24l01_scan(nrf24l01_handle_t *handle, nrf24l01_scan_t *scan, uint8_t steps);
+
+/**
+ * @brief      get the quietest scanned channels
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  *scan pointer to an initialized scan structure
+ * @param[out] *channel pointer to a channel buffer
+ * @param[in]  num channel number
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 num is invalid
+ * @note       the channels are ordered from the fewest busy samples, equal channels keep the
+ *             channel order
+ */
+uint8_t nrf24l01_scan_get_quiet(nrf24l01_handle_t *handle, nrf24l01_scan_t *scan, uint8_t *channel, uint8_t num);
+
+/**
+ * @brief     start or stop the star network hub
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *hub pointer to a caller allocated hub state, NULL stops the hub
+ * @param[in] *node pointer to a caller allocated node table, NULL stops the hub
+ * @param[in] num node number
+ * @param[in] slice_us rotation slice length in us
+ * @param[in] hot slice payloads that pin a node to its pipe, 0 disables
+ * @return    status code
+ *            - 0 success
+ *            - 1 set hub failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ *            - 5 hub is invalid
+ * @note      the nodes share the pipe 1 address except the lsb which is the node address byte,
+ *            set the pipe 1 address, the pipe 1 - 5 auto acknowledgment and payload widths before
+ *            starting, pipes 1 - 5 belong to the hub until it stops, nodes with pinned = 1 start
+ *            pinned and at most 4 nodes can be pinned
+ */
+uint8_t nrf24l01_set_hub(nrf24l01_handle_t *handle, nrf24l01_hub_t *hub, nrf24l01_hub_node_t *node, uint16_t num,
+                         uint32_t slice_us, uint16_t hot);
+
+/**
+ * @brief     rotate the hub nodes when the slice is over
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 hub update failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it from the main loop, the rotation waits while a send is running or the rx fifo
+ *            holds payloads so a payload is never given to the next node of its pipe, hot talkers
+ *            are pinned and pinned hot talkers without payloads in the slice go back to rotation
+ */
+uint8_t nrf24l01_hub_update(nrf24l01_handle_t *handle);
+
+/**
+ * @brief     pin a hub node to a dedicated pipe
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] index node index
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 index is invalid
+ *            - 5 no free pipe
+ * @note      the node gets or leaves its pipe on the next rotation
+ */
+uint8_t nrf24l01_hub_pin(nrf24l01_handle_t *handle, uint16_t index, nrf24l01_bool_t enable);
+
+/**
+ * @brief      get the hub node of a pipe
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  pipe received pipe
+ * @param[out] *index pointer to a node index buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 pipe has no node
+ * @note       call it from the receive callback with the received pipe
+ */
+uint8_t nrf24l01_hub_get_node(nrf24l01_handle_t *handle, uint8_t pipe, uint16_t *index);
 
 /**
- * @brief     link gpio_write function
- * @param[in] HANDLE pointer to an nrf24l01 handle structure
- * @param[in] FUC pointer to a gpio_write function address
- * @note      none
+ * @brief     start or stop the tree network layer
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *mesh pointer to a caller allocated mesh state, NULL stops the layer
+ * @param[in] address node address
+ * @param[in] parent parent address, NRF24L01_MESH_NONE for the root
+ * @param[in] *frame pointer to a caller allocated forward queue, NULL stops the layer
+ * @param[in] depth forward queue depth
+ * @param[in] *route pointer to a caller allocated route cache
+ * @param[in] route_num route cache size
+ * @return    status code
+ *            - 0 success
+ *            - 1 set mesh failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 mesh is invalid
+ * @note      bytes 1 and 2 of the pipe 1 - 5 addresses carry the node address, the lsb the pipe
+ *            and the other bytes come from the pipe 1 address set before starting, a node hears
+ *            its parent on pipe 1 and its children on pipes 2 - 5, pipe 0 follows the next hop for
+ *            the auto acknowledgment, use dynamic payloads in prx mode, depth >= 2 and one queue
+ *            slot is kept free, leaves can run without a route cache, starting clears the message
+ *            handler
  */
-#define DRIVER_NRF24L01_LINK_SPI_WRITE(HANDLE, FUC)         (HANDLE)->spi_write = FUC
+uint8_t nrf24l01_set_mesh(nrf24l01_handle_t *handle, nrf24l01_mesh_t *mesh, uint16_t address, uint16_t parent,
+                          nrf24l01_mesh_frame_t *frame, uint16_t depth, nrf24l01_mesh_route_t *route, uint16_t route_num);
 
 /**
- * @brief     link gpio_init function
- * @param[in] HANDLE pointer to an nrf24l01 handle structure
- * @param[in] FUC pointer to a gpio_init function address
- * @note      none
+ * @brief     set the mesh message handler
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *callback pointer to a message handler, NULL drops the messages
+ * @param[in] *param pointer to the handler parameter
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 mesh is not set
+ * @note      the handler runs in the irq handler with the message in the read buffer
  */
-#define DRIVER_NRF24L01_LINK_GPIO_INIT(HANDLE, FUC)         (HANDLE)->gpio_init = FUC
+uint8_t nrf24l01_set_mesh_handler(nrf24l01_handle_t *handle,
+                                  void (*callback)(uint16_t from, uint8_t *buf, uint8_t len, void *param), void *param);
 
 /**
- * @brief     link gpio_deinit function
- * @param[in] HANDLE pointer to an nrf24l01 handle structure
- * @param[in] FUC pointer to a gpio_deinit function address
- * @note      none
+ * @brief     send a message over the tree network
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] to destination address
+ * @param[in] *buf pointer to a message buffer
+ * @param[in] len message length
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 len is over 25
+ *            - 5 no route
+ * @note      the message goes to the cached next hop, then to the parent, only the first hop is
+ *            acknowledged
  */
-#define DRIVER_NRF24L01_LINK_GPIO_DEINIT(HANDLE, FUC)       (HANDLE)->gpio_deinit = FUC
+uint8_t nrf24l01_mesh_send(nrf24l01_handle_t *handle, uint16_t to, uint8_t *buf, uint8_t len);
 
 /**
- * @brief     link gpio_write function
- * @param[in] HANDLE pointer to an nrf24l01 handle structure
- * @param[in] FUC pointer to a gpio_write function address
- * @note      none
+ * @brief     send the queued forward frames
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 mesh update failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it from the main loop, the receive path routes the frames in the queue slots they
+ *            were read into and the update writes them to the tx fifo from there
  */
-#define DRIVER_NRF24L01_LINK_GPIO_WRITE(HANDLE, FUC)        (HANDLE)->gpio_write = FUC
+uint8_t nrf24l01_mesh_update(nrf24l01_handle_t *handle);
 
 /**
- * @brief     link delay_ms function
- * @param[in] HANDLE pointer to an nrf24l01 handle structure
- * @param[in] FUC pointer to a delay_ms function address
- * @note      none
+ * @brief      get the tree network status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *delivered pointer to a delivered messages buffer
+ * @param[out] *forwarded pointer to a forwarded frames buffer
+ * @param[out] *dropped pointer to a dropped frames buffer
+ * @param[out] *failed pointer to a failed sends buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 mesh is not set
+ * @note       frames are dropped when the queue is full, the ttl expires or there is no route
  */
-#define DRIVER_NRF24L01_LINK_DELAY_MS(HANDLE, FUC)          (HANDLE)->delay_ms = FUC
+uint8_t nrf24l01_get_mesh_status(nrf24l01_handle_t *handle, uint32_t *delivered, uint32_t *forwarded,
+                                 uint32_t *dropped, uint32_t *failed);
 
 /**
- * @brief     link debug_print function
- * @param[in] HANDLE pointer to an nrf24l01 handle structure
- * @param[in] FUC pointer to a debug_print function address
- * @note      none
+ * @brief     set the time sync role
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *sync pointer to a caller allocated sync state, NULL stops the time sync
+ * @param[in] role sync role
+ * @param[in] pipe beacon pipe of the slave
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ *            - 5 pipe is invalid
+ * @note      the master sends the beacons with no ack so its tx_ds and the rx_dr of the slaves mark
+ *            the same air time, enable the tx payload with no ack on the master and give the
+ *            beacons a pipe of their own on the slaves, setting a role clears the estimate
  */
-#define DRIVER_NRF24L01_LINK_DEBUG_PRINT(HANDLE, FUC)       (HANDLE)->debug_print = FUC
+uint8_t nrf24l01_set_sync(nrf24l01_handle_t *handle, nrf24l01_sync_t *sync, nrf24l01_sync_role_t role, uint8_t pipe);
 
 /**
- * @brief     link receive_callback function
- * @param[in] HANDLE pointer to an nrf24l01 handle structure
- * @param[in] FUC pointer to a receive_callback function address
- * @note      none
+ * @brief     set the timestamp of the irq edge
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] us irq falling edge time on the timestamp_us clock
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it right before nrf24l01_irq_handler when the platform stamps the edge, the
+ *            irq handler reads timestamp_us on entry otherwise, the edge is dropped without a time
+ *            sync
  */
-#define DRIVER_NRF24L01_LINK_RECEIVE_CALLBACK(HANDLE, FUC)  (HANDLE)->receive_callback = FUC
+uint8_t nrf24l01_set_irq_timestamp(nrf24l01_handle_t *handle, uint32_t us);
 
 /**
- * @}
+ * @brief     send a time sync beacon
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 send beacon failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 role is not master
+ *            - 5 send is busy
+ * @note      every beacon carries the tx_ds time of the one before, the slaves get a sample from
+ *            the second beacon on
  */
+uint8_t nrf24l01_sync_beacon(nrf24l01_handle_t *handle);
 
 /**
- * @defgroup nrf24l01_basic_driver nrf24l01 basic driver function
- * @brief    nrf24l01 basic driver modules
- * @ingroup  nrf24l01_driver
- * @{
+ * @brief      convert a local time to the master time
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[in]  local local time on the timestamp_us clock
+ * @param[out] *master pointer to a master time buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 not synchronized
+ * @note       the master gets its own time, the slave applies the offset and the drift from the
+ *             last sample
  */
+uint8_t nrf24l01_sync_get_time(nrf24l01_handle_t *handle, uint32_t local, uint32_t *master);
 
 /**
- * @brief      get chip's information
- * @param[out] *info pointer to an nrf24l01 info structure
+ * @brief      get the time sync status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *offset pointer to an offset buffer in us
+ * @param[out] *drift pointer to a drift buffer in ppb
+ * @param[out] *error pointer to a last prediction error buffer in us
+ * @param[out] *samples pointer to a samples buffer
  * @return     status code
  *             - 0 success
  *             - 2 handle is NULL
- * @note       none
+ *             - 3 handle is not initialized
+ *             - 4 sync is not set
+ * @note       the error is the last sample minus the time predicted from the sample before
  */
-uint8_t nrf24l01_info(nrf24l01_info_t *info);
+uint8_t nrf24l01_get_sync_status(nrf24l01_handle_t *handle, int32_t *offset, int32_t *drift,
+                                 int32_t *error, uint32_t *samples);
 
 /**
- * @brief     irq handler
+ * @brief     start or stop the tdma slots
  * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *tdma pointer to a caller allocated tdma state, NULL stops the slots
+ * @param[in] *table pointer to a slot owner table, NULL stops the slots
+ * @param[in] num slot number
+ * @param[in] node own node
+ * @param[in] slot_us slot length in us
+ * @param[in] margin_us time sync margin in us
  * @return    status code
  *            - 0 success
- *            - 1 run failed
+ *            - 1 set tdma failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 timestamp_us is null
+ *            - 5 tdma is invalid
+ *            - 6 tx ring is not set
+ * @note      the node sends the tx ring only in the slots it owns, the table must stay valid while
+ *            the slots run, a frame is loaded when the send deadline of a full frame for it and
+ *            every frame before it plus the margin fits before the slot end, the slots follow the
+ *            master time once the time sync has a sample
  */
-uint8_t nrf24l01_irq_handler(nrf24l01_handle_t *handle);
+uint8_t nrf24l01_set_tdma(nrf24l01_handle_t *handle, nrf24l01_tdma_t *tdma, const uint16_t *table, uint8_t num, uint16_t node,
+                          uint32_t slot_us, uint32_t margin_us);
 
 /**
- * @brief     initialize the chip
+ * @brief     update the tdma slots
  * @param[in] *handle pointer to an nrf24l01 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 spi initialization failed
+ *            - 1 tdma update failed
  *            - 2 handle is NULL
- *            - 3 linked functions is NULL
- *            - 4 gpio init failed
- * @note      none
+ *            - 3 handle is not initialized
+ * @note      call it at least once per own slot, it loads the tx fifo from the tx ring when the
+ *            slot opens, the irq handler keeps loading the frames back to back until the slot ends
+ *            and then finishes the send with NRF24L01_SEND_STATUS_HELD
  */
-uint8_t nrf24l01_init(nrf24l01_handle_t *handle);
+uint8_t nrf24l01_tdma_update(nrf24l01_handle_t *handle);
 
 /**
- * @brief     close the chip
+ * @brief      get the tdma status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *slot pointer to a current slot buffer
+ * @param[out] *guard_us pointer to a guard time buffer in us
+ * @param[out] *slots pointer to a used slots buffer
+ * @param[out] *held pointer to a held frames buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 tdma is not started
+ * @note       the guard time is the send deadline of a full frame plus the margin
+ */
+uint8_t nrf24l01_get_tdma_status(nrf24l01_handle_t *handle, uint8_t *slot, uint32_t *guard_us,
+                                 uint32_t *slots, uint32_t *held);
+
+/**
+ * @brief     set the power state tracking
  * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *power pointer to a caller allocated power state, NULL stops the tracking
  * @return    status code
  *            - 0 success
- *            - 1 nop failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 gpio deinit failed
- *            - 5 spi deinit failed
- * @note      none
+ *            - 4 send is busy
+ * @note      the tracking carries nrf24l01_set_power_state, the next state set restarts the
+ *            residency counters
  */
-uint8_t nrf24l01_deinit(nrf24l01_handle_t *handle);
+uint8_t nrf24l01_set_power_tracking(nrf24l01_handle_t *handle, nrf24l01_power_t *power);
 
 /**
- * @brief     send data
+ * @brief     set the power state
  * @param[in] *handle pointer to an nrf24l01 handle structure
- * @param[in] *buf pointer to a data buffer
- * @param[in] len buffer length
+ * @param[in] state power state
  * @return    status code
  *            - 0 success
- *            - 1 send failed
+ *            - 1 set power state failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 len is over 32
- *            - 5 send timeout
- * @note      none
+ *            - 4 timestamp_us is null
+ *            - 5 state is invalid
+ *            - 6 send is busy
+ *            - 7 power tracking is not set
+ * @note      one config write when pwr_up or prim_rx changes and one ce write when ce changes, it
+ *            waits the 1.5 ms start up time when leaving power down and the 130 us settling time
+ *            when entering rx or tx, link delay_us for us waits, the first call after
+ *            nrf24l01_set_power_tracking starts the residency counters and the irq handler keeps ce
+ *            low in power down and standby-I
  */
-uint8_t nrf24l01_send(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len);
+uint8_t nrf24l01_set_power_state(nrf24l01_handle_t *handle, nrf24l01_power_state_t state);
+
+/**
+ * @brief      get the power state
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *state pointer to a power state buffer
+ * @param[out] *residency pointer to a 5 entry residency buffer in us, indexed by the power state
+ * @param[out] *transitions pointer to a transitions buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 power state is not set
+ * @note       a send counts as tx until it finishes and as standby-II after that, the start up and
+ *             settling waits count to the state left
+ */
+uint8_t nrf24l01_get_power_state(nrf24l01_handle_t *handle, nrf24l01_power_state_t *state,
+                                 uint64_t *residency, uint32_t *transitions);
 
 /**
  * @brief     enable or disable the chip
@@ -374,7 +1927,7 @@ uint8_t nrf24l01_send(nrf24l01_handle_t *handle, uint8_t *buf, uint8_t len);
  *            - 1 set active failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      waits the 130 us settling time after enabling when delay_us is linked
  */
 uint8_t nrf24l01_set_active(nrf24l01_handle_t *handle, nrf24l01_bool_t enable);
 
@@ -388,7 +1941,7 @@ uint8_t nrf24l01_set_active(nrf24l01_handle_t *handle, nrf24l01_bool_t enable);
  *            - 1 set config failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      waits the 1.5 ms start up time after powering up
  */
 uint8_t nrf24l01_set_config(nrf24l01_handle_t *handle, nrf24l01_config_t config, nrf24l01_bool_t enable);
 
@@ -415,7 +1968,7 @@ uint8_t nrf24l01_get_config(nrf24l01_handle_t *handle, nrf24l01_config_t config,
  *            - 1 set mode failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      waits the 130 us settling time after a mode switch when delay_us is linked
  */
 uint8_t nrf24l01_set_mode(nrf24l01_handle_t *handle, nrf24l01_mode_t mode);
 
@@ -1401,6 +2954,181 @@ uint8_t nrf24l01_write_payload_with_no_ack(nrf24l01_handle_t *handle, uint8_t *b
  */
 uint8_t nrf24l01_nop(nrf24l01_handle_t *handle);
 
+/**
+ * @}
+ */
+
+/**
+ * @defgroup nrf24l01_advance_driver nrf24l01 advance driver function
+ * @brief    nrf24l01 advance driver modules
+ * @ingroup  nrf24l01_driver
+ * @{
+ */
+
+/**
+ * @brief      get the last status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *status pointer to a status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       no spi transaction, the status is refreshed by every command when spi_transfer
+ *             is linked, otherwise only by the status register reads
+ */
+uint8_t nrf24l01_get_last_status(nrf24l01_handle_t *handle, uint8_t *status);
+
+/**
+ * @brief     set the register shadow
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *shadow pointer to a caller allocated register shadow, NULL disables the shadow
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the shadow is emptied on every call, when set the setters only write
+ *            the chip and the getters answer from the shadow after the first access
+ */
+uint8_t nrf24l01_set_register_shadow(nrf24l01_handle_t *handle, nrf24l01_shadow_t *shadow);
+
+/**
+ * @brief      get the register shadow status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_register_shadow(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable);
+
+/**
+ * @brief     invalidate the register shadow
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it after the chip is reset or powered off outside the driver
+ */
+uint8_t nrf24l01_register_shadow_invalidate(nrf24l01_handle_t *handle);
+
+/**
+ * @brief     resync the register shadow from the chip
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 register shadow sync failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 register shadow is disabled
+ * @note      none
+ */
+uint8_t nrf24l01_register_shadow_sync(nrf24l01_handle_t *handle);
+
+/**
+ * @brief     enable or disable the rx fifo drain
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      when enabled the irq handler delivers every payload in the rx fifo
+ *            until the status pipe field reads empty
+ */
+uint8_t nrf24l01_set_rx_drain(nrf24l01_handle_t *handle, nrf24l01_bool_t enable);
+
+/**
+ * @brief      get the rx fifo drain status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_rx_drain(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable);
+
+/**
+ * @brief     enable or disable the payload wire order
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      when enabled payloads are passed to and from the chip untouched, the first byte
+ *            on the air is the first byte of the buffer, when disabled the legacy reversed order is kept
+ */
+uint8_t nrf24l01_set_wire_order(nrf24l01_handle_t *handle, nrf24l01_bool_t enable);
+
+/**
+ * @brief      get the payload wire order status
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t nrf24l01_get_wire_order(nrf24l01_handle_t *handle, nrf24l01_bool_t *enable);
+
+/**
+ * @brief     apply a configuration profile
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *profile pointer to a profile structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 apply profile failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 profile is invalid
+ *            - 5 send is busy
+ * @note      every register is composed in full and only written when it differs from the chip,
+ *            with the register shadow enabled the comparison needs no spi read, the pending
+ *            interrupts are left to the caller, addresses use the same byte order as the address
+ *            setters and ce should be low while applying, powering the chip up waits
+ *            the 1.5 ms start up time
+ */
+uint8_t nrf24l01_apply_profile(nrf24l01_handle_t *handle, const nrf24l01_profile_t *profile);
+
+/**
+ * @brief      take a snapshot of the register file
+ * @param[in]  *handle pointer to an nrf24l01 handle structure
+ * @param[out] *buf pointer to a snapshot buffer
+ * @param[in]  len snapshot buffer length
+ * @return     status code
+ *             - 0 success
+ *             - 1 snapshot failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 len is too short
+ * @note       len must be at least NRF24L01_SNAPSHOT_LENGTH, the blob holds the configuration
+ *             registers and the pipe addresses in chip order followed by a crc16
+ */
+uint8_t nrf24l01_snapshot(nrf24l01_handle_t *handle, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     restore the register file from a snapshot
+ * @param[in] *handle pointer to an nrf24l01 handle structure
+ * @param[in] *buf pointer to a snapshot buffer
+ * @param[in] len snapshot buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 restore failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 snapshot is invalid
+ *            - 5 crc check failed
+ * @note      every register is written without read back, config is written last, then the
+ *            interrupts are cleared and both fifos are flushed, ce should be low while restoring
+ */
+uint8_t nrf24l01_restore(nrf24l01_handle_t *handle, const uint8_t *buf, uint16_t len);
+
 /**
  * @}
  */
@@ -38,6 +38,61 @@
 #include <stdlib.h>
 
 static nrf24l01_handle_t gs_handle;        /**< nrf24l01 handle */
+static uint32_t gs_spi_transaction;        /**< spi transaction counter */
+
+/**
+ * @brief      counted spi bus read
+ * @param[in]  *user_data pointer to the user data
+ * @param[in]  reg register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+static uint8_t a_nrf24l01_register_test_spi_read(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    gs_spi_transaction++;
+    
+    return nrf24l01_interface_spi_read(user_data, reg, buf, len);
+}
+
+/**
+ * @brief     counted spi bus write
+ * @param[in] *user_data pointer to the user data
+ * @param[in] reg register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_nrf24l01_register_test_spi_write(void *user_data, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    gs_spi_transaction++;
+    
+    return nrf24l01_interface_spi_write(user_data, reg, buf, len);
+}
+
+/**
+ * @brief      counted spi bus full duplex transfer
+ * @param[in]  *user_data pointer to the user data
+ * @param[in]  *tx pointer to a tx buffer
+ * @param[out] *rx pointer to a rx buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 transfer failed
+ * @note       none
+ */
+static uint8_t a_nrf24l01_register_test_spi_transfer(void *user_data, uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    gs_spi_transaction++;
+    
+    return nrf24l01_interface_spi_transfer(user_data, tx, rx, len);
+}
 
 /**
  * @brief  register test
@@ -61,17 +116,48 @@ uint8_t nrf24l01_register_test(void)
     nrf24l01_address_width_t width;
     nrf24l01_data_rate_t rate;
     nrf24l01_output_power_t power;
+    nrf24l01_profile_t profile;
+    nrf24l01_shadow_t shadow;
+    uint8_t snapshot[NRF24L01_SNAPSHOT_LENGTH];
+    nrf24l01_hopping_t hopping;
+    uint8_t hop[16];
+    uint8_t hop_check[16];
+    uint32_t slot, missed;
+    nrf24l01_hub_t hub;
+    nrf24l01_hub_node_t node[8];
+    nrf24l01_mesh_t mesh;
+    nrf24l01_mesh_frame_t mesh_frame[2];
+    nrf24l01_mesh_route_t mesh_route[4];
+    uint32_t delivered, forwarded, dropped, failed;
+    nrf24l01_sync_t sync;
+    int32_t offset, drift, error;
+    uint32_t samples, master;
+    nrf24l01_tx_ring_t tx_ring;
+    nrf24l01_tx_frame_t tx_frame[4];
+    nrf24l01_send_status_t send_status;
+    nrf24l01_tdma_t tdma;
+    uint16_t tdma_table[4];
+    uint32_t guard, slots, held;
+    nrf24l01_power_t power_tracking;
+    nrf24l01_power_state_t power_state;
+    uint64_t residency[5];
+    uint32_t transitions;
+    uint16_t index;
+    uint8_t i;
 
     /* link function */
     DRIVER_NRF24L01_LINK_INIT(&gs_handle, nrf24l01_handle_t);
     DRIVER_NRF24L01_LINK_SPI_INIT(&gs_handle, nrf24l01_interface_spi_init);
     DRIVER_NRF24L01_LINK_SPI_DEINIT(&gs_handle, nrf24l01_interface_spi_deinit);
-    DRIVER_NRF24L01_LINK_SPI_READ(&gs_handle, nrf24l01_interface_spi_read);
-    DRIVER_NRF24L01_LINK_SPI_WRITE(&gs_handle, nrf24l01_interface_spi_write);
+    DRIVER_NRF24L01_LINK_SPI_READ(&gs_handle, a_nrf24l01_register_test_spi_read);
+    DRIVER_NRF24L01_LINK_SPI_WRITE(&gs_handle, a_nrf24l01_register_test_spi_write);
+    DRIVER_NRF24L01_LINK_SPI_TRANSFER(&gs_handle, a_nrf24l01_register_test_spi_transfer);
     DRIVER_NRF24L01_LINK_GPIO_INIT(&gs_handle, nrf24l01_interface_gpio_init);
     DRIVER_NRF24L01_LINK_GPIO_DEINIT(&gs_handle, nrf24l01_interface_gpio_deinit);
     DRIVER_NRF24L01_LINK_GPIO_WRITE(&gs_handle, nrf24l01_interface_gpio_write);
     DRIVER_NRF24L01_LINK_DELAY_MS(&gs_handle, nrf24l01_interface_delay_ms);
+    DRIVER_NRF24L01_LINK_DELAY_US(&gs_handle, nrf24l01_interface_delay_us);
+    DRIVER_NRF24L01_LINK_TIMESTAMP_US(&gs_handle, nrf24l01_interface_timestamp_us);
     DRIVER_NRF24L01_LINK_DEBUG_PRINT(&gs_handle, nrf24l01_interface_debug_print);
     DRIVER_NRF24L01_LINK_RECEIVE_CALLBACK(&gs_handle, nrf24l01_interface_receive_callback);
 
@@ -2338,6 +2424,830 @@ uint8_t nrf24l01_register_test(void)
     }
     nrf24l01_interface_debug_print("nrf24l01: nop %s.\n", res == 0 ? "ok" : "error");
 
+    /* nrf24l01_get_last_status test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_get_last_status test.\n");
+
+    /* get data pipe number */
+    res = nrf24l01_get_data_pipe_number(&gs_handle, (uint8_t *)&value);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get data pipe number failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* get last status */
+    res = nrf24l01_get_last_status(&gs_handle, (uint8_t *)&value_check);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get last status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: last status is 0x%02X.\n", value_check);
+    nrf24l01_interface_debug_print("nrf24l01: check last status %s.\n", (((value_check >> 1) & 0x7) == value) ? "ok" : "error");
+
+    /* nrf24l01_set_rx_drain/nrf24l01_get_rx_drain test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_set_rx_drain/nrf24l01_get_rx_drain test.\n");
+
+    /* enable rx drain */
+    res = nrf24l01_set_rx_drain(&gs_handle, NRF24L01_BOOL_TRUE);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set rx drain failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: enable rx drain.\n");
+    res = nrf24l01_get_rx_drain(&gs_handle, &enable);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get rx drain failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check rx drain %s.\n", enable == NRF24L01_BOOL_TRUE ? "ok" : "error");
+
+    /* disable rx drain */
+    res = nrf24l01_set_rx_drain(&gs_handle, NRF24L01_BOOL_FALSE);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set rx drain failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: disable rx drain.\n");
+    res = nrf24l01_get_rx_drain(&gs_handle, &enable);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get rx drain failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check rx drain %s.\n", enable == NRF24L01_BOOL_FALSE ? "ok" : "error");
+
+    /* nrf24l01_set_wire_order/nrf24l01_get_wire_order test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_set_wire_order/nrf24l01_get_wire_order test.\n");
+
+    /* enable wire order */
+    res = nrf24l01_set_wire_order(&gs_handle, NRF24L01_BOOL_TRUE);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set wire order failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: enable wire order.\n");
+    res = nrf24l01_get_wire_order(&gs_handle, &enable);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get wire order failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check wire order %s.\n", enable == NRF24L01_BOOL_TRUE ? "ok" : "error");
+
+    /* disable wire order */
+    res = nrf24l01_set_wire_order(&gs_handle, NRF24L01_BOOL_FALSE);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set wire order failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: disable wire order.\n");
+    res = nrf24l01_get_wire_order(&gs_handle, &enable);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get wire order failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check wire order %s.\n", enable == NRF24L01_BOOL_FALSE ? "ok" : "error");
+
+    /* nrf24l01_set_register_shadow/nrf24l01_get_register_shadow test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_set_register_shadow/nrf24l01_get_register_shadow test.\n");
+
+    /* disable register shadow */
+    res = nrf24l01_set_register_shadow(&gs_handle, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set register shadow failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: disable register shadow.\n");
+    res = nrf24l01_get_register_shadow(&gs_handle, &enable);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get register shadow failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check register shadow %s.\n", enable == NRF24L01_BOOL_FALSE ? "ok" : "error");
+
+    /* count the transactions without the shadow */
+    gs_spi_transaction = 0;
+    res = nrf24l01_set_channel_frequency(&gs_handle, 0x20);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set channel frequency failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_channel_frequency(&gs_handle, &value_check);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get channel frequency failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: set and get channel frequency without shadow use %d spi transactions.\n", gs_spi_transaction);
+    value = (uint8_t)gs_spi_transaction;
+
+    /* enable register shadow */
+    res = nrf24l01_set_register_shadow(&gs_handle, &shadow);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set register shadow failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: enable register shadow.\n");
+    res = nrf24l01_get_register_shadow(&gs_handle, &enable);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get register shadow failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check register shadow %s.\n", enable == NRF24L01_BOOL_TRUE ? "ok" : "error");
+
+    /* register shadow sync */
+    res = nrf24l01_register_shadow_sync(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: register shadow sync failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* count the transactions with the shadow */
+    gs_spi_transaction = 0;
+    res = nrf24l01_set_channel_frequency(&gs_handle, 0x21);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set channel frequency failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_channel_frequency(&gs_handle, &value_check);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get channel frequency failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: set and get channel frequency with shadow use %d spi transactions.\n", gs_spi_transaction);
+    nrf24l01_interface_debug_print("nrf24l01: check spi transactions %s.\n", (gs_spi_transaction < value) ? "ok" : "error");
+
+    /* check the chip against the shadow */
+    res = nrf24l01_register_shadow_invalidate(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: register shadow invalidate failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_channel_frequency(&gs_handle, &value);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get channel frequency failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check register shadow value %s.\n", (value == value_check) ? "ok" : "error");
+
+    /* nrf24l01_apply_profile test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_apply_profile test.\n");
+
+    /* set the profile */
+    memset(&profile, 0, sizeof(nrf24l01_profile_t));
+    profile.mode = NRF24L01_MODE_TX;
+    profile.power_up = NRF24L01_BOOL_TRUE;
+    profile.crc = NRF24L01_BOOL_TRUE;
+    profile.crco = NRF24L01_BOOL_TRUE;
+    profile.address_width = NRF24L01_ADDRESS_WIDTH_5_BYTES;
+    profile.retransmit_delay = rand() % 0xF;
+    profile.retransmit_count = rand() % 0xF;
+    profile.channel_frequency = rand() % 0x7F;
+    profile.data_rate = NRF24L01_DATA_RATE_2M;
+    profile.output_power = NRF24L01_OUTPUT_POWER_0_DBM;
+    for (len = 0; len < 6; len++)
+    {
+        profile.auto_acknowledgment[len] = NRF24L01_BOOL_TRUE;
+        profile.rx_pipe[len] = NRF24L01_BOOL_TRUE;
+        profile.payload_number[len] = 32;
+        profile.pipe_dynamic_payload[len] = NRF24L01_BOOL_TRUE;
+    }
+    profile.dynamic_payload = NRF24L01_BOOL_TRUE;
+    for (len = 0; len < 5; len++)
+    {
+        profile.rx_pipe_0_address[len] = rand() % 256;
+        profile.rx_pipe_1_address[len] = rand() % 256;
+        profile.tx_address[len] = rand() % 256;
+    }
+    for (len = 0; len < 4; len++)
+    {
+        profile.rx_pipe_address[len] = rand() % 256;
+    }
+
+    /* apply the profile */
+    res = nrf24l01_apply_profile(&gs_handle, &profile);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: apply profile failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: apply profile.\n");
+    res = nrf24l01_register_shadow_invalidate(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: register shadow invalidate failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_channel_frequency(&gs_handle, &value);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get channel frequency failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check channel frequency %s.\n", (value == profile.channel_frequency) ? "ok" : "error");
+    res = nrf24l01_get_auto_retransmit_count(&gs_handle, &value);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get auto retransmit count failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check auto retransmit count %s.\n", (value == profile.retransmit_count) ? "ok" : "error");
+    len = 5;
+    res = nrf24l01_get_tx_address(&gs_handle, (uint8_t *)addr_check, (uint8_t *)&len);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get tx address failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check tx address %s.\n", (memcmp(profile.tx_address, addr_check, 5) == 0) ? "ok" : "error");
+
+    /* apply the same profile again */
+    res = nrf24l01_register_shadow_sync(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: register shadow sync failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    gs_spi_transaction = 0;
+    res = nrf24l01_apply_profile(&gs_handle, &profile);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: apply profile failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: apply the same profile use %d spi transactions.\n", gs_spi_transaction);
+    nrf24l01_interface_debug_print("nrf24l01: check spi transactions %s.\n", (gs_spi_transaction == 0) ? "ok" : "error");
+
+    /* nrf24l01_snapshot/nrf24l01_restore test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_snapshot/nrf24l01_restore test.\n");
+
+    /* take a snapshot */
+    res = nrf24l01_snapshot(&gs_handle, (uint8_t *)snapshot, NRF24L01_SNAPSHOT_LENGTH);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: snapshot failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: take a snapshot.\n");
+
+    /* change the channel frequency */
+    res = nrf24l01_set_channel_frequency(&gs_handle, (uint8_t)((profile.channel_frequency + 1) % 0x7F));
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set channel frequency failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* restore the snapshot */
+    gs_spi_transaction = 0;
+    res = nrf24l01_restore(&gs_handle, (uint8_t *)snapshot, NRF24L01_SNAPSHOT_LENGTH);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: restore failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: restore the snapshot use %d spi transactions.\n", gs_spi_transaction);
+    res = nrf24l01_register_shadow_invalidate(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: register shadow invalidate failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_channel_frequency(&gs_handle, &value);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get channel frequency failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check channel frequency %s.\n", (value == profile.channel_frequency) ? "ok" : "error");
+
+    /* restore a broken snapshot */
+    snapshot[5] ^= 0x01;
+    res = nrf24l01_restore(&gs_handle, (uint8_t *)snapshot, NRF24L01_SNAPSHOT_LENGTH);
+    nrf24l01_interface_debug_print("nrf24l01: check crc %s.\n", (res == 5) ? "ok" : "error");
+
+    /* nrf24l01_calculate_air_time/nrf24l01_get_send_deadline test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_calculate_air_time/nrf24l01_get_send_deadline test.\n");
+
+    /* 250 kbps, 5 bytes address, 2 bytes crc and 32 bytes payload */
+    res = nrf24l01_calculate_air_time(&gs_handle, NRF24L01_DATA_RATE_250K, NRF24L01_ADDRESS_WIDTH_5_BYTES, 2, 32, (uint32_t *)&us);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: calculate air time failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check air time %s.\n", (us == 1316) ? "ok" : "error");
+    res = nrf24l01_get_send_deadline(&gs_handle, 32, (uint32_t *)&us);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get send deadline failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: send deadline is %d us.\n", us);
+
+    /* the cached deadline is read without spi transactions */
+    gs_spi_transaction = 0;
+    res = nrf24l01_get_send_deadline(&gs_handle, 32, (uint32_t *)&us);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get send deadline failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check cached send deadline %s.\n", (gs_spi_transaction == 0) ? "ok" : "error");
+
+    /* nrf24l01_hopping_sequence/nrf24l01_set_hopping/nrf24l01_hopping_update test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_hopping_sequence/nrf24l01_set_hopping/nrf24l01_hopping_update test.\n");
+
+    /* the same seed gives the same sequence */
+    us = (uint32_t)rand();
+    res = nrf24l01_hopping_sequence(&gs_handle, us, 2, 80, (uint8_t *)hop, 16);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: hopping sequence failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_hopping_sequence(&gs_handle, us, 2, 80, (uint8_t *)hop_check, 16);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: hopping sequence failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check sequence %s.\n", (memcmp(hop, hop_check, 16) == 0) ? "ok" : "error");
+
+    /* hop in 1 ms slots */
+    res = nrf24l01_set_hopping(&gs_handle, &hopping, (uint8_t *)hop, 16, 1000);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set hopping failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_delay_ms(3);
+    res = nrf24l01_hopping_update(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: hopping update failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_hopping_status(&gs_handle, (uint32_t *)&slot, (uint32_t *)&us, (uint8_t *)&value, (uint32_t *)&missed);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get hopping status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: slot %d channel %d missed %d.\n", slot, value, missed);
+    res = nrf24l01_get_channel_frequency(&gs_handle, (uint8_t *)&value_check);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get channel frequency failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check channel %s.\n", (value == value_check) ? "ok" : "error");
+    res = nrf24l01_set_hopping(&gs_handle, NULL, NULL, 0, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set hopping failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* nrf24l01_set_hub/nrf24l01_hub_update/nrf24l01_hub_get_node test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_set_hub/nrf24l01_hub_update/nrf24l01_hub_get_node test.\n");
+
+    /* rotate 8 nodes in 1 ms slices */
+    memset(node, 0, sizeof(node));
+    for (i = 0; i < 8; i++)
+    {
+        node[i].addr = (uint8_t)(0x10 + i);
+    }
+    node[7].pinned = 1;
+    res = nrf24l01_set_hub(&gs_handle, &hub, node, 8, 1000, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set hub failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_delay_ms(2);
+    res = nrf24l01_hub_update(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: hub update failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_hub_get_node(&gs_handle, 2, (uint16_t *)&index);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: hub get node failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_rx_pipe_2_address(&gs_handle, (uint8_t *)&value);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get rx pipe 2 address failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: pipe 2 node %d.\n", index);
+    nrf24l01_interface_debug_print("nrf24l01: check pipe address %s.\n", (node[index].addr == value) ? "ok" : "error");
+    nrf24l01_interface_debug_print("nrf24l01: check pinned node %s.\n", (node[7].pipe != 0) ? "ok" : "error");
+    res = nrf24l01_set_hub(&gs_handle, NULL, NULL, 0, 0, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set hub failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* nrf24l01_set_mesh/nrf24l01_mesh_update/nrf24l01_get_mesh_status test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_set_mesh/nrf24l01_mesh_update/nrf24l01_get_mesh_status test.\n");
+
+    /* node 0x0012 under the root */
+    res = nrf24l01_set_mesh(&gs_handle, &mesh, 0x0012, 0x0000, (nrf24l01_mesh_frame_t *)mesh_frame, 2,
+                            (nrf24l01_mesh_route_t *)mesh_route, 4);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set mesh failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_rx_pipe_2_address(&gs_handle, (uint8_t *)&value);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get rx pipe 2 address failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check pipe address %s.\n", (value == 0xC2) ? "ok" : "error");
+    len = 5;
+    res = nrf24l01_get_rx_pipe_1_address(&gs_handle, (uint8_t *)addr, (uint8_t *)&len);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get rx pipe 1 address failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check node address %s.\n",
+                                   ((addr[len - 1] == 0xC1) && (addr[len - 2] == 0x12) && (addr[len - 3] == 0x00)) ? "ok" : "error");
+    res = nrf24l01_mesh_update(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: mesh update failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_mesh_status(&gs_handle, (uint32_t *)&delivered, (uint32_t *)&forwarded, (uint32_t *)&dropped, (uint32_t *)&failed);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get mesh status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: delivered %d forwarded %d dropped %d failed %d.\n", delivered, forwarded, dropped, failed);
+    res = nrf24l01_set_mesh(&gs_handle, NULL, 0, 0, NULL, 0, NULL, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set mesh failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* nrf24l01_set_sync/nrf24l01_sync_get_time/nrf24l01_get_sync_status test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_set_sync/nrf24l01_sync_get_time/nrf24l01_get_sync_status test.\n");
+
+    /* slave on pipe 1 */
+    res = nrf24l01_set_sync(&gs_handle, &sync, NRF24L01_SYNC_ROLE_SLAVE, 1);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set sync failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_set_irq_timestamp(&gs_handle, nrf24l01_interface_timestamp_us());
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set irq timestamp failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_sync_get_time(&gs_handle, nrf24l01_interface_timestamp_us(), (uint32_t *)&master);
+    nrf24l01_interface_debug_print("nrf24l01: check no beacon %s.\n", (res == 4) ? "ok" : "error");
+    res = nrf24l01_get_sync_status(&gs_handle, (int32_t *)&offset, (int32_t *)&drift, (int32_t *)&error, (uint32_t *)&samples);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get sync status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: offset %d drift %d error %d samples %d.\n", offset, drift, error, samples);
+    res = nrf24l01_set_sync(&gs_handle, NULL, NRF24L01_SYNC_ROLE_NONE, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set sync failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* nrf24l01_set_tdma/nrf24l01_tdma_update/nrf24l01_get_tdma_status test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_set_tdma/nrf24l01_tdma_update/nrf24l01_get_tdma_status test.\n");
+
+    /* node 1 owns slot 1 and 3 of 4 */
+    tdma_table[0] = 0;
+    tdma_table[1] = 1;
+    tdma_table[2] = 2;
+    tdma_table[3] = 1;
+    res = nrf24l01_set_tx_ring(&gs_handle, &tx_ring, (nrf24l01_tx_frame_t *)tx_frame, 4);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set tx ring failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_set_tdma(&gs_handle, &tdma, (const uint16_t *)tdma_table, 4, 1, 100000, 100);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set tdma failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_tdma_update(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: tdma update failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_tdma_status(&gs_handle, (uint8_t *)&value, (uint32_t *)&guard, (uint32_t *)&slots, (uint32_t *)&held);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get tdma status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: slot %d guard %d us slots %d held %d.\n", value, guard, slots, held);
+
+    /* node 3 owns no slot, the frames are held once each and the radio is free */
+    res = nrf24l01_set_tdma(&gs_handle, &tdma, (const uint16_t *)tdma_table, 4, 3, 100000, 100);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set tdma failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    for (i = 0; i < 2; i++)
+    {
+        res = nrf24l01_tx_ring_write(&gs_handle, (uint8_t *)buf, 5);
+        if (res != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: tx ring write failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+
+            return 1;
+        }
+    }
+    res = nrf24l01_tdma_update(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: tdma update failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_tdma_status(&gs_handle, (uint8_t *)&value, (uint32_t *)&guard, (uint32_t *)&slots, (uint32_t *)&held);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get tdma status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_send_status(&gs_handle, &send_status);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get send status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check held frames %s.\n", ((held == 2) && (send_status == NRF24L01_SEND_STATUS_HELD)) ? "ok" : "error");
+    res = nrf24l01_set_tdma(&gs_handle, NULL, NULL, 0, 0, 0, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set tdma failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_set_tx_ring(&gs_handle, NULL, NULL, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set tx ring failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* nrf24l01_set_power_state/nrf24l01_get_power_state test */
+    nrf24l01_interface_debug_print("nrf24l01: nrf24l01_set_power_state/nrf24l01_get_power_state test.\n");
+
+    /* track the power state */
+    res = nrf24l01_set_power_tracking(&gs_handle, &power_tracking);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set power tracking failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* power down, standby-I and rx */
+    res = nrf24l01_set_power_state(&gs_handle, NRF24L01_POWER_STATE_POWER_DOWN);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set power state failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_set_power_state(&gs_handle, NRF24L01_POWER_STATE_STANDBY_1);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set power state failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_config(&gs_handle, NRF24L01_CONFIG_PWR_UP, &enable);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get config failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check power up %s.\n", (enable == NRF24L01_BOOL_TRUE) ? "ok" : "error");
+    res = nrf24l01_set_power_state(&gs_handle, NRF24L01_POWER_STATE_RX);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set power state failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = nrf24l01_get_power_state(&gs_handle, &power_state, (uint64_t *)residency, (uint32_t *)&transitions);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get power state failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check power state %s.\n", (power_state == NRF24L01_POWER_STATE_RX) ? "ok" : "error");
+    nrf24l01_interface_debug_print("nrf24l01: power down %d us standby-I %d us transitions %d.\n",
+                                   (uint32_t)residency[NRF24L01_POWER_STATE_POWER_DOWN],
+                                   (uint32_t)residency[NRF24L01_POWER_STATE_STANDBY_1], transitions);
+    res = nrf24l01_set_power_tracking(&gs_handle, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set power tracking failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* disable register shadow */
+    res = nrf24l01_set_register_shadow(&gs_handle, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set register shadow failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+
+        return 1;
+    }
+
     /* finish register test */
     nrf24l01_interface_debug_print("nrf24l01: finish register test.\n");
     (void)nrf24l01_deinit(&gs_handle);
@@ -37,6 +37,97 @@
 #include "driver_nrf24l01_send_receive_test.h"
 
 static nrf24l01_handle_t gs_handle;        /**< nrf24l01 handle */
+static volatile uint16_t gs_message_len;   /**< received message length */
+static volatile uint32_t gs_ack_sequence;  /**< last ack payload sequence */
+static volatile uint32_t gs_pipe_count;    /**< pipe handler payload counter */
+static volatile uint32_t gs_tx_ds_count;   /**< tx data sent counter */
+static volatile uint32_t gs_max_rt_count;  /**< max retransmit counter */
+static nrf24l01_scan_t gs_scan;            /**< channel scan */
+static volatile uint8_t gs_irq_defer;      /**< defer the irq service */
+static nrf24l01_stats_t gs_stats;          /**< statistics block */
+static nrf24l01_ack_t gs_ack;              /**< ack payload channel */
+static nrf24l01_dispatch_t gs_dispatch;    /**< dispatch table */
+static nrf24l01_stream_t gs_stream;        /**< tx stream */
+
+/**
+ * @brief     ack payload callback
+ * @param[in] sequence send sequence
+ * @param[in] *buf pointer to an ack payload buffer
+ * @param[in] len ack payload length
+ * @param[in] *param pointer to the callback parameter
+ * @note      none
+ */
+static void a_nrf24l01_ack_callback(uint32_t sequence, uint8_t *buf, uint8_t len, void *param)
+{
+    (void)buf;
+    (void)param;
+    nrf24l01_interface_debug_print("nrf24l01: irq ack payload of send %d with %d bytes.\n", sequence, len);
+    gs_ack_sequence = sequence;
+}
+
+/**
+ * @brief     message receive callback
+ * @param[in] pipe rx pipe
+ * @param[in] *buf pointer to a message buffer
+ * @param[in] len message length
+ * @param[in] *param pointer to the callback parameter
+ * @note      none
+ */
+static void a_nrf24l01_message_callback(uint8_t pipe, uint8_t *buf, uint16_t len, void *param)
+{
+    uint16_t i;
+    
+    (void)param;
+    nrf24l01_interface_debug_print("nrf24l01: irq receive message from pipe %d with %d bytes.\n", pipe, len);
+    for (i = 0; i < len; i++)
+    {
+        if (buf[i] != (uint8_t)i)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: check message error.\n");
+            
+            break;
+        }
+    }
+    gs_message_len = len;
+}
+
+/**
+ * @brief     pipe receive handler
+ * @param[in] pipe rx pipe
+ * @param[in] *buf pointer to a payload buffer
+ * @param[in] len payload length
+ * @param[in] *param pointer to the handler parameter
+ * @note      none
+ */
+static void a_nrf24l01_pipe_handler(uint8_t pipe, uint8_t *buf, uint8_t len, void *param)
+{
+    (void)buf;
+    (void)param;
+    nrf24l01_interface_debug_print("nrf24l01: irq pipe %d handler with %d bytes.\n", pipe, len);
+    gs_pipe_count++;
+}
+
+/**
+ * @brief     tx data sent hook
+ * @param[in] *param pointer to the hook parameter
+ * @note      none
+ */
+static void a_nrf24l01_tx_ds_hook(void *param)
+{
+    (void)param;
+    gs_tx_ds_count++;
+}
+
+/**
+ * @brief     max retransmit hook
+ * @param[in] *param pointer to the hook parameter
+ * @note      none
+ */
+static void a_nrf24l01_max_rt_hook(void *param)
+{
+    (void)param;
+    gs_max_rt_count++;
+}
 
 /**
  * @brief  nrf24l01 interrupt test irq
@@ -47,6 +138,10 @@ static nrf24l01_handle_t gs_handle;        /**< nrf24l01 handle */
  */
 uint8_t nrf24l01_interrupt_test_irq_handler(void)
 {
+    if (gs_irq_defer != 0)
+    {
+        return 0;
+    }
     if (nrf24l01_irq_handler(&gs_handle) != 0)
     {
         return 1;
@@ -77,6 +172,24 @@ uint8_t nrf24l01_send_test(void)
     uint8_t addr4[5] = {0x1B, 0x01, 0x02, 0x03, 0x04};
     uint8_t addr5[5] = {0x1B, 0x01, 0x02, 0x03, 0x05};
     uint8_t data[32];
+    uint32_t timeout;
+    nrf24l01_send_status_t status;
+    nrf24l01_send_status_t result[3];
+    uint8_t stream[3][32];
+    nrf24l01_tx_ring_t tx_ring;
+    nrf24l01_tx_frame_t ring[4];
+    nrf24l01_tx_frame_t ack[4];
+    uint16_t pending;
+    uint32_t sent;
+    uint32_t failed;
+    uint8_t message[256];
+    uint16_t j;
+    nrf24l01_retransmit_tuner_t tuner;
+    uint8_t delay;
+    uint8_t count;
+    nrf24l01_stats_t stats;
+    nrf24l01_bool_t enable;
+    uint32_t sequence;
     
     /* link function */
     DRIVER_NRF24L01_LINK_INIT(&gs_handle, nrf24l01_handle_t);
@@ -84,10 +197,13 @@ uint8_t nrf24l01_send_test(void)
     DRIVER_NRF24L01_LINK_SPI_DEINIT(&gs_handle, nrf24l01_interface_spi_deinit);
     DRIVER_NRF24L01_LINK_SPI_READ(&gs_handle, nrf24l01_interface_spi_read);
     DRIVER_NRF24L01_LINK_SPI_WRITE(&gs_handle, nrf24l01_interface_spi_write);
+    DRIVER_NRF24L01_LINK_SPI_TRANSFER(&gs_handle, nrf24l01_interface_spi_transfer);
     DRIVER_NRF24L01_LINK_GPIO_INIT(&gs_handle, nrf24l01_interface_gpio_init);
     DRIVER_NRF24L01_LINK_GPIO_DEINIT(&gs_handle, nrf24l01_interface_gpio_deinit);
     DRIVER_NRF24L01_LINK_GPIO_WRITE(&gs_handle, nrf24l01_interface_gpio_write);
     DRIVER_NRF24L01_LINK_DELAY_MS(&gs_handle, nrf24l01_interface_delay_ms);
+    DRIVER_NRF24L01_LINK_DELAY_US(&gs_handle, nrf24l01_interface_delay_us);
+    DRIVER_NRF24L01_LINK_TIMESTAMP_US(&gs_handle, nrf24l01_interface_timestamp_us);
     DRIVER_NRF24L01_LINK_DEBUG_PRINT(&gs_handle, nrf24l01_interface_debug_print);
     DRIVER_NRF24L01_LINK_RECEIVE_CALLBACK(&gs_handle, nrf24l01_interface_receive_callback);
     
@@ -125,6 +241,46 @@ uint8_t nrf24l01_send_test(void)
         return 1;
     }
     
+    /* set the statistics */
+    res = nrf24l01_set_stats(&gs_handle, &gs_stats);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set stats failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the ack payload channel */
+    res = nrf24l01_set_ack_channel(&gs_handle, &gs_ack);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set ack channel failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the dispatch table */
+    res = nrf24l01_set_dispatch(&gs_handle, &gs_dispatch);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set dispatch failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the tx stream */
+    res = nrf24l01_set_stream(&gs_handle, &gs_stream);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set stream failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
     /* set active false */
     res = nrf24l01_set_active(&gs_handle, NRF24L01_BOOL_FALSE);
     if (res != 0)
@@ -699,6 +855,9 @@ uint8_t nrf24l01_send_test(void)
     for (i = 0; i < 32; i++)
     {
         data[i] = i;
+        stream[0][i] = i;
+        stream[1][i] = i + 32;
+        stream[2][i] = i + 64;
     }
     
     /* send data */
@@ -926,6 +1085,453 @@ uint8_t nrf24l01_send_test(void)
         return 1;
     }
     
+    /* send data without waiting */
+    res = nrf24l01_send_async(&gs_handle, (uint8_t *)data, 32, NULL, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: send data async failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* poll the send status */
+    timeout = 5000;
+    status = NRF24L01_SEND_STATUS_PENDING;
+    while ((timeout != 0) && (status == NRF24L01_SEND_STATUS_PENDING))
+    {
+        res = nrf24l01_get_send_status(&gs_handle, &status);
+        if (res != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: get send status failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+        nrf24l01_interface_delay_ms(1);
+        timeout--;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check send async %s.\n", (status == NRF24L01_SEND_STATUS_OK) ? "ok" : "error");
+    
+    /* send a stream of payloads */
+    res = nrf24l01_send_stream(&gs_handle, (uint8_t *)stream, 32, 3, result, NULL, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: send stream failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* poll the send status */
+    timeout = 5000;
+    status = NRF24L01_SEND_STATUS_PENDING;
+    while ((timeout != 0) && (status == NRF24L01_SEND_STATUS_PENDING))
+    {
+        res = nrf24l01_get_send_status(&gs_handle, &status);
+        if (res != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: get send status failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+        nrf24l01_interface_delay_ms(1);
+        timeout--;
+    }
+    for (i = 0; i < 3; i++)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: stream payload %d %s.\n", i, (result[i] == NRF24L01_SEND_STATUS_OK) ? "ok" : "error");
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check send stream %s.\n", (status == NRF24L01_SEND_STATUS_OK) ? "ok" : "error");
+    
+    /* send a stream with a late irq service */
+    gs_irq_defer = 1;
+    res = nrf24l01_send_stream(&gs_handle, (uint8_t *)stream, 32, 3, result, NULL, NULL);
+    if (res != 0)
+    {
+        gs_irq_defer = 0;
+        nrf24l01_interface_debug_print("nrf24l01: send stream failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* let both payloads complete before the irq is served */
+    nrf24l01_interface_delay_ms(20);
+    gs_irq_defer = 0;
+    res = nrf24l01_irq_handler(&gs_handle);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: irq handler failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* poll the send status */
+    timeout = 5000;
+    status = NRF24L01_SEND_STATUS_PENDING;
+    while ((timeout != 0) && (status == NRF24L01_SEND_STATUS_PENDING))
+    {
+        res = nrf24l01_get_send_status(&gs_handle, &status);
+        if (res != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: get send status failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+        nrf24l01_interface_delay_ms(1);
+        timeout--;
+    }
+    for (i = 0; i < 3; i++)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: late irq stream payload %d %s.\n", i, (result[i] == NRF24L01_SEND_STATUS_OK) ? "ok" : "error");
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check late irq stream %s.\n", (status == NRF24L01_SEND_STATUS_OK) ? "ok" : "error");
+    
+    /* get the tx sequence */
+    res = nrf24l01_get_tx_sequence(&gs_handle, &sequence);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get tx sequence failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* send a stream with the irq deferred across two completions, twice */
+    gs_irq_defer = 1;
+    res = nrf24l01_send_stream(&gs_handle, (uint8_t *)stream, 32, 3, result, NULL, NULL);
+    if (res != 0)
+    {
+        gs_irq_defer = 0;
+        nrf24l01_interface_debug_print("nrf24l01: send stream failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < 2; i++)
+    {
+        /* let the payloads in flight complete before the irq is served */
+        nrf24l01_interface_delay_ms(20);
+        res = nrf24l01_irq_handler(&gs_handle);
+        if (res != 0)
+        {
+            gs_irq_defer = 0;
+            nrf24l01_interface_debug_print("nrf24l01: irq handler failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    gs_irq_defer = 0;
+    res = nrf24l01_get_send_status(&gs_handle, &status);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get send status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = nrf24l01_get_interrupt(&gs_handle, NRF24L01_INTERRUPT_TX_DS, &enable);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get interrupt failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = nrf24l01_get_tx_sequence(&gs_handle, &sent);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get tx sequence failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: deferred irq stream sequence %d tx ds %s.\n", sent - sequence, (enable == NRF24L01_BOOL_FALSE) ? "clear" : "set");
+    nrf24l01_interface_debug_print("nrf24l01: check deferred irq stream %s.\n",
+                                   ((status == NRF24L01_SEND_STATUS_OK) && ((sent - sequence) == 3) &&
+                                   (enable == NRF24L01_BOOL_FALSE)) ? "ok" : "error");
+    
+    /* set the tx ring */
+    res = nrf24l01_set_tx_ring(&gs_handle, &tx_ring, ring, 4);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set tx ring failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* write the tx ring */
+    for (i = 0; i < 3; i++)
+    {
+        res = nrf24l01_tx_ring_write(&gs_handle, (uint8_t *)stream[i], 32);
+        if (res != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: tx ring write failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    
+    /* wait the tx ring */
+    timeout = 5000;
+    pending = 3;
+    while ((timeout != 0) && (pending != 0))
+    {
+        res = nrf24l01_get_tx_ring_status(&gs_handle, &pending, &sent, &failed);
+        if (res != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: get tx ring status failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+        nrf24l01_interface_delay_ms(1);
+        timeout--;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: tx ring sent %d failed %d.\n", sent, failed);
+    nrf24l01_interface_debug_print("nrf24l01: check tx ring %s.\n", (sent == 3) ? "ok" : "error");
+    
+    /* write the tx ring with a late irq service */
+    gs_irq_defer = 1;
+    for (i = 0; i < 3; i++)
+    {
+        res = nrf24l01_tx_ring_write(&gs_handle, (uint8_t *)stream[i], 32);
+        if (res != 0)
+        {
+            gs_irq_defer = 0;
+            nrf24l01_interface_debug_print("nrf24l01: tx ring write failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    
+    /* serve the first frame, then let the next two complete before the irq is served */
+    for (i = 0; i < 2; i++)
+    {
+        nrf24l01_interface_delay_ms(20);
+        if (i == 1)
+        {
+            gs_irq_defer = 0;
+        }
+        res = nrf24l01_irq_handler(&gs_handle);
+        if (res != 0)
+        {
+            gs_irq_defer = 0;
+            nrf24l01_interface_debug_print("nrf24l01: irq handler failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    
+    /* wait the tx ring */
+    timeout = 5000;
+    pending = 3;
+    while ((timeout != 0) && (pending != 0))
+    {
+        res = nrf24l01_get_tx_ring_status(&gs_handle, &pending, &sent, &failed);
+        if (res != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: get tx ring status failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+        nrf24l01_interface_delay_ms(1);
+        timeout--;
+    }
+    res = nrf24l01_get_interrupt(&gs_handle, NRF24L01_INTERRUPT_TX_DS, &enable);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get interrupt failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: late irq tx ring sent %d failed %d tx ds %s.\n", sent, failed, (enable == NRF24L01_BOOL_FALSE) ? "clear" : "set");
+    nrf24l01_interface_debug_print("nrf24l01: check late irq tx ring %s.\n", ((sent + failed == 6) && (enable == NRF24L01_BOOL_FALSE)) ? "ok" : "error");
+    
+    /* enable payload with ack */
+    res = nrf24l01_set_payload_with_ack(&gs_handle, NRF24L01_BOOL_TRUE);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set payload with ack failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the pipe 0 ack queue without an ack handler */
+    res = nrf24l01_set_ack_queue(&gs_handle, NRF24L01_PIPE_0, ack, 4);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set ack queue failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* send data, the ack payload takes the receive path */
+    res = nrf24l01_send_async(&gs_handle, (uint8_t *)data, 32, NULL, NULL);
+    if (res != 0)
+    {
+        (void)nrf24l01_set_ack_queue(&gs_handle, NRF24L01_PIPE_0, NULL, 0);
+        nrf24l01_interface_debug_print("nrf24l01: send data async failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* poll the send status */
+    timeout = 5000;
+    status = NRF24L01_SEND_STATUS_PENDING;
+    while ((timeout != 0) && (status == NRF24L01_SEND_STATUS_PENDING))
+    {
+        res = nrf24l01_get_send_status(&gs_handle, &status);
+        if (res != 0)
+        {
+            (void)nrf24l01_set_ack_queue(&gs_handle, NRF24L01_PIPE_0, NULL, 0);
+            nrf24l01_interface_debug_print("nrf24l01: get send status failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+        nrf24l01_interface_delay_ms(1);
+        timeout--;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check send without ack handler %s.\n", (status == NRF24L01_SEND_STATUS_OK) ? "ok" : "error");
+    
+    /* clear the pipe 0 ack queue */
+    res = nrf24l01_set_ack_queue(&gs_handle, NRF24L01_PIPE_0, NULL, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set ack queue failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the ack handler */
+    gs_ack_sequence = 0;
+    res = nrf24l01_set_ack_handler(&gs_handle, a_nrf24l01_ack_callback, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set ack handler failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the retransmit tuner */
+    res = nrf24l01_retransmit_tuner_init(&gs_handle, &tuner, 0, 0xF, 1, 0xF);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: retransmit tuner init failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = nrf24l01_set_retransmit_tuner(&gs_handle, &tuner);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set retransmit tuner failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the tx hooks */
+    gs_tx_ds_count = 0;
+    gs_max_rt_count = 0;
+    res = nrf24l01_set_tx_hooks(&gs_handle, a_nrf24l01_tx_ds_hook, a_nrf24l01_max_rt_hook, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set tx hooks failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* send a message */
+    for (j = 0; j < 256; j++)
+    {
+        message[j] = (uint8_t)j;
+    }
+    res = nrf24l01_send_message(&gs_handle, (uint8_t *)message, 256, NULL, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: send message failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* poll the send status */
+    timeout = 5000;
+    status = NRF24L01_SEND_STATUS_PENDING;
+    while ((timeout != 0) && (status == NRF24L01_SEND_STATUS_PENDING))
+    {
+        res = nrf24l01_get_send_status(&gs_handle, &status);
+        if (res != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: get send status failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+        nrf24l01_interface_delay_ms(1);
+        timeout--;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check send message %s.\n", (status == NRF24L01_SEND_STATUS_OK) ? "ok" : "error");
+    nrf24l01_interface_debug_print("nrf24l01: last ack payload sequence %d.\n", gs_ack_sequence);
+    nrf24l01_interface_debug_print("nrf24l01: tx hooks tx ds %d max rt %d.\n", gs_tx_ds_count, gs_max_rt_count);
+    res = nrf24l01_get_retransmit_tuner_status(&gs_handle, &tuner, &delay, &count, &sent, &failed);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get retransmit tuner status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: retransmit tuner delay %d count %d sent %d lost %d.\n", delay, count, sent, failed);
+    
+    /* print the statistics */
+    res = nrf24l01_get_stats(&gs_handle, &stats);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get stats failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: stats sent %d tx ds %d max rt %d spi error %d.\n",
+                                   stats.tx.sent, stats.tx.tx_ds, stats.tx.max_rt, stats.spi_error);
+    for (i = 0; i < 16; i++)
+    {
+        if (stats.tx.retransmit[i] != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: stats %d retransmits %d.\n", i, stats.tx.retransmit[i]);
+        }
+    }
+    
+    /* stop the retransmit tuner */
+    res = nrf24l01_set_retransmit_tuner(&gs_handle, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set retransmit tuner failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
     /* finish send test */
     nrf24l01_interface_debug_print("nrf24l01: finish send test.\n");
     (void)nrf24l01_deinit(&gs_handle);
@@ -951,6 +1557,18 @@ uint8_t nrf24l01_receive_test(void)
     uint8_t addr3[5] = {0x1B, 0x01, 0x02, 0x03, 0x03};
     uint8_t addr4[5] = {0x1B, 0x01, 0x02, 0x03, 0x04};
     uint8_t addr5[5] = {0x1B, 0x01, 0x02, 0x03, 0x05};
+    uint16_t i;
+    uint16_t num;
+    nrf24l01_rx_queue_t rx_queue;
+    nrf24l01_rx_frame_t queue[8];
+    nrf24l01_rx_frame_t frame[8];
+    nrf24l01_reassembly_t reassembly;
+    uint8_t message[256];
+    uint32_t timeout;
+    nrf24l01_tx_frame_t ack[4];
+    uint32_t sent;
+    nrf24l01_stats_t stats;
+    uint8_t quiet[3];
     
     /* link function */
     DRIVER_NRF24L01_LINK_INIT(&gs_handle, nrf24l01_handle_t);
@@ -958,10 +1576,13 @@ uint8_t nrf24l01_receive_test(void)
     DRIVER_NRF24L01_LINK_SPI_DEINIT(&gs_handle, nrf24l01_interface_spi_deinit);
     DRIVER_NRF24L01_LINK_SPI_READ(&gs_handle, nrf24l01_interface_spi_read);
     DRIVER_NRF24L01_LINK_SPI_WRITE(&gs_handle, nrf24l01_interface_spi_write);
+    DRIVER_NRF24L01_LINK_SPI_TRANSFER(&gs_handle, nrf24l01_interface_spi_transfer);
     DRIVER_NRF24L01_LINK_GPIO_INIT(&gs_handle, nrf24l01_interface_gpio_init);
     DRIVER_NRF24L01_LINK_GPIO_DEINIT(&gs_handle, nrf24l01_interface_gpio_deinit);
     DRIVER_NRF24L01_LINK_GPIO_WRITE(&gs_handle, nrf24l01_interface_gpio_write);
     DRIVER_NRF24L01_LINK_DELAY_MS(&gs_handle, nrf24l01_interface_delay_ms);
+    DRIVER_NRF24L01_LINK_DELAY_US(&gs_handle, nrf24l01_interface_delay_us);
+    DRIVER_NRF24L01_LINK_TIMESTAMP_US(&gs_handle, nrf24l01_interface_timestamp_us);
     DRIVER_NRF24L01_LINK_DEBUG_PRINT(&gs_handle, nrf24l01_interface_debug_print);
     DRIVER_NRF24L01_LINK_RECEIVE_CALLBACK(&gs_handle, nrf24l01_interface_receive_callback);
     
@@ -999,6 +1620,36 @@ uint8_t nrf24l01_receive_test(void)
         return 1;
     }
     
+    /* set the statistics */
+    res = nrf24l01_set_stats(&gs_handle, &gs_stats);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set stats failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the ack payload channel */
+    res = nrf24l01_set_ack_channel(&gs_handle, &gs_ack);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set ack channel failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the dispatch table */
+    res = nrf24l01_set_dispatch(&gs_handle, &gs_dispatch);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set dispatch failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
     /* set active false */
     res = nrf24l01_set_active(&gs_handle, NRF24L01_BOOL_FALSE);
     if (res != 0)
@@ -1562,6 +2213,216 @@ uint8_t nrf24l01_receive_test(void)
     /* delay 5s */
     nrf24l01_interface_delay_ms(5000);
     
+    /* set the rx queue */
+    res = nrf24l01_set_rx_queue(&gs_handle, &rx_queue, queue, 8);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set rx queue failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* receive from the rx queue */
+    res = nrf24l01_receive(&gs_handle, frame, 8, &num, 5000);
+    if (res == 5)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: rx queue is empty.\n");
+    }
+    else if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: receive failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    else
+    {
+        for (i = 0; i < num; i++)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: rx queue pipe %d len %d.\n", frame[i].pipe, frame[i].len);
+        }
+    }
+    
+    /* disable the rx queue */
+    res = nrf24l01_set_rx_queue(&gs_handle, NULL, NULL, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set rx queue failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* enable payload with ack */
+    res = nrf24l01_set_payload_with_ack(&gs_handle, NRF24L01_BOOL_TRUE);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set payload with ack failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set the pipe 5 ack queue */
+    res = nrf24l01_set_ack_queue(&gs_handle, NRF24L01_PIPE_5, ack, 4);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set ack queue failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < 3; i++)
+    {
+        memset(message, (uint8_t)i, 32);
+        res = nrf24l01_ack_queue_write(&gs_handle, NRF24L01_PIPE_5, (uint8_t *)message, 32);
+        if (res != 0)
+        {
+            nrf24l01_interface_debug_print("nrf24l01: ack queue write failed.\n");
+            (void)nrf24l01_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    
+    /* set the pipe 5 reassembly */
+    gs_message_len = 0;
+    res = nrf24l01_set_reassembly(&gs_handle, NRF24L01_PIPE_5, &reassembly, (uint8_t *)message, 256,
+                                  a_nrf24l01_message_callback, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set reassembly failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* wait the message */
+    timeout = 5000;
+    while ((timeout != 0) && (gs_message_len == 0))
+    {
+        nrf24l01_interface_delay_ms(1);
+        timeout--;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: check receive message %s.\n", (gs_message_len == 256) ? "ok" : "error");
+    res = nrf24l01_get_ack_queue_status(&gs_handle, NRF24L01_PIPE_5, &num, &sent);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get ack queue status failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: ack payloads sent %d pending %d.\n", sent, num);
+    nrf24l01_interface_debug_print("nrf24l01: check ack queue %s.\n", ((sent == 3) && (num == 0)) ? "ok" : "error");
+    
+    /* disable the ack queue */
+    res = nrf24l01_set_ack_queue(&gs_handle, NRF24L01_PIPE_5, NULL, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set ack queue failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* disable the reassembly */
+    res = nrf24l01_set_reassembly(&gs_handle, NRF24L01_PIPE_5, NULL, NULL, 0, NULL, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set reassembly failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* scan all channels */
+    res = nrf24l01_scan_init(&gs_handle, &gs_scan, 0, 125, 4, 200);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: scan init failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = nrf24l01_scan(&gs_handle, &gs_scan, 0);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: scan failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = nrf24l01_scan_get_quiet(&gs_handle, &gs_scan, (uint8_t *)quiet, 3);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: scan get quiet failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    nrf24l01_interface_debug_print("nrf24l01: quiet channels %d %d %d.\n", quiet[0], quiet[1], quiet[2]);
+    
+    /* set the pipe 5 handler */
+    gs_pipe_count = 0;
+    res = nrf24l01_set_pipe_handler(&gs_handle, NRF24L01_PIPE_5, a_nrf24l01_pipe_handler, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set pipe handler failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* discard the other pipes */
+    res = nrf24l01_set_dispatch_discard(&gs_handle, NRF24L01_BOOL_TRUE);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set dispatch discard failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* delay 5s */
+    nrf24l01_interface_delay_ms(5000);
+    nrf24l01_interface_debug_print("nrf24l01: pipe 5 handler payloads %d.\n", gs_pipe_count);
+    res = nrf24l01_get_stats(&gs_handle, &stats);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: get stats failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < 6; i++)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: stats pipe %d rx %d.\n", i, stats.rx[i]);
+    }
+    nrf24l01_interface_debug_print("nrf24l01: stats rx fifo full %d oversize %d discarded %d.\n",
+                                   stats.rx_fifo_full, stats.oversize, stats.discarded);
+    
+    /* remove the pipe 5 handler */
+    res = nrf24l01_set_pipe_handler(&gs_handle, NRF24L01_PIPE_5, NULL, NULL);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set pipe handler failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* disable discard */
+    res = nrf24l01_set_dispatch_discard(&gs_handle, NRF24L01_BOOL_FALSE);
+    if (res != 0)
+    {
+        nrf24l01_interface_debug_print("nrf24l01: set dispatch discard failed.\n");
+        (void)nrf24l01_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
     /* finish receive test */
     nrf24l01_interface_debug_print("nrf24l01: finish receive test.\n");
     (void)nrf24l01_deinit(&gs_handle);